@@ -0,0 +1,648 @@
+/**
+ * Programa: bench.c
+ *
+ * Benchmark das etapas do sistema, medidas separadamente sobre entradas
+ * sinteticas de tamanho crescente (10^min ate 10^max partidas).
+ *
+ * Etapas medidas:
+ * - bdtimes_carregar_csv
+ * - bdpartidas_carregar_csv
+ * - ingestao_carregar_partidas (carga em pipeline, ja com a agregacao)
+ * - bdpartidas_aplicar_em_bdtimes
+ * - bdtimes_buscar_por_prefixo (um lote de buscas por repeticao)
+ * - bdtimes_buscar_prefixos (os mesmos prefixos, resolvidos num unico lote)
+ * - bdtimes_buscar_aproximado (um lote de buscas com um erro de digitacao)
+ * - bdtimes_buscar_infixo (um lote de buscas por um trecho do meio do nome)
+ * - bdpartidas_aplicar_por_blocos (a mesma agregacao, particionada por
+ *   bloco de times: bdpartidas_agregar_por_blocos)
+ * - bdtimes_estreitar_faixa (os prefixos da busca digitados tecla a tecla)
+ * - bdtimes_buscar_por_id / bdtimes_slots_por_id (IDs um a um x em lote)
+ * - listagens por mandante, visitante e qualquer (escritas em /dev/null)
+ * - classificacao (bdtimes_escrever_classificacao em /dev/null)
+ *
+ * Para cada etapa e tamanho: 'warmup' execucoes descartadas seguidas de
+ * 'reps' execucoes medidas; sao reportados mediana, p99, minimo e media.
+ * No Linux, quando o contador de hardware esta disponivel (perf_event_open;
+ * maquinas virtuais costumam nao expo-lo), tambem a mediana das falhas de
+ * cache por operacao (coluna "falhas/op"; "-" se indisponivel).
+ * O resumo vai para stdout e o resultado completo, em JSON, para o
+ * arquivo indicado em --json (para acompanhar regressoes entre versoes).
+ *
+ * Uso:
+ *   bin/bench [--min <exp>] [--max <exp>] [--times <n>] [--reps <n>]
+ *             [--warmup <n>] [--dir <diretorio>] [--json <arquivo>]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE  // syscall(), para o perf_event_open
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "bd_times.h"
+#include "bd_partidas.h"
+#include "escritor.h"
+#include "ingestao.h"
+#include "utils.h"
+
+#ifdef _WIN32
+#define ARQUIVO_NULO "NUL"
+#else
+#define ARQUIVO_NULO "/dev/null"
+#endif
+
+// Numero de buscas por prefixo em cada repeticao da etapa de busca
+#define BUSCAS_POR_REP 1000
+
+// Numero de IDs convertidos em posicoes em cada repeticao das etapas de IDs
+#define IDS_POR_REP 65536
+
+/**
+ * Configuracao do benchmark (linha de comando).
+ */
+typedef struct {
+    int exp_min;          // Menor tamanho: 10^exp_min partidas
+    int exp_max;          // Maior tamanho: 10^exp_max partidas
+    int n_times;          // Numero de times sinteticos
+    int reps;             // Repeticoes medidas por etapa
+    int warmup;           // Repeticoes de aquecimento (descartadas)
+    const char *dir;      // Diretorio dos arquivos sinteticos
+    const char *json;     // Arquivo de saida JSON (NULL = nao gera)
+} Config;
+
+/**
+ * Estado compartilhado pelas etapas de um mesmo tamanho.
+ */
+typedef struct {
+    char times_csv[512];      // Caminho do CSV de times sintetico
+    char partidas_csv[512];   // Caminho do CSV de partidas sintetico
+    BDTimes base_times;       // Times carregados, com estatisticas zeradas
+    BDPartidas base_partidas; // Partidas carregadas
+    BDTimes times;            // Base de trabalho da repeticao atual
+    BDPartidas partidas;      // Base de trabalho da repeticao atual
+    char prefixos[BUSCAS_POR_REP][8];  // Prefixos usados na etapa de busca
+    char textos[BUSCAS_POR_REP][16];   // Textos (com um erro) da busca aproximada
+    char trechos[BUSCAS_POR_REP][8];   // Trechos do meio do nome da busca por trecho
+    int ids[IDS_POR_REP];              // IDs (dos times das partidas) das etapas de IDs
+    int slots[IDS_POR_REP];            // Saida de bdtimes_slots_por_id
+    const char *prefixo_lista;         // Prefixo usado nas listagens
+    Escritor *nulo;           // Escritor ligado a /dev/null
+    long long volume;         // Acumulador que impede o compilador de descartar trabalho
+} Contexto;
+
+/**
+ * Descricao de uma etapa: 'preparar' e 'limpar' rodam fora da medicao.
+ */
+typedef struct {
+    const char *nome;                 // Nome da etapa (chave no JSON)
+    int ops;                          // Operacoes por execucao (para ns/op)
+    void (*preparar)(Contexto *ctx);  // Antes de cada execucao (pode ser NULL)
+    void (*executar)(Contexto *ctx);  // Trecho medido
+    void (*limpar)(Contexto *ctx);    // Depois de cada execucao (pode ser NULL)
+} Etapa;
+
+// ========== Relogio e estatisticas ==========
+
+/**
+ * @return Instante atual em nanossegundos (relogio monotonico)
+ */
+static long long agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Contador de falhas de cache da thread principal (-1 = indisponivel)
+static int contador_falhas = -1;
+
+/**
+ * Abre o contador de falhas de cache (ultimo nivel) da thread atual.
+ *
+ * @return Descritor do contador, ou -1 se indisponivel (fora do Linux,
+ *         sem suporte da CPU ou da maquina virtual, ou bloqueado por
+ *         kernel.perf_event_paranoid)
+ */
+static int contador_abrir(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @return Valor atual do contador de falhas de cache (0 se indisponivel)
+ */
+static long long contador_ler(void) {
+#ifdef __linux__
+    long long v;
+    if (contador_falhas >= 0 && read(contador_falhas, &v, sizeof(v)) == (ssize_t)sizeof(v)) return v;
+#endif
+    return 0;
+}
+
+/**
+ * Comparador para qsort de amostras.
+ */
+static int cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Resumo estatistico das amostras de uma etapa.
+ */
+typedef struct {
+    long long mediana;   // Mediana (ns)
+    long long p99;       // Percentil 99 por posto mais proximo (ns)
+    long long minimo;    // Menor amostra (ns)
+    long long media;     // Media (ns)
+} Resumo;
+
+/**
+ * Calcula o resumo estatistico (ordena as amostras).
+ *
+ * @param amostras Tempos em ns
+ * @param n Quantidade de amostras (>= 1)
+ * @return Resumo
+ */
+static Resumo resumir(long long *amostras, int n) {
+    Resumo r;
+    qsort(amostras, (size_t)n, sizeof(long long), cmp_ll);
+
+    r.minimo = amostras[0];
+    r.mediana = n % 2 ? amostras[n / 2] : (amostras[n / 2 - 1] + amostras[n / 2]) / 2;
+    int k = (99 * n + 99) / 100;  // ceil(0.99 * n)
+    r.p99 = amostras[k - 1];
+
+    long long soma = 0;
+    for (int i = 0; i < n; i++) soma += amostras[i];
+    r.media = soma / n;
+    return r;
+}
+
+// ========== Geracao das entradas sinteticas ==========
+
+/**
+ * Gerador pseudoaleatorio xorshift64 (deterministico entre execucoes).
+ */
+static unsigned long long proximo_aleatorio(unsigned long long *estado) {
+    unsigned long long x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *estado = x;
+    return x;
+}
+
+/**
+ * Escreve o CSV de times: nomes ASCII e, a cada quatro, com acentos.
+ *
+ * @param caminho Arquivo a criar
+ * @param n_times Numero de times
+ * @return 1 se sucesso
+ */
+static int gerar_times(const char *caminho, int n_times) {
+    Escritor *w = malloc(sizeof(Escritor));
+    if (!w || !escritor_abrir(w, caminho)) {
+        free(w);
+        return 0;
+    }
+    escritor_str(w, "ID,Nome\n");
+    for (int i = 0; i < n_times; i++) {
+        escritor_int(w, i);
+        escritor_str(w, i % 4 == 3 ? ",São Time " : ",Time ");
+        escritor_int(w, i);
+        escritor_char(w, '\n');
+    }
+    int ok = escritor_fechar(w);
+    free(w);
+    return ok;
+}
+
+/**
+ * Escreve o CSV de partidas com confrontos e placares aleatorios.
+ *
+ * @param caminho Arquivo a criar
+ * @param n_partidas Numero de partidas
+ * @param n_times Numero de times (IDs 0..n_times-1)
+ * @return 1 se sucesso
+ */
+static int gerar_partidas(const char *caminho, long long n_partidas, int n_times) {
+    Escritor *w = malloc(sizeof(Escritor));
+    if (!w || !escritor_abrir(w, caminho)) {
+        free(w);
+        return 0;
+    }
+    unsigned long long estado = 0x9E3779B97F4A7C15ULL;
+    escritor_str(w, "ID,Time1ID,Time2ID,Gols1,Gols2\n");
+    for (long long i = 0; i < n_partidas; i++) {
+        int t1 = (int)(proximo_aleatorio(&estado) % (unsigned long long)n_times);
+        int t2 = (int)(proximo_aleatorio(&estado) % (unsigned long long)(n_times - 1));
+        if (t2 >= t1) t2++;  // Mandante e visitante diferentes
+        unsigned long long g = proximo_aleatorio(&estado);
+
+        escritor_int(w, (int)i);
+        escritor_char(w, ',');
+        escritor_int(w, t1);
+        escritor_char(w, ',');
+        escritor_int(w, t2);
+        escritor_char(w, ',');
+        escritor_int(w, (int)(g % 6));
+        escritor_char(w, ',');
+        escritor_int(w, (int)((g >> 8) % 6));
+        escritor_char(w, '\n');
+    }
+    int ok = escritor_fechar(w);
+    free(w);
+    return ok;
+}
+
+// ========== Etapas ==========
+//
+// Cada etapa e um trio preparar/executar/limpar sobre o Contexto; apenas
+// 'executar' e medido. As etapas de consulta usam a base de referencia
+// (base_times/base_partidas), carregada uma unica vez por tamanho.
+
+static void preparar_vazio(Contexto *ctx) {
+    bdtimes_init(&ctx->times);
+    bdpartidas_init(&ctx->partidas);
+}
+
+static void preparar_times_zerados(Contexto *ctx) {
+    bdtimes_copiar(&ctx->times, &ctx->base_times);
+    bdpartidas_init(&ctx->partidas);
+}
+
+static void limpar_trabalho(Contexto *ctx) {
+    bdtimes_liberar(&ctx->times);
+    bdpartidas_liberar(&ctx->partidas);
+}
+
+static void executar_carregar_times(Contexto *ctx) {
+    ctx->volume += bdtimes_carregar_csv(&ctx->times, ctx->times_csv);
+}
+
+static void executar_carregar_partidas(Contexto *ctx) {
+    ctx->volume += bdpartidas_carregar_csv(&ctx->partidas, ctx->partidas_csv);
+}
+
+static void executar_ingestao(Contexto *ctx) {
+    ctx->volume += ingestao_carregar_partidas(&ctx->partidas, &ctx->times, ctx->partidas_csv, NULL);
+}
+
+static void executar_aplicar(Contexto *ctx) {
+    bdpartidas_aplicar_em_bdtimes(&ctx->base_partidas, &ctx->times);
+    ctx->volume += bdtimes_time(&ctx->times, 0)->gm;
+}
+
+static void preparar_por_blocos(Contexto *ctx) {
+    preparar_times_zerados(ctx);
+    bdpartidas_agregar_por_blocos(1);
+}
+
+static void limpar_por_blocos(Contexto *ctx) {
+    bdpartidas_agregar_por_blocos(0);
+    limpar_trabalho(ctx);
+}
+
+static void executar_buscar_prefixo(Contexto *ctx) {
+    int indices[16];
+    for (int i = 0; i < BUSCAS_POR_REP; i++) {
+        ctx->volume += bdtimes_buscar_por_prefixo(&ctx->base_times, ctx->prefixos[i], indices, 16);
+    }
+}
+
+static void executar_buscar_prefixos(Contexto *ctx) {
+    const char *prefixos[BUSCAS_POR_REP];
+    for (int i = 0; i < BUSCAS_POR_REP; i++) prefixos[i] = ctx->prefixos[i];
+    LotePrefixos lote;
+    if (bdtimes_buscar_prefixos(&ctx->base_times, prefixos, BUSCAS_POR_REP, &lote)) {
+        ctx->volume += lote.inicio[BUSCAS_POR_REP];
+        bdtimes_liberar_lote(&lote);
+    }
+}
+
+static void executar_buscar_aproximado(Contexto *ctx) {
+    int indices[16];
+    for (int i = 0; i < BUSCAS_POR_REP; i++) {
+        ctx->volume += bdtimes_buscar_aproximado(&ctx->base_times, ctx->textos[i], indices, 16);
+    }
+}
+
+static void executar_buscar_infixo(Contexto *ctx) {
+    int indices[16];
+    for (int i = 0; i < BUSCAS_POR_REP; i++) {
+        ctx->volume += bdtimes_buscar_infixo(&ctx->base_times, ctx->trechos[i], indices, 16);
+    }
+}
+
+static void executar_estreitar_faixa(Contexto *ctx) {
+    for (int i = 0; i < BUSCAS_POR_REP; i++) {
+        FaixaNomes faixa = { 0, ctx->base_times.nomes.n };
+        for (int pos = 0; ctx->prefixos[i][pos]; pos++) {
+            ctx->volume += bdtimes_estreitar_faixa(&ctx->base_times, &faixa, pos, ctx->prefixos[i][pos]);
+        }
+    }
+}
+
+static void executar_buscar_por_id(Contexto *ctx) {
+    for (int i = 0; i < IDS_POR_REP; i++) {
+        ctx->volume += bdtimes_buscar_por_id(&ctx->base_times, ctx->ids[i]) != NULL;
+    }
+}
+
+static void executar_slots_por_id(Contexto *ctx) {
+    bdtimes_slots_por_id(&ctx->base_times, ctx->ids, IDS_POR_REP, ctx->slots);
+    ctx->volume += ctx->slots[IDS_POR_REP - 1];
+}
+
+/**
+ * Escreve uma listagem em /dev/null, incluindo a descarga do buffer.
+ */
+static void listar(Contexto *ctx, FiltroPartida filtro) {
+    bdpartidas_escrever_listagem(&ctx->base_partidas, &ctx->base_times, ctx->prefixo_lista, filtro, ctx->nulo);
+    escritor_descarregar(ctx->nulo);
+}
+
+static void executar_listar_mandante(Contexto *ctx)  { listar(ctx, FILTRO_MANDANTE); }
+static void executar_listar_visitante(Contexto *ctx) { listar(ctx, FILTRO_VISITANTE); }
+static void executar_listar_qualquer(Contexto *ctx)  { listar(ctx, FILTRO_QUALQUER); }
+
+static void executar_classificacao(Contexto *ctx) {
+    bdtimes_escrever_classificacao(&ctx->base_times, ctx->nulo);
+    escritor_descarregar(ctx->nulo);
+}
+
+/**
+ * Etapas que nao dependem da base carregada (medem a propria carga).
+ */
+static const Etapa ETAPAS_CARGA[] = {
+    { "bdtimes_carregar_csv",       1, preparar_vazio,         executar_carregar_times,    limpar_trabalho },
+    { "bdpartidas_carregar_csv",    1, preparar_vazio,         executar_carregar_partidas, limpar_trabalho },
+    { "ingestao_carregar_partidas", 1, preparar_times_zerados, executar_ingestao,          limpar_trabalho },
+};
+
+/**
+ * Etapas que consultam a base ja carregada.
+ */
+static const Etapa ETAPAS_CONSULTA[] = {
+    { "bdpartidas_aplicar_em_bdtimes", 1,              preparar_times_zerados, executar_aplicar,          limpar_trabalho },
+    { "bdpartidas_aplicar_por_blocos", 1,              preparar_por_blocos,    executar_aplicar,          limpar_por_blocos },
+    { "bdtimes_buscar_por_prefixo",    BUSCAS_POR_REP, NULL,                   executar_buscar_prefixo,   NULL },
+    { "bdtimes_buscar_prefixos",       BUSCAS_POR_REP, NULL,                   executar_buscar_prefixos,  NULL },
+    { "bdtimes_buscar_aproximado",     BUSCAS_POR_REP, NULL,                   executar_buscar_aproximado, NULL },
+    { "bdtimes_buscar_infixo",         BUSCAS_POR_REP, NULL,                   executar_buscar_infixo,    NULL },
+    { "bdtimes_estreitar_faixa",       BUSCAS_POR_REP, NULL,                   executar_estreitar_faixa,  NULL },
+    { "bdtimes_buscar_por_id",         IDS_POR_REP,    NULL,                   executar_buscar_por_id,    NULL },
+    { "bdtimes_slots_por_id",          IDS_POR_REP,    NULL,                   executar_slots_por_id,     NULL },
+    { "listar_por_mandante",           1,              NULL,                   executar_listar_mandante,  NULL },
+    { "listar_por_visitante",          1,              NULL,                   executar_listar_visitante, NULL },
+    { "listar_por_qualquer",           1,              NULL,                   executar_listar_qualquer,  NULL },
+    { "classificacao",                 1,              NULL,                   executar_classificacao,    NULL },
+};
+
+// ========== Execucao e relatorio ==========
+
+/**
+ * Executa uma etapa (aquecimento + repeticoes) e registra o resultado.
+ *
+ * @param e Etapa
+ * @param ctx Contexto do tamanho atual
+ * @param cfg Configuracao
+ * @param n_partidas Tamanho da entrada
+ * @param json Escritor do JSON (NULL se desativado)
+ * @param primeiro Indica se e o primeiro resultado do JSON (atualizado)
+ */
+static void medir(const Etapa *e, Contexto *ctx, const Config *cfg, long long n_partidas,
+                  Escritor *json, int *primeiro) {
+    long long *amostras = malloc((size_t)cfg->reps * sizeof(long long));
+    long long *falhas = malloc((size_t)cfg->reps * sizeof(long long));
+    if (!amostras || !falhas) {
+        free(amostras);
+        free(falhas);
+        return;
+    }
+
+    for (int r = 0; r < cfg->warmup + cfg->reps; r++) {
+        if (e->preparar) e->preparar(ctx);
+        long long f0 = contador_ler();
+        long long t0 = agora_ns();
+        e->executar(ctx);
+        long long t1 = agora_ns();
+        long long f1 = contador_ler();
+        if (e->limpar) e->limpar(ctx);
+        if (r >= cfg->warmup) {
+            amostras[r - cfg->warmup] = t1 - t0;
+            falhas[r - cfg->warmup] = f1 - f0;
+        }
+    }
+
+    Resumo res = resumir(amostras, cfg->reps);
+    Resumo res_falhas = resumir(falhas, cfg->reps);
+    free(amostras);
+    free(falhas);
+
+    char falhas_op[32] = "-";
+    if (contador_falhas >= 0) {
+        snprintf(falhas_op, sizeof(falhas_op), "%.3f", (double)res_falhas.mediana / e->ops);
+    }
+    printf("%-32s %10lld %12.3f %12.3f %12.3f %12s\n", e->nome, n_partidas,
+           res.mediana / 1e6, res.p99 / 1e6, (double)res.mediana / e->ops, falhas_op);
+    fflush(stdout);
+
+    if (json) {
+        char linha[512];
+        snprintf(linha, sizeof(linha),
+                 "%s\n    {\"etapa\": \"%s\", \"partidas\": %lld, \"times\": %d, \"ops\": %d, "
+                 "\"reps\": %d, \"mediana_ns\": %lld, \"p99_ns\": %lld, \"min_ns\": %lld, "
+                 "\"media_ns\": %lld",
+                 *primeiro ? "" : ",", e->nome, n_partidas, cfg->n_times, e->ops,
+                 cfg->reps, res.mediana, res.p99, res.minimo, res.media);
+        escritor_str(json, linha);
+        if (contador_falhas >= 0) {
+            snprintf(linha, sizeof(linha), ", \"falhas_cache\": %lld", res_falhas.mediana);
+            escritor_str(json, linha);
+        }
+        escritor_str(json, "}");
+        *primeiro = 0;
+    }
+}
+
+/**
+ * Gera as entradas de um tamanho e mede todas as etapas.
+ *
+ * @return 1 se sucesso, 0 se falhou ao gerar ou carregar os arquivos
+ */
+static int medir_tamanho(const Config *cfg, long long n_partidas, Contexto *ctx,
+                         Escritor *json, int *primeiro) {
+    if (!gerar_times(ctx->times_csv, cfg->n_times) ||
+        !gerar_partidas(ctx->partidas_csv, n_partidas, cfg->n_times)) {
+        fprintf(stderr, "Falha ao gerar as entradas em %s\n", cfg->dir);
+        return 0;
+    }
+
+    // Base de referencia (carregada uma unica vez): os times sao usados
+    // pela ingestao; as partidas so depois das etapas de carga, para que
+    // duas copias grandes nao fiquem em memoria ao mesmo tempo
+    bdtimes_init(&ctx->base_times);
+    bdpartidas_init(&ctx->base_partidas);
+    if (!bdtimes_carregar_csv(&ctx->base_times, ctx->times_csv)) {
+        fprintf(stderr, "Falha ao carregar as entradas sinteticas\n");
+        return 0;
+    }
+
+    for (size_t i = 0; i < sizeof(ETAPAS_CARGA) / sizeof(ETAPAS_CARGA[0]); i++) {
+        medir(&ETAPAS_CARGA[i], ctx, cfg, n_partidas, json, primeiro);
+    }
+
+    if (bdpartidas_carregar_csv(&ctx->base_partidas, ctx->partidas_csv) != n_partidas) {
+        fprintf(stderr, "Falha ao carregar as entradas sinteticas\n");
+        bdtimes_liberar(&ctx->base_times);
+        bdpartidas_liberar(&ctx->base_partidas);
+        return 0;
+    }
+
+    // Prefixos da busca: inicio do nome de times espalhados pela base
+    for (int i = 0; i < BUSCAS_POR_REP; i++) {
+        const char *nome = bdtimes_time(&ctx->base_times, (i * 7919) % ctx->base_times.n)->nome;
+        snprintf(ctx->prefixos[i], sizeof(ctx->prefixos[i]), "%.6s", nome);
+
+        // Busca aproximada: ate 10 bytes do nome, com o 3o trocado por 'q'
+        // quando e ASCII (erro de digitacao)
+        snprintf(ctx->textos[i], sizeof(ctx->textos[i]), "%.10s", nome);
+        if (strlen(ctx->textos[i]) > 2 && (unsigned char)ctx->textos[i][2] < 0x80) ctx->textos[i][2] = 'q';
+
+        // Busca por trecho: 5 bytes a partir do 3o do nome (sem cortar um
+        // caractere multibyte no inicio)
+        const char *meio = nome + (strlen(nome) > 2 ? 2 : 0);
+        while (((unsigned char)*meio & 0xC0) == 0x80) meio++;
+        snprintf(ctx->trechos[i], sizeof(ctx->trechos[i]), "%.5s", meio);
+    }
+    // Etapas de IDs: os times das partidas, na ordem em que aparecem
+    for (int i = 0; i < IDS_POR_REP; i++) {
+        const Partida *p = bdpartidas_partida(&ctx->base_partidas, (i / 2) % ctx->base_partidas.n);
+        ctx->ids[i] = i % 2 == 0 ? p->time1 : p->time2;
+    }
+    // Listagens: um unico time (nome completo do time 0)
+    ctx->prefixo_lista = bdtimes_time(&ctx->base_times, 0)->nome;
+
+    for (size_t i = 0; i < sizeof(ETAPAS_CONSULTA) / sizeof(ETAPAS_CONSULTA[0]); i++) {
+        medir(&ETAPAS_CONSULTA[i], ctx, cfg, n_partidas, json, primeiro);
+    }
+
+    bdtimes_liberar(&ctx->base_times);
+    bdpartidas_liberar(&ctx->base_partidas);
+    remove(ctx->partidas_csv);
+    remove(ctx->times_csv);
+    return 1;
+}
+
+/**
+ * Le um inteiro de opcao da linha de comando.
+ */
+static int ler_opcao_int(int argc, char *argv[], int *i, int minimo, int *out) {
+    if (*i + 1 >= argc || !safe_atoi(argv[*i + 1], out) || *out < minimo) {
+        fprintf(stderr, "Valor invalido para %s\n", argv[*i]);
+        return 0;
+    }
+    (*i)++;
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    Config cfg = { 3, 7, 64, 5, 1, ".", NULL };
+
+    for (int i = 1; i < argc; i++) {
+        int ok = 1;
+        if (strcmp(argv[i], "--min") == 0)         ok = ler_opcao_int(argc, argv, &i, 0, &cfg.exp_min);
+        else if (strcmp(argv[i], "--max") == 0)    ok = ler_opcao_int(argc, argv, &i, 0, &cfg.exp_max);
+        else if (strcmp(argv[i], "--times") == 0)  ok = ler_opcao_int(argc, argv, &i, 2, &cfg.n_times);
+        else if (strcmp(argv[i], "--reps") == 0)   ok = ler_opcao_int(argc, argv, &i, 1, &cfg.reps);
+        else if (strcmp(argv[i], "--warmup") == 0) ok = ler_opcao_int(argc, argv, &i, 0, &cfg.warmup);
+        else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc)  cfg.dir = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) cfg.json = argv[++i];
+        else ok = 0;
+
+        if (!ok) {
+            fprintf(stderr, "Uso: %s [--min <exp>] [--max <exp>] [--times <n>] [--reps <n>] "
+                            "[--warmup <n>] [--dir <diretorio>] [--json <arquivo>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.exp_max > 9) cfg.exp_max = 9;  // IDs de partida sao int
+
+    Contexto *ctx = malloc(sizeof(Contexto));
+    Escritor *nulo = malloc(sizeof(Escritor));
+    Escritor *json = cfg.json ? malloc(sizeof(Escritor)) : NULL;
+    if (!ctx || !nulo || (cfg.json && !json)) {
+        fprintf(stderr, "Memoria insuficiente\n");
+        return 1;
+    }
+    if (!escritor_abrir(nulo, ARQUIVO_NULO)) {
+        fprintf(stderr, "Erro ao abrir %s\n", ARQUIVO_NULO);
+        return 1;
+    }
+    if (json && !escritor_abrir(json, cfg.json)) {
+        fprintf(stderr, "Erro ao criar %s\n", cfg.json);
+        return 1;
+    }
+    ctx->nulo = nulo;
+    ctx->volume = 0;
+    snprintf(ctx->times_csv, sizeof(ctx->times_csv), "%s/bench_times.csv", cfg.dir);
+    snprintf(ctx->partidas_csv, sizeof(ctx->partidas_csv), "%s/bench_partidas.csv", cfg.dir);
+
+    if (json) {
+        char cab[256];
+        snprintf(cab, sizeof(cab),
+                 "{\n  \"config\": {\"times\": %d, \"reps\": %d, \"warmup\": %d, "
+                 "\"min_exp\": %d, \"max_exp\": %d},\n  \"resultados\": [",
+                 cfg.n_times, cfg.reps, cfg.warmup, cfg.exp_min, cfg.exp_max);
+        escritor_str(json, cab);
+    }
+
+    contador_falhas = contador_abrir();
+    printf("%-32s %10s %12s %12s %12s %12s\n", "etapa", "partidas", "mediana_ms", "p99_ms", "ns/op",
+           "falhas/op");
+
+    int primeiro = 1;
+    int ret = 0;
+    long long n = 1;
+    for (int e = 0; e < cfg.exp_min; e++) n *= 10;
+    for (int e = cfg.exp_min; e <= cfg.exp_max; e++, n *= 10) {
+        if (!medir_tamanho(&cfg, n, ctx, json, &primeiro)) {
+            ret = 1;
+            break;
+        }
+    }
+
+    if (json) {
+        escritor_str(json, "\n  ]\n}\n");
+        if (!escritor_fechar(json)) ret = 1;
+        free(json);
+    }
+    escritor_fechar(nulo);
+    free(nulo);
+#ifdef __linux__
+    if (contador_falhas >= 0) close(contador_falhas);
+#endif
+
+    // Usa o acumulador para que o trabalho medido nao seja eliminado
+    if (ctx->volume == -1) printf("\n");
+    free(ctx);
+    return ret;
+}
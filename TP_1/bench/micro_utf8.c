@@ -0,0 +1,278 @@
+/**
+ * Programa: micro_utf8.c
+ *
+ * Microbenchmark da contagem de code points (utf8_len), comparando as
+ * implementacoes escalar, SSE2 e AVX2 (as que o processador suportar).
+ *
+ * Entradas (cada uma com NUM_TEXTOS textos gerados deterministicamente):
+ * - ascii-nomes:   nomes ASCII de 4 a 20 bytes (como os times de data/)
+ * - acentos-nomes: nomes de 4 a 20 caracteres com ~50% de letras acentuadas
+ * - ascii-longo:   textos ASCII de 256 bytes
+ * - acentos-longo: textos de ~256 bytes com ~50% de letras acentuadas
+ * - cjk-longo:     textos de ~256 bytes de ideogramas (3 bytes cada)
+ *
+ * Antes de medir, confere que todas as implementacoes devolvem a mesma
+ * contagem (inclusive com bytes invalidos) e que utf8_largura da a largura
+ * esperada a alguns code points de referencia; termina com erro se nao.
+ * Para cada entrada e implementacao: 'warmup' passadas descartadas e
+ * 'reps' medidas; reporta a mediana em ns por texto e a vazao em GB/s.
+ *
+ * Uso:
+ *   bin/micro_utf8 [--reps <n>] [--warmup <n>]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "utils.h"
+
+// Textos por entrada (uma passada mede todos)
+#define NUM_TEXTOS 4096
+// Maior texto gerado, em bytes (com folga para o ultimo caractere)
+#define MAX_TEXTO 272
+
+/**
+ * Uma entrada do benchmark: textos concatenados, cada um terminado em '\0'.
+ */
+typedef struct {
+    const char *nome;          // Nome da entrada
+    char *dados;               // Textos concatenados
+    size_t offs[NUM_TEXTOS];   // Inicio de cada texto em 'dados'
+    size_t bytes;              // Soma dos tamanhos (sem os '\0')
+} Entrada;
+
+/**
+ * @return Instante atual em nanossegundos (relogio monotonico)
+ */
+static long long agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Comparador para qsort de amostras.
+ */
+static int cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Gerador pseudoaleatorio xorshift64 (deterministico entre execucoes).
+ */
+static unsigned long long proximo_aleatorio(unsigned long long *estado) {
+    unsigned long long x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *estado = x;
+    return x;
+}
+
+/**
+ * Gera um texto com 'alvo' bytes (aproximadamente, sem quebrar caracteres).
+ *
+ * @param dst Destino (MAX_TEXTO bytes)
+ * @param alvo Tamanho desejado em bytes
+ * @param pct_multi Porcentagem de caracteres multi-byte
+ * @param bytes_multi Tamanho dos caracteres multi-byte (2 = acentos, 3 = CJK)
+ * @param estado Estado do gerador
+ * @return Bytes escritos
+ */
+static size_t gerar_texto(char *dst, size_t alvo, int pct_multi, int bytes_multi,
+                          unsigned long long *estado) {
+    static const char *const ACENTOS[] = { "á", "ã", "ç", "é", "ê", "í", "ó", "õ", "ú", "ü" };
+    static const char *const CJK[] = { "北", "京", "上", "海", "東", "大", "阪", "日" };
+    size_t n = 0;
+    while (n < alvo) {
+        unsigned long long r = proximo_aleatorio(estado);
+        if ((int)(r % 100) < pct_multi) {
+            const char *c = bytes_multi == 3 ? CJK[(r >> 8) % 8] : ACENTOS[(r >> 8) % 10];
+            memcpy(dst + n, c, strlen(c));
+            n += strlen(c);
+        } else {
+            char base = n == 0 ? 'A' : 'a';
+            dst[n++] = (char)(base + (int)((r >> 8) % 26));
+        }
+    }
+    dst[n] = '\0';
+    return n;
+}
+
+/**
+ * Monta uma entrada do benchmark.
+ *
+ * @param e Entrada a preencher
+ * @param nome Nome da entrada
+ * @param min Menor tamanho (bytes)
+ * @param max Maior tamanho (bytes)
+ * @param pct_multi Porcentagem de caracteres multi-byte
+ * @param bytes_multi Tamanho dos caracteres multi-byte
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+static int montar(Entrada *e, const char *nome, int min, int max, int pct_multi, int bytes_multi) {
+    unsigned long long estado = 0x9E3779B97F4A7C15ULL ^ (unsigned long long)(min * 131 + max);
+    e->nome = nome;
+    e->dados = malloc((size_t)NUM_TEXTOS * MAX_TEXTO);
+    if (!e->dados) return 0;
+
+    size_t pos = 0;
+    e->bytes = 0;
+    for (int i = 0; i < NUM_TEXTOS; i++) {
+        size_t alvo = (size_t)(min + (int)(proximo_aleatorio(&estado) % (unsigned)(max - min + 1)));
+        e->offs[i] = pos;
+        size_t n = gerar_texto(e->dados + pos, alvo, pct_multi, bytes_multi, &estado);
+        e->bytes += n;
+        pos += n + 1;
+    }
+    return 1;
+}
+
+/**
+ * Confere que todas as implementacoes suportadas concordam com a escalar.
+ *
+ * Usa os textos da entrada e, alem deles, blocos de bytes aleatorios
+ * (incluindo sequencias invalidas) de 0 a 200 bytes.
+ *
+ * @param e Entrada
+ * @return 1 se todas concordam, 0 caso contrario
+ */
+static int conferir(const Entrada *e) {
+    static char lixo[256];
+    unsigned long long estado = 12345;
+    for (int i = 0; i < NUM_TEXTOS; i++) {
+        const char *s = e->dados + e->offs[i];
+        size_t n = strlen(s);
+
+        // Bytes aleatorios de 1 a 255 (o '\0' encerraria o texto)
+        size_t nl = (size_t)(i % 201);
+        for (size_t k = 0; k < nl; k++) lixo[k] = (char)(1 + proximo_aleatorio(&estado) % 255);
+        lixo[nl] = '\0';
+
+        utf8_usar_impl(UTF8_ESCALAR);
+        size_t ref = utf8_contar(s, n);
+        int ref_lixo = utf8_len(lixo);
+        for (int impl = UTF8_SSE2; impl <= UTF8_AVX2; impl++) {
+            if (!utf8_usar_impl((ImplUtf8)impl)) continue;
+            if (utf8_contar(s, n) != ref || utf8_len(lixo) != ref_lixo) {
+                fprintf(stderr, "Divergencia em %s (texto %d) na implementacao %s\n",
+                        e->nome, i, utf8_nome_impl((ImplUtf8)impl));
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/**
+ * Confere utf8_largura em code points de referencia da tabela de larguras.
+ *
+ * Inclui code points nao atribuidos fora dos blocos CJK, que devem ficar
+ * com a largura padrao (1), e nao com a dos ideogramas.
+ *
+ * @return 1 se todas as larguras conferem, 0 caso contrario
+ */
+static int conferir_larguras(void) {
+    static const struct { const char *nome; const char *texto; int largura; } casos[] = {
+        { "U+0301 (acento combinante)",  "\xCC\x81",         0 },
+        { "U+0378 (nao atribuido)",      "\xCD\xB8",         1 },
+        { "U+0984 (nao atribuido)",      "\xE0\xA6\x84",     1 },
+        { "U+1F46 (nao atribuido)",      "\xE1\xBD\x86",     1 },
+        { "U+00E9 (e acentuado)",        "\xC3\xA9",         1 },
+        { "U+4E00 (ideograma CJK)",      "\xE4\xB8\x80",     2 },
+        { "U+1F600 (emoji)",             "\xF0\x9F\x98\x80", 2 },
+    };
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        int l = utf8_largura(casos[i].texto);
+        if (l != casos[i].largura) {
+            fprintf(stderr, "Largura de %s: %d (esperado %d)\n", casos[i].nome, l, casos[i].largura);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Mede uma implementacao sobre uma entrada.
+ *
+ * @param e Entrada
+ * @param reps Passadas medidas
+ * @param warmup Passadas descartadas
+ * @param volume Acumulador (impede o compilador de descartar o trabalho)
+ * @return Mediana do tempo de uma passada (ns)
+ */
+static long long medir(const Entrada *e, int reps, int warmup, long long *volume) {
+    long long *amostras = malloc((size_t)reps * sizeof(long long));
+    if (!amostras) return -1;
+
+    for (int r = -warmup; r < reps; r++) {
+        long long t0 = agora_ns();
+        long long soma = 0;
+        for (int i = 0; i < NUM_TEXTOS; i++) soma += utf8_len(e->dados + e->offs[i]);
+        long long dt = agora_ns() - t0;
+        *volume += soma;
+        if (r >= 0) amostras[r] = dt;
+    }
+
+    qsort(amostras, (size_t)reps, sizeof(long long), cmp_ll);
+    long long mediana = reps % 2 ? amostras[reps / 2]
+                                 : (amostras[reps / 2 - 1] + amostras[reps / 2]) / 2;
+    free(amostras);
+    return mediana;
+}
+
+int main(int argc, char *argv[]) {
+    int reps = 31, warmup = 5;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc && safe_atoi(argv[i + 1], &reps) && reps > 0) {
+            i++;
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc &&
+                   safe_atoi(argv[i + 1], &warmup) && warmup >= 0) {
+            i++;
+        } else {
+            fprintf(stderr, "Uso: %s [--reps <n>] [--warmup <n>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static Entrada entradas[5];
+    int ok = montar(&entradas[0], "ascii-nomes", 4, 20, 0, 2) &&
+             montar(&entradas[1], "acentos-nomes", 4, 20, 50, 2) &&
+             montar(&entradas[2], "ascii-longo", 256, 256, 0, 2) &&
+             montar(&entradas[3], "acentos-longo", 256, 256, 50, 2) &&
+             montar(&entradas[4], "cjk-longo", 256, 256, 100, 3);
+    if (!ok) {
+        fprintf(stderr, "Memoria insuficiente.\n");
+        return 1;
+    }
+
+    ImplUtf8 padrao = utf8_impl_atual();
+    for (int k = 0; k < 5; k++) {
+        if (!conferir(&entradas[k])) return 1;
+    }
+    if (!conferir_larguras()) return 1;
+    printf("Implementacao escolhida em tempo de execucao: %s\n", utf8_nome_impl(padrao));
+    printf("%-16s %-8s %10s %12s %10s\n", "entrada", "impl", "bytes/txt", "ns/texto", "GB/s");
+
+    long long volume = 0;
+    for (int k = 0; k < 5; k++) {
+        const Entrada *e = &entradas[k];
+        for (int impl = UTF8_ESCALAR; impl <= UTF8_AVX2; impl++) {
+            if (!utf8_usar_impl((ImplUtf8)impl)) continue;
+            long long ns = medir(e, reps, warmup, &volume);
+            if (ns <= 0) ns = 1;
+            printf("%-16s %-8s %10.1f %12.2f %10.2f\n", e->nome, utf8_nome_impl((ImplUtf8)impl),
+                   (double)e->bytes / NUM_TEXTOS, (double)ns / NUM_TEXTOS, (double)e->bytes / (double)ns);
+        }
+    }
+
+    for (int k = 0; k < 5; k++) free(entradas[k].dados);
+    // Usa o acumulador para que o trabalho medido nao seja eliminado
+    if (volume == -1) printf("\n");
+    return 0;
+}
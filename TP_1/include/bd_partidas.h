@@ -24,8 +24,14 @@
 #include <stddef.h>
 #include "bd_times.h"
 
-// Constantes de configuracao do sistema
-#define MAX_PARTIDAS 500  // Limite maximo de partidas que podem ser armazenadas simultaneamente
+/**
+ * Lado da partida em que o prefixo do time e testado nas listagens.
+ */
+typedef enum {
+    FILTRO_MANDANTE,   // Apenas o time mandante (time1)
+    FILTRO_VISITANTE,  // Apenas o time visitante (time2)
+    FILTRO_QUALQUER    // Mandante ou visitante
+} FiltroPartida;
 
 /**
  * Estrutura que representa uma partida de futebol.
@@ -49,19 +55,72 @@ typedef struct {
     int g2;     // Numero de gols marcados pelo time visitante
 } Partida;
 
+// Partidas por pedaco da base (potencia de 2; 16384 * 20 bytes = 320 KB)
+#define BITS_PEDACO_PARTIDAS 14
+#define PARTIDAS_POR_PEDACO (1 << BITS_PEDACO_PARTIDAS)
+
+/**
+ * Pedaco de PARTIDAS_POR_PEDACO partidas, compartilhado pelas bases que o
+ * referenciam (bdpartidas_compartilhar()) e liberado pela ultima delas.
+ * 
+ * 'mandante' e 'ant_visitante' sao preenchidos ao aplicar as partidas:
+ * a partir de Time.ult_visitante, 'ant_visitante' encadeia as partidas de
+ * cada visitante, que bdpartidas_contar_por_prefixo() percorre sem
+ * examinar as demais partidas.
+ */
+typedef struct {
+    int refs;                                  // Bases que usam o pedaco
+    Partida partidas[PARTIDAS_POR_PEDACO];     // Partidas do pedaco
+    int mandante[PARTIDAS_POR_PEDACO];         // Posicao do mandante na base de times (-1 = inexistente)
+    int ant_visitante[PARTIDAS_POR_PEDACO];    // Partida anterior do mesmo visitante (-1 = nenhuma)
+} PedacoPartidas;
+
 /**
  * Estrutura que representa o banco de dados de partidas em memoria.
  * 
- * Mantem um array de tamanho fixo com todas as partidas carregadas.
- * O campo 'n' indica quantos elementos do array sao validos.
+ * As partidas ficam em pedacos de PARTIDAS_POR_PEDACO (a partida i e
+ * bdpartidas_partida(bd, i)), alocados conforme necessario (sem limite
+ * fixo de partidas). O campo 'n' indica quantas partidas sao validas.
+ * 
+ * A base so cresce no final: bases que compartilham os pedacos
+ * (bdpartidas_compartilhar()) enxergam cada uma as suas 'n' primeiras
+ * partidas, que nunca mudam.
  * 
- * Capacidade maxima: MAX_PARTIDAS (500 partidas)
+ * A memoria e liberada por bdpartidas_liberar().
  */
 typedef struct {
-    Partida partidas[MAX_PARTIDAS];  // Array de tamanho fixo contendo as partidas carregadas
-    int n;                           // Numero de partidas validas atualmente no array (0 a MAX_PARTIDAS)
+    PedacoPartidas **pedacos;        // Pedacos com as partidas carregadas
+    int n;                           // Numero de partidas validas
+    int cap_pedacos;                 // Capacidade alocada de 'pedacos'
 } BDPartidas;
 
+/**
+ * Acessa a partida de uma posicao da base (0 <= i < bd->n).
+ * 
+ * @param bd Ponteiro para a estrutura BDPartidas
+ * @param i Posicao da partida
+ * @return Ponteiro para a partida
+ */
+static inline Partida* bdpartidas_partida(const BDPartidas *bd, int i) {
+    return &bd->pedacos[i >> BITS_PEDACO_PARTIDAS]->partidas[i & (PARTIDAS_POR_PEDACO - 1)];
+}
+
+/**
+ * Cursor de uma busca paginada de partidas por prefixo do nome do time.
+ * 
+ * Aberto uma vez por consulta (bdpartidas_abrir_cursor()): guarda as
+ * marcas dos times que casam com o prefixo e a posicao da proxima partida
+ * a examinar, de modo que cada pagina custa apenas as partidas
+ * examinadas. Vale enquanto as bases usadas na abertura nao mudarem.
+ */
+typedef struct {
+    const BDPartidas *bdp;           // Base de partidas percorrida
+    const BDTimes *bdt;              // Base de times (nomes)
+    unsigned char *casa;             // Marcas dos times que casam com o prefixo
+    FiltroPartida filtro;            // Lado da partida em que o prefixo e testado
+    int pos;                         // Posicao da proxima partida a examinar
+} CursorPartidas;
+
 // ========== Funcoes de gerenciamento da base de dados ==========
 
 /**
@@ -74,6 +133,57 @@ typedef struct {
  */
 void bdpartidas_init(BDPartidas *bd);
 
+/**
+ * Libera a memoria de uma base de partidas.
+ * 
+ * A base fica vazia e pode ser reutilizada sem nova inicializacao.
+ * 
+ * @param bd Ponteiro para a estrutura BDPartidas
+ */
+void bdpartidas_liberar(BDPartidas *bd);
+
+/**
+ * Acrescenta uma partida ao final da base, alocando um pedaco se preciso.
+ * 
+ * Nao aplica o resultado nos times (ver bdpartidas_aplicar_partida()).
+ * Entre bases que compartilham os pedacos, so a que tem mais partidas
+ * (a mais nova, em bd_versoes.c) pode acrescentar: a posicao escrita
+ * fica depois das que as outras enxergam.
+ * 
+ * @param bd Ponteiro para a estrutura BDPartidas
+ * @param p Partida a acrescentar (copiada)
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_adicionar(BDPartidas *bd, const Partida *p);
+
+/**
+ * Copia uma base de partidas.
+ * 
+ * 'dst' nao precisa estar inicializada; a copia tem seus proprios
+ * pedacos e deve ser liberada com bdpartidas_liberar().
+ * 
+ * @param dst Base de destino
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_copiar(BDPartidas *dst, const BDPartidas *src);
+
+/**
+ * Cria uma base que compartilha os pedacos de outra.
+ * 
+ * Custa O(n / PARTIDAS_POR_PEDACO): nenhuma partida e copiada. 'dst'
+ * comeca com as mesmas partidas e pode acrescentar outras (ver
+ * bdpartidas_adicionar()); 'src' continua enxergando so as suas.
+ * Cada base e liberada com bdpartidas_liberar().
+ * 
+ * 'dst' nao precisa estar inicializada.
+ * 
+ * @param dst Base de destino
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_compartilhar(BDPartidas *dst, const BDPartidas *src);
+
 /**
  * Carrega partidas de um arquivo CSV.
  * 
@@ -93,6 +203,18 @@ void bdpartidas_init(BDPartidas *bd);
  */
 int bdpartidas_carregar_csv(BDPartidas *bd, const char *caminho);
 
+/**
+ * Interpreta uma linha CSV de partida ("ID,Time1ID,Time2ID,Gols1,Gols2").
+ * 
+ * Reentrante: nao modifica a linha e nao usa estado global.
+ * 
+ * @param linha Linha a interpretar (nao precisa terminar em '\0')
+ * @param len Numero de bytes da linha
+ * @param out Partida resultante (apenas se sucesso)
+ * @return 1 se a linha e valida, 0 caso contrario
+ */
+int bdpartidas_parse_linha(const char *linha, size_t len, Partida *out);
+
 // ========== Funcoes de processamento ==========
 
 /**
@@ -109,12 +231,186 @@ int bdpartidas_carregar_csv(BDPartidas *bd, const char *caminho);
  * um aviso e emitido e a partida e ignorada.
  * 
  * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
+ *            (recebe as listas de partidas dos visitantes)
  * @param bdt Ponteiro para a estrutura BDTimes cujas estatisticas serao atualizadas
  */
-void bdpartidas_aplicar_em_bdtimes(const BDPartidas *bdp, BDTimes *bdt);
+void bdpartidas_aplicar_em_bdtimes(BDPartidas *bdp, BDTimes *bdt);
+
+/**
+ * Aplica o resultado de uma unica partida da base nas estatisticas dos times.
+ * 
+ * Permite ingestao incremental: partidas novas sao aplicadas sem
+ * reprocessar as ja existentes. Tambem atualiza os contadores de partidas
+ * (jm, jv, jogos) dos times existentes, mesmo que o adversario nao exista,
+ * e acrescenta a partida a lista de partidas do visitante.
+ * 
+ * @param bdp Base de partidas
+ * @param i Posicao da partida na base (cada partida e aplicada uma vez)
+ * @param bdt Base de times cujas estatisticas serao atualizadas
+ * @return 1 se aplicada, 0 se algum dos times nao existe (aviso em stderr)
+ */
+int bdpartidas_aplicar_partida(BDPartidas *bdp, int i, BDTimes *bdt);
+
+// Partidas particionadas de cada vez pela agregacao por blocos: quem
+// agrega em lotes menores (ingestao) deve junta-los ate esse tamanho
+#define PARTIDAS_POR_AGREGACAO 65536
+
+/**
+ * Aplica os resultados de um intervalo de partidas nas estatisticas dos times.
+ * 
+ * Mesmo efeito de bdpartidas_aplicar_partida() em cada partida, na ordem,
+ * mas os times sao localizados em blocos (bdtimes_slots_por_id), com as
+ * faltas de cache da tabela de IDs sobrepostas. Usada pela carga inicial
+ * e pela ingestao de lotes. Nao registra metricas.
+ * 
+ * @param bdp Base de partidas
+ * @param de Primeira partida (posicao na base)
+ * @param ate Posicao apos a ultima partida
+ * @param bdt Base de times cujas estatisticas serao atualizadas
+ * @return Numero de partidas aplicadas (com os dois times existentes)
+ */
+int bdpartidas_aplicar_intervalo(BDPartidas *bdp, int de, int ate, BDTimes *bdt);
+
+/**
+ * Liga ou desliga a agregacao por blocos de times (desligada por padrao).
+ * 
+ * Ligada, bdpartidas_aplicar_intervalo() particiona as atualizacoes de
+ * cada trecho de partidas pelo bloco do time (radix de um digito) e as
+ * aplica bloco a bloco, em vez de espalha-las pela base de times na ordem
+ * das partidas. Compensa quando a base de times e bem maior que a cache
+ * (ex: 10^5 times) e as partidas vem em ordem aleatoria. O resultado, os
+ * avisos e a ordem em que as partidas ficam armazenadas nao mudam.
+ * 
+ * Deve ser chamada antes de qualquer carga (nao e sincronizada).
+ * 
+ * @param ativo 1 para ligar, 0 para desligar
+ */
+void bdpartidas_agregar_por_blocos(int ativo);
+
+/**
+ * @return 1 se a agregacao por blocos esta ligada
+ */
+int bdpartidas_agregando_por_blocos(void);
 
 // ========== Funcoes de listagem e consulta ==========
 
+/**
+ * Busca as partidas em que um time com o prefixo dado participa.
+ * 
+ * Nao escreve nada: apenas preenche 'indices' com as posicoes das
+ * partidas encontradas na base, em ordem crescente. Com
+ * max_indices = 0, apenas conta as partidas.
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
+ * @param bdt Ponteiro para a estrutura BDTimes (nomes dos times)
+ * @param prefixo Prefixo do nome do time (case-insensitive)
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @param indices Array onde os indices encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de partidas encontradas (pode exceder max_indices)
+ */
+int bdpartidas_buscar_por_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo,
+                                  FiltroPartida filtro, int *indices, int max_indices);
+
+/**
+ * Conta as partidas em que um time com o prefixo dado participa.
+ * 
+ * Caminho rapido para quem so precisa do numero: acha os times pelo
+ * indice de nomes e soma os seus contadores (Time.jm, Time.jv,
+ * Time.jogos), sem percorrer o array de partidas. Para FILTRO_QUALQUER
+ * com mais de um time casando o prefixo, percorre apenas as partidas em
+ * que esses times foram visitantes, para descontar as partidas entre
+ * dois deles (que nao podem ser contadas duas vezes).
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
+ * @param bdt Ponteiro para a estrutura BDTimes (nomes e contadores)
+ * @param prefixo Prefixo do nome do time (case-insensitive)
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return Numero de partidas que a listagem correspondente exibiria
+ */
+int bdpartidas_contar_por_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo,
+                                  FiltroPartida filtro);
+
+/**
+ * Abre uma busca paginada das partidas em que um time com o prefixo dado
+ * participa.
+ * 
+ * Os times sao marcados uma unica vez, aqui; cada pagina e obtida com
+ * bdpartidas_proxima_pagina(). O cursor deve ser fechado com
+ * bdpartidas_fechar_cursor(), mesmo que a abertura falhe.
+ * 
+ * Exemplo:
+ *   CursorPartidas cur;
+ *   int pagina[100], n;
+ *   if (bdpartidas_abrir_cursor(&cur, bdp, bdt, "Fla", FILTRO_QUALQUER)) {
+ *       while ((n = bdpartidas_proxima_pagina(&cur, pagina, 100)) > 0) {
+ *           ... usa pagina[0..n) ...
+ *       }
+ *   }
+ *   bdpartidas_fechar_cursor(&cur);
+ * 
+ * @param cur Cursor a inicializar
+ * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
+ * @param bdt Ponteiro para a estrutura BDTimes (nomes dos times)
+ * @param prefixo Prefixo do nome do time (case-insensitive)
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_abrir_cursor(CursorPartidas *cur, const BDPartidas *bdp, const BDTimes *bdt,
+                            const char *prefixo, FiltroPartida filtro);
+
+/**
+ * Busca a proxima pagina de partidas de um cursor.
+ * 
+ * @param cur Cursor aberto por bdpartidas_abrir_cursor()
+ * @param indices Array onde os indices da pagina serao armazenados
+ *                (posicoes na base, em ordem crescente)
+ * @param max_indices Tamanho da pagina
+ * @return Numero de indices armazenados nesta pagina (0 quando acabou)
+ */
+int bdpartidas_proxima_pagina(CursorPartidas *cur, int *indices, int max_indices);
+
+/**
+ * Fecha um cursor, liberando as marcas dos times.
+ * 
+ * @param cur Cursor passado a bdpartidas_abrir_cursor()
+ */
+void bdpartidas_fechar_cursor(CursorPartidas *cur);
+
+/**
+ * Escreve linhas de partidas (ex: resultado de uma busca) em um escritor.
+ * 
+ * Etapa de formatacao separada da busca: so e executada para os
+ * resultados que serao de fato exibidos.
+ * 
+ * Formato: | ID | Time1 | G1 x G2 | Time2 |
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
+ * @param bdt Ponteiro para a estrutura BDTimes (nomes dos times)
+ * @param indices Indices das partidas a escrever (posicoes na base)
+ * @param n Quantidade de indices
+ * @param w Escritor de destino
+ */
+void bdpartidas_escrever_partidas(const BDPartidas *bdp, const BDTimes *bdt,
+                                  const int *indices, int n, Escritor *w);
+
+/**
+ * Escreve a listagem de partidas filtradas por prefixo em um escritor.
+ * 
+ * Base das tres funcoes bdpartidas_listar_*: produz exatamente a mesma
+ * saida, mas no escritor indicado (tela, arquivo ou modo batch).
+ * Combina a busca paginada (um CursorPartidas, que marca os times uma
+ * unica vez para a listagem inteira) com bdpartidas_escrever_partidas().
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
+ * @param bdt Ponteiro para a estrutura BDTimes para buscar nomes dos times
+ * @param prefixo Prefixo do nome do time a buscar
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @param w Escritor de destino
+ */
+void bdpartidas_escrever_listagem(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo,
+                                  FiltroPartida filtro, Escritor *w);
+
 /**
  * Lista partidas filtrando pelo prefixo do time mandante.
  * 
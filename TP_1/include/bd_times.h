@@ -7,10 +7,10 @@
  * Este modulo oferece funcionalidades para:
  * - Armazenar informacoes de times (ID, nome, estatisticas)
  * - Carregar times de arquivos CSV
- * - Buscar times por ID ou prefixo do nome
+ * - Buscar times por ID, prefixo do nome, trecho do nome ou nome aproximado
  * - Acumular estatisticas de partidas
  * - Calcular pontuacao e saldo de gols
- * - Imprimir e exportar tabelas de classificacao
+ * - Imprimir e exportar tabelas de classificacao (tabela, CSV, JSON Lines, binario)
  * 
  * Estruturas principais:
  * - Time: Representa um unico time com suas estatisticas
@@ -21,11 +21,48 @@
 #define BD_TIMES_H
 
 #include <stddef.h>
+#include "escritor.h"
 
 // Constantes de configuracao do sistema
-#define MAX_TIMES 64       // Capacidade maxima de times que podem ser carregados simultaneamente
 #define MAX_NOME_TIME 64   // Tamanho maximo do buffer para nome do time (incluindo terminador nulo)
 
+/**
+ * Formatos de exportacao da tabela de classificacao.
+ * 
+ * - EXPORT_TABELA: tabela com separador "|" e colunas alinhadas (formato historico)
+ * - EXPORT_CSV: CSV padrao (RFC 4180) com cabecalho ID,Time,V,E,D,GM,GS,S,PG
+ * - EXPORT_JSONL: JSON Lines, um objeto por time
+ * - EXPORT_BINARIO: registros de tamanho fixo (ver EXPORT_BIN_*)
+ */
+typedef enum {
+    EXPORT_TABELA,
+    EXPORT_CSV,
+    EXPORT_JSONL,
+    EXPORT_BINARIO
+} FormatoExport;
+
+/*
+ * Layout do formato binario (todos os inteiros em 32 bits little-endian):
+ * 
+ * Cabecalho (16 bytes):
+ *   char magic[4]   = "BDCL"
+ *   u32  versao     = EXPORT_BIN_VERSAO
+ *   u32  n          = numero de registros
+ *   u32  tamanho    = EXPORT_BIN_REGISTRO
+ * 
+ * Registro (96 bytes), um por time em ordem crescente de ID:
+ *   i32  id
+ *   char nome[MAX_NOME_TIME]   (UTF-8, completado com '\0')
+ *   i32  v, e, d, gm, gs, s, pg
+ */
+#define EXPORT_BIN_MAGIC    "BDCL"
+#define EXPORT_BIN_VERSAO   1
+#define EXPORT_BIN_REGISTRO (4 + MAX_NOME_TIME + 7 * 4)
+
+// Largura visual (colunas) da coluna Time na tabela de classificacao da
+// tela; nomes mais largos sao truncados com '…'
+#define LARGURA_COLUNA_TIME 12
+
 /**
  * Estrutura que representa um time de futebol.
  * 
@@ -33,33 +70,199 @@
  * - Identificacao (ID e nome)
  * - Estatisticas acumuladas (vitorias, empates, derrotas)
  * - Gols (marcados e sofridos)
+ * - Contadores de partidas (mandante/visitante), que respondem as
+ *   contagens de partidas sem percorrer o array de partidas
+ * - Inicio da lista das partidas em que foi visitante (ult_visitante,
+ *   encadeada pelas partidas; ver PedacoPartidas)
  * 
  * As estatisticas sao acumuladas ao processar partidas usando
  * a funcao time_acumular_partida().
+ * 
+ * O tamanho, a largura visual e o ponto de corte do nome sao calculados
+ * uma vez, em bdtimes_adicionar(): a tabela de classificacao escreve o
+ * nome com memcpy + espacos, sem decodificar UTF-8 a cada impressao.
  */
 typedef struct {
     int id;                         // Identificador unico do time (definido no arquivo CSV)
     char nome[MAX_NOME_TIME];       // Nome do time codificado em UTF-8
+    unsigned char nome_bytes;       // strlen(nome)
+    unsigned char nome_largura;     // Largura visual do nome (utf8_largura, em colunas)
+    unsigned char nome_corte;       // Bytes do maior prefixo com ate LARGURA_COLUNA_TIME - 1 colunas
+    unsigned char nome_corte_largura;  // Largura desse prefixo (uma a menos se um caractere largo nao coube)
     int v;                          // Total de vitorias acumuladas
     int e;                          // Total de empates acumulados
     int d;                          // Total de derrotas acumuladas
     int gm;                         // Total de gols marcados pelo time
     int gs;                         // Total de gols sofridos pelo time
+    int jm;                         // Partidas jogadas como mandante
+    int jv;                         // Partidas jogadas como visitante
+    int jogos;                      // Partidas distintas em que o time aparece
+    int ult_visitante;              // Ultima partida (posicao) como visitante, -1 se nenhuma
 } Time;
 
+// Times por pedaco do array de times (potencia de 2). As versoes da base
+// (bd_versoes.h) compartilham os pedacos e so copiam os que alteram
+#define BITS_PEDACO_TIMES 8
+#define TIMES_POR_PEDACO (1 << BITS_PEDACO_TIMES)
+
+/**
+ * Pedaco de TIMES_POR_PEDACO times, compartilhado pelas bases que o
+ * referenciam (bdtimes_compartilhar()) e liberado pela ultima delas.
+ */
+typedef struct {
+    int refs;                       // Bases que usam o pedaco
+    Time times[TIMES_POR_PEDACO];   // Times do pedaco
+} PedacoTimes;
+
+/**
+ * Entrada da tabela de IDs: ID e posicao do time (-1 = balde vazio).
+ */
+typedef struct {
+    int id;
+    int slot;
+} EntradaId;
+
+/**
+ * Indice de IDs (bdtimes_buscar_por_id, bdtimes_slots_por_id): tabela
+ * hash com enderecamento aberto e sondagem linear, ocupada ate a metade.
+ * 
+ * Com IDs repetidos, so o primeiro time com o ID entra na tabela (o
+ * mesmo que a busca linear encontraria). Cobre os 'n' primeiros times
+ * da base, como IndiceAprox.
+ */
+typedef struct {
+    EntradaId *tabela;              // 'baldes' entradas
+    int baldes;                     // Potencia de 2 (0 = sem indice)
+    int bits;                       // log2(baldes)
+    int n;                          // Times cobertos pelo indice
+} IndiceIds;
+
+/**
+ * Indice de trigramas para a busca aproximada (bdtimes_buscar_aproximado).
+ * 
+ * Os nomes sao dobrados (utf8_dobrar()) e precedidos de um espaco; cada
+ * trigrama vai, por hash, para um de 'baldes' baldes. As listas de times
+ * dos baldes ficam contiguas: os times do balde b estao em
+ * times[inicio[b] .. inicio[b + 1]), cada um no maximo uma vez.
+ * 
+ * Cobre os 'n' primeiros times da base; os acrescentados depois sao
+ * verificados um a um ate a proxima indexacao.
+ */
+typedef struct {
+    unsigned int *inicio;           // baldes + 1 posicoes
+    int *times;                     // Indices dos times, agrupados por balde
+    int baldes;                     // Numero de baldes (potencia de 2; 0 = sem indice)
+    int n;                          // Times cobertos pelo indice
+} IndiceAprox;
+
+/**
+ * Indice de sufixos para a busca por trecho do nome (bdtimes_buscar_infixo).
+ * 
+ * 'texto' guarda os nomes dobrados (utf8_dobrar_str()), cada um terminado
+ * em '\0'; 'sufixos' tem as posicoes de 'texto' onde comeca um caractere,
+ * em ordem lexicografica dos sufixos (empates pela posicao). Os sufixos
+ * que comecam com um trecho formam um intervalo contiguo de 'sufixos',
+ * achado com duas buscas binarias.
+ * 
+ * Cobre os 'n' primeiros times da base, como IndiceAprox.
+ */
+typedef struct {
+    char *texto;                    // Nomes dobrados concatenados
+    int *sufixos;                   // Inicio dos sufixos, ordenados
+    int *inicio_nome;               // Posicao do nome de cada time em 'texto' (n + 1 posicoes)
+    int num_sufixos;                // Tamanho de 'sufixos'
+    int n;                          // Times cobertos pelo indice (0 = sem indice)
+} IndiceInfixo;
+
+/**
+ * Indice de nomes em ordem alfabetica, para a completacao interativa
+ * (ver completar.h).
+ * 
+ * 'ordem' tem as posicoes dos times em ordem dos nomes comparados byte a
+ * byte sem diferenciar caixa ASCII (a mesma regra de
+ * bdtimes_buscar_por_prefixo); nomes iguais ficam em ordem de posicao.
+ * Os times cujo nome comeca com um prefixo formam um intervalo contiguo
+ * de 'ordem' (FaixaNomes).
+ * 
+ * Cobre os 'n' primeiros times da base, como IndiceAprox.
+ */
+typedef struct {
+    int *ordem;                     // Posicoes dos times, em ordem de nome
+    int n;                          // Times cobertos pelo indice (0 = sem indice)
+} IndiceNomes;
+
+/**
+ * Intervalo [inicio, fim) de IndiceNomes.ordem com os times cujo nome
+ * comeca com um prefixo.
+ */
+typedef struct {
+    int inicio;                     // Primeira posicao em 'ordem'
+    int fim;                        // Uma depois da ultima
+} FaixaNomes;
+
+/**
+ * Resultado de uma busca de varios prefixos (bdtimes_buscar_prefixos).
+ * 
+ * Os times do i-esimo prefixo estao em indices[inicio[i] .. inicio[i + 1]),
+ * na mesma ordem que bdtimes_buscar_por_prefixo() devolveria.
+ */
+typedef struct {
+    int *inicio;                    // Numero de prefixos + 1 posicoes
+    int *indices;                   // Posicoes dos times, agrupadas por prefixo
+} LotePrefixos;
+
+/**
+ * Modos de busca de times por texto, do mais estrito ao mais tolerante.
+ * 
+ * As consultas interativas e em lote tentam cada modo, nessa ordem,
+ * ate algum encontrar times.
+ */
+typedef enum {
+    BUSCA_PREFIXO,                  // Nome comeca com o texto (bdtimes_buscar_por_prefixo)
+    BUSCA_INFIXO,                   // Nome contem o texto (bdtimes_buscar_infixo)
+    BUSCA_APROXIMADA                // Nome comeca com algo parecido (bdtimes_buscar_aproximado)
+} ModoBusca;
+
 /**
  * Estrutura que representa o banco de dados de times em memoria.
  * 
- * Mantem um array de tamanho fixo com todos os times carregados.
- * O campo 'n' indica quantos elementos do array sao validos.
+ * Os times ficam em pedacos de TIMES_POR_PEDACO (o time i e
+ * bdtimes_time(bd, i)), alocados conforme necessario (sem limite fixo de
+ * times). O campo 'n' indica quantos times sao validos.
  * 
- * Capacidade maxima: MAX_TIMES (64 times)
+ * Pedacos e indices podem ser compartilhados com outras bases
+ * (bdtimes_compartilhar()): os indices nunca mudam depois de construidos
+ * e um pedaco compartilhado e copiado antes de ser alterado
+ * (bdtimes_alterar()).
+ * 
+ * A memoria (incluindo os indices de busca) e liberada por
+ * bdtimes_liberar().
  */
 typedef struct {
-    Time times[MAX_TIMES];          // Array de tamanho fixo contendo os times carregados
-    int n;                          // Numero de times validos atualmente no array (0 a MAX_TIMES)
+    PedacoTimes **pedacos;          // Pedacos com os times carregados
+    int n;                          // Numero de times validos
+    int cap_pedacos;                // Capacidade alocada de 'pedacos'
+    IndiceIds ids;                  // Tabela hash de ID para posicao
+    IndiceAprox aprox;              // Indice de trigramas dos nomes
+    IndiceInfixo infixo;            // Indice de sufixos dos nomes
+    IndiceNomes nomes;              // Nomes em ordem alfabetica
+    int *refs_indices;              // Bases que compartilham os indices (NULL = so esta)
 } BDTimes;
 
+/**
+ * Acessa o time de uma posicao da base (0 <= i < bd->n).
+ * 
+ * So leitura em bases com pedacos compartilhados: para alterar o time,
+ * use bdtimes_alterar().
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param i Posicao do time
+ * @return Ponteiro para o time
+ */
+static inline Time* bdtimes_time(const BDTimes *bd, int i) {
+    return &bd->pedacos[i >> BITS_PEDACO_TIMES]->times[i & (TIMES_POR_PEDACO - 1)];
+}
+
 // ========== Funcoes de gerenciamento da base de dados ==========
 
 /**
@@ -72,12 +275,78 @@ typedef struct {
  */
 void bdtimes_init(BDTimes *bd);
 
+/**
+ * Libera a memoria de uma base de times.
+ * 
+ * A base fica vazia e pode ser reutilizada sem nova inicializacao.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ */
+void bdtimes_liberar(BDTimes *bd);
+
+/**
+ * Acrescenta um time ao final da base, aumentando o array se preciso.
+ * 
+ * Calcula os campos derivados do nome (nome_bytes, nome_largura,
+ * nome_corte e nome_corte_largura); os valores desses campos em 't' sao
+ * ignorados.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param t Time a acrescentar (copiado)
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_adicionar(BDTimes *bd, const Time *t);
+
+/**
+ * Copia uma base de times (times e estatisticas).
+ * 
+ * 'dst' nao precisa estar inicializada; a copia tem seus proprios
+ * pedacos e indices e deve ser liberada com bdtimes_liberar().
+ * 
+ * @param dst Base de destino
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 em caso de erro
+ */
+int bdtimes_copiar(BDTimes *dst, const BDTimes *src);
+
+/**
+ * Cria uma base que compartilha os pedacos e os indices de outra.
+ * 
+ * Custa O(n / TIMES_POR_PEDACO): nenhum time e copiado. As duas bases
+ * podem ser lidas ao mesmo tempo; quem altera um time de qualquer uma
+ * delas deve usar bdtimes_alterar(), que copia o pedaco antes. Cada base
+ * e liberada com bdtimes_liberar(); o ultimo a liberar um pedaco ou os
+ * indices libera a memoria.
+ * 
+ * Reindexar uma das bases (bdtimes_indexar_*) copia antes os indices
+ * compartilhados.
+ * 
+ * 'dst' nao precisa estar inicializada.
+ * 
+ * @param dst Base de destino
+ * @param src Base de origem (passa a compartilhar os indices)
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_compartilhar(BDTimes *dst, BDTimes *src);
+
+/**
+ * Prepara um time para alteracao, copiando antes o seu pedaco se ele e
+ * compartilhado com outra base (bdtimes_compartilhar()).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param i Posicao do time (0 <= i < bd->n)
+ * @return Ponteiro para o time, ou NULL se faltou memoria
+ */
+Time* bdtimes_alterar(BDTimes *bd, int i);
+
 /**
  * Carrega times de um arquivo CSV.
  * 
  * Le um arquivo CSV no formato "ID,Nome" e carrega os times na base de dados.
  * A primeira linha do arquivo (cabecalho) e descartada.
  * Todos os times sao carregados com estatisticas zeradas.
+ * Ao final, reconstroi os indices de IDs, da busca aproximada, da busca
+ * por trecho e de nomes.
  * 
  * Formato esperado do arquivo:
  * ID,Nome
@@ -91,11 +360,23 @@ void bdtimes_init(BDTimes *bd);
  */
 int bdtimes_carregar_csv(BDTimes *bd, const char *caminho);
 
+/**
+ * (Re)constroi o indice de IDs para todos os times da base.
+ * 
+ * Chamada por bdtimes_carregar_csv(); times acrescentados depois
+ * continuam sendo encontrados (um a um) ate a proxima indexacao.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_ids(BDTimes *bd);
+
 /**
  * Busca um time pelo seu ID unico.
  * 
- * Realiza uma busca linear na base de dados procurando um time
- * com o ID especificado.
+ * Consulta o indice de IDs (O(1) esperado). Com IDs repetidos,
+ * devolve o primeiro time com o ID. Em bases com pedacos compartilhados,
+ * o time so pode ser alterado depois de bdtimes_alterar().
  * 
  * @param bd Ponteiro para a estrutura BDTimes onde buscar
  * @param id ID do time procurado
@@ -103,6 +384,23 @@ int bdtimes_carregar_csv(BDTimes *bd, const char *caminho);
  */
 Time* bdtimes_buscar_por_id(BDTimes *bd, int id);
 
+/**
+ * Converte varios IDs em posicoes de times de uma vez.
+ * 
+ * Para tabelas maiores que a cache: os IDs sao tratados em grupos;
+ * em cada grupo, primeiro calcula o balde de todos, depois pede a
+ * pre-busca de todos os baldes e so entao sonda a tabela, de modo que
+ * as faltas de cache do grupo se sobrepoem em vez de acontecer uma por
+ * vez.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param ids IDs a converter
+ * @param n Numero de IDs
+ * @param slots Saida: posicao de cada time na base, ou -1 se o ID
+ *              nao existir (n posicoes; pode ser o proprio 'ids')
+ */
+void bdtimes_slots_por_id(const BDTimes *bd, const int *ids, int n, int *slots);
+
 /**
  * Busca times cujo nome comeca com um prefixo.
  * 
@@ -116,7 +414,174 @@ Time* bdtimes_buscar_por_id(BDTimes *bd, int id);
  * @param max_indices Tamanho maximo do array indices
  * @return Total de times encontrados (pode exceder max_indices)
  */
-int bdtimes_buscar_por_prefixo(BDTimes *bd, const char *prefixo, int *indices, int max_indices);
+int bdtimes_buscar_por_prefixo(const BDTimes *bd, const char *prefixo, int *indices, int max_indices);
+
+/**
+ * (Re)constroi o indice de trigramas da busca aproximada para todos os
+ * times da base.
+ * 
+ * Chamada por bdtimes_carregar_csv(); quem acrescenta times de outra
+ * forma pode chamar de novo (sem o indice, a busca continua correta,
+ * apenas verifica os times um a um).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_aproximado(BDTimes *bd);
+
+/**
+ * Busca times cujo nome comeca com algo parecido com o texto.
+ * 
+ * Tolera erros de digitacao, acentos e caixa: um time e encontrado se
+ * algum prefixo do seu nome dobrado (utf8_dobrar()) esta a no maximo
+ * k edicoes (insercao, remocao ou troca de um caractere) do texto
+ * dobrado, com k = 0 ate 4 caracteres, 1 ate 10 e 2 a partir de 11.
+ * Ex: "Flamengp" encontra "Flamengo"; "sao" encontra "São Paulo".
+ * 
+ * Os trigramas do texto filtram os candidatos pelo indice (um nome a
+ * k edicoes preserva ao menos T - 3k dos T trigramas distintos do texto);
+ * so os candidatos passam pela distancia de edicao. Textos curtos demais
+ * para o filtro sao verificados contra todos os times.
+ * 
+ * Resultados em ordem de distancia e, no empate, de posicao na base.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param texto Texto digitado (ex: "Flamengp")
+ * @param indices Array onde os indices dos times encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+int bdtimes_buscar_aproximado(const BDTimes *bd, const char *texto, int *indices, int max_indices);
+
+/**
+ * (Re)constroi o indice de sufixos da busca por trecho para todos os
+ * times da base.
+ * 
+ * Chamada por bdtimes_carregar_csv(); como na busca aproximada, times
+ * acrescentados depois continuam sendo encontrados (um a um).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_infixo(BDTimes *bd);
+
+/**
+ * Busca times cujo nome contem um trecho, sem diferenciar caixa nem
+ * acentos (nomes e trecho dobrados com utf8_dobrar_str()).
+ * Ex: "paulo" encontra "São Paulo"; "sao" tambem.
+ * 
+ * Custa O(m log S) para achar as ocorrencias (m = bytes do trecho,
+ * S = caracteres de todos os nomes), mais a ordenacao dos times
+ * encontrados. Resultados em ordem de posicao na base.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param trecho Trecho do nome
+ * @param indices Array onde os indices dos times encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+int bdtimes_buscar_infixo(const BDTimes *bd, const char *trecho, int *indices, int max_indices);
+
+/**
+ * (Re)constroi o indice de nomes em ordem alfabetica.
+ * 
+ * Chamada por bdtimes_carregar_csv(). Times acrescentados depois ficam
+ * fora do indice ate a proxima indexacao (nomes.n < n).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_nomes(BDTimes *bd);
+
+/**
+ * Restringe uma faixa do indice de nomes a um caractere a mais do prefixo.
+ * 
+ * Todos os nomes da faixa comecam com os mesmos 'pos' bytes (ignorando
+ * caixa); a nova faixa tem os que tem 'c' (ignorando caixa) no byte
+ * 'pos'. Como so esse byte e comparado, custa O(log n) e nao depende do
+ * tamanho do prefixo. A faixa de todos os nomes e [0, nomes.n).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param faixa Faixa do prefixo de 'pos' bytes (atualizada)
+ * @param pos Bytes do prefixo ja consumidos
+ * @param c Proximo byte do prefixo (diferente de '\0')
+ * @return Numero de times na nova faixa
+ */
+int bdtimes_estreitar_faixa(const BDTimes *bd, FaixaNomes *faixa, int pos, char c);
+
+/**
+ * Calcula a faixa do indice de nomes de um prefixo inteiro (um
+ * bdtimes_estreitar_faixa() por byte).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param prefixo Prefixo do nome
+ * @param faixa Faixa resultante
+ * @return Numero de times na faixa
+ */
+int bdtimes_faixa_prefixo(const BDTimes *bd, const char *prefixo, FaixaNomes *faixa);
+
+/**
+ * Busca os times de varios prefixos de uma vez (ex: todos os "team" de
+ * um arquivo do modo batch).
+ * 
+ * Mesmo resultado de chamar bdtimes_buscar_por_prefixo() para cada
+ * prefixo, mas os prefixos sao ordenados uma vez e resolvidos numa unica
+ * passada pelo indice de nomes: O(p log p) para ordenar e O(log n) por
+ * prefixo, em vez de O(n) por prefixo.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param prefixos Prefixos a buscar
+ * @param n Numero de prefixos
+ * @param lote Resultado, na ordem dos prefixos (liberar com bdtimes_liberar_lote)
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_buscar_prefixos(const BDTimes *bd, const char *const *prefixos, int n, LotePrefixos *lote);
+
+/**
+ * Libera o resultado de bdtimes_buscar_prefixos().
+ * 
+ * @param lote Resultado a liberar
+ */
+void bdtimes_liberar_lote(LotePrefixos *lote);
+
+/**
+ * Busca times por texto em um dos modos de ModoBusca.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param modo Modo de busca
+ * @param texto Texto digitado
+ * @param indices Array onde os indices dos times encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+int bdtimes_buscar(const BDTimes *bd, ModoBusca modo, const char *texto, int *indices, int max_indices);
+
+/**
+ * Busca times como bdtimes_buscar(), devolvendo todos os resultados.
+ * 
+ * Busca uma unica vez num array de BUSCA_INDICES_INICIAL indices; so
+ * refaz a busca, com o tamanho exato, se o total passar disso.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param modo Modo de busca
+ * @param texto Texto digitado
+ * @param indices Saida: array com os indices encontrados (liberar com
+ *                mem_liberar), ou NULL se nenhum time foi encontrado ou
+ *                se faltou memoria
+ * @return Total de times encontrados, ou -1 se faltou memoria
+ */
+int bdtimes_buscar_todos(const BDTimes *bd, ModoBusca modo, const char *texto, int **indices);
+
+/**
+ * Calcula a ordem da classificacao (Parte I): ID crescente.
+ * 
+ * Times com IDs repetidos mantem a ordem em que foram carregados.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param ordem Array de saida com bd->n posicoes (posicoes na base)
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_ordem_por_id(const BDTimes *bd, int *ordem);
 
 // ========== Funcoes para manipulacao de times individuais ==========
 
@@ -167,21 +632,74 @@ int time_pontos(const Time *t);
  */
 int time_saldo(const Time *t);
 
-// ========== Funcoes de exibicao ==========
+// ========== Funcoes de exibicao e exportacao ==========
+
+/**
+ * Escreve uma lista de times (ex: resultado de bdtimes_buscar_por_prefixo).
+ * 
+ * Formato: | ID | Time | V | E | D | GM | GS | S | PG |
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param indices Indices dos times a escrever (posicoes na base)
+ * @param n Quantidade de indices
+ * @param w Escritor de destino
+ */
+void bdtimes_escrever_times(const BDTimes *bd, const int *indices, int n, Escritor *w);
+
+/**
+ * Converte o nome de um formato ("tabela", "csv", "jsonl", "bin") para o enum.
+ * 
+ * @param nome Nome do formato
+ * @param out Onde o formato sera armazenado (apenas se sucesso)
+ * @return 1 se o nome e valido, 0 caso contrario
+ */
+int bdtimes_formato_de_nome(const char *nome, FormatoExport *out);
+
+/**
+ * Retorna o nome padrao do arquivo exportado em um formato.
+ * 
+ * @param fmt Formato de exportacao
+ * @return "bd_classificacao.csv", "bd_classificacao.jsonl" ou "bd_classificacao.bin"
+ */
+const char* bdtimes_arquivo_padrao(FormatoExport fmt);
+
+/**
+ * Exporta a tabela de classificacao para um arquivo.
+ * 
+ * A saida e gerada em streaming por um escritor bufferizado.
+ * Os times sao exportados em ordem crescente de ID.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes contendo os times
+ * @param fmt Formato de saida
+ * @param caminho Arquivo de destino, ou NULL para bdtimes_arquivo_padrao(fmt)
+ * @return 1 se a exportacao foi bem sucedida, 0 em caso de erro
+ */
+int bdtimes_exportar(const BDTimes *bd, FormatoExport fmt, const char *caminho);
+
+/**
+ * Escreve a tabela de classificacao (formato de tela) em um escritor.
+ * 
+ * Nao exporta arquivo; apenas gera a tabela alinhada no destino.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes contendo os times
+ * @param w Escritor de destino
+ */
+void bdtimes_escrever_classificacao(const BDTimes *bd, Escritor *w);
 
 /**
- * Imprime a tabela de classificacao na tela e exporta para CSV.
+ * Imprime a tabela de classificacao na tela e exporta para arquivo.
  * 
  * Exibe todos os times em formato de tabela visual com colunas
- * alinhadas. Alem disso, cria/sobrescreve o arquivo "bd_classificacao.csv"
- * com os mesmos dados em formato CSV com separador "|".
+ * alinhadas. Alem disso, cria/sobrescreve o arquivo de exportacao
+ * do formato escolhido (ver bdtimes_arquivo_padrao()).
  * 
  * Os times sao ordenados por ID de forma crescente.
  * 
  * Colunas: ID | Time | V | E | D | GM | GS | S | PG
  * 
  * @param bd Ponteiro para a estrutura BDTimes contendo os times
+ * @param fmt Formato do arquivo exportado
  */
-void bdtimes_imprimir_classificacao(const BDTimes *bd);
+void bdtimes_imprimir_classificacao(const BDTimes *bd, FormatoExport fmt);
 
 #endif
@@ -0,0 +1,124 @@
+/**
+ * Header: bd_versoes.h
+ * 
+ * Define uma base versionada (estilo RCU) para uso em processos de longa
+ * duracao, em que consultas e ingestao de partidas acontecem ao mesmo tempo.
+ * 
+ * Ideia:
+ * - Cada versao e um instantaneo imutavel com os times (e suas estatisticas)
+ *   e as partidas
+ * - Leitores pegam a versao atual e a consultam sem nenhuma trava; a versao
+ *   nunca muda enquanto estiver sendo lida
+ * - O escritor cria uma versao que compartilha os dados da atual (indices,
+ *   pedacos de times e de partidas), copia so os pedacos dos times que as
+ *   partidas novas alteram, acrescenta e aplica as partidas e publica a
+ *   nova versao com uma unica troca atomica de ponteiro
+ * - Versoes antigas sao liberadas por reclamacao baseada em epocas: uma
+ *   versao aposentada so e liberada quando nenhum leitor que possa te-la
+ *   visto continua ativo
+ * 
+ * Uso por um leitor:
+ *   int id = bdversoes_registrar_leitor(bv);      // uma vez por thread
+ *   const Versao *v = bdversoes_ler_inicio(bv, id);
+ *   ... consulta v->times e v->partidas ...
+ *   bdversoes_ler_fim(bv, id);
+ */
+
+#ifndef BD_VERSOES_H
+#define BD_VERSOES_H
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "bd_times.h"
+#include "bd_partidas.h"
+
+// Numero maximo de threads leitoras registradas
+#define MAX_LEITORES 64
+
+/**
+ * Um instantaneo imutavel da base (times + partidas).
+ */
+typedef struct Versao {
+    BDTimes times;                  // Times com as estatisticas desta versao
+    BDPartidas partidas;            // Partidas incluidas nesta versao
+    unsigned long long numero;      // Numero sequencial da versao (1, 2, ...)
+    unsigned long long epoca;       // Epoca em que foi aposentada (reclamacao)
+    struct Versao *prox;            // Proxima na lista de versoes aposentadas
+} Versao;
+
+/**
+ * Base versionada: a versao atual e o estado da reclamacao por epocas.
+ * 
+ * Apenas os escritores usam a trava 'escrita' (para se ordenarem entre si);
+ * leitores usam somente operacoes atomicas.
+ */
+typedef struct {
+    _Atomic(Versao*) atual;                          // Versao publicada
+    atomic_ullong epoca;                             // Epoca global (comeca em 1)
+    atomic_ullong leitores[MAX_LEITORES];            // Epoca anunciada por leitor (0 = inativo)
+    atomic_int n_leitores;                           // Leitores registrados
+    pthread_mutex_t escrita;                         // Serializa os escritores
+    Versao *aposentadas;                             // Versoes aguardando liberacao
+} BDVersionada;
+
+/**
+ * Cria a primeira versao a partir de bases ja carregadas (copiadas).
+ * 
+ * @param bv Base versionada a inicializar
+ * @param bdt Times iniciais (com estatisticas ja aplicadas)
+ * @param bdp Partidas iniciais
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdversoes_iniciar(BDVersionada *bv, const BDTimes *bdt, const BDPartidas *bdp);
+
+/**
+ * Libera todas as versoes. Nao pode haver leitores ativos.
+ * 
+ * @param bv Base versionada
+ */
+void bdversoes_liberar(BDVersionada *bv);
+
+/**
+ * Registra uma thread leitora (sem travas).
+ * 
+ * @param bv Base versionada
+ * @return Identificador do leitor, ou -1 se MAX_LEITORES foi atingido
+ */
+int bdversoes_registrar_leitor(BDVersionada *bv);
+
+/**
+ * Inicia uma leitura: anuncia a epoca do leitor e retorna a versao atual.
+ * 
+ * A versao retornada permanece valida e inalterada ate bdversoes_ler_fim().
+ * Nunca bloqueia.
+ * 
+ * @param bv Base versionada
+ * @param leitor Identificador obtido em bdversoes_registrar_leitor()
+ * @return Versao atual
+ */
+const Versao* bdversoes_ler_inicio(BDVersionada *bv, int leitor);
+
+/**
+ * Termina uma leitura iniciada com bdversoes_ler_inicio().
+ * 
+ * @param bv Base versionada
+ * @param leitor Identificador do leitor
+ */
+void bdversoes_ler_fim(BDVersionada *bv, int leitor);
+
+/**
+ * Aplica partidas novas e publica uma nova versao.
+ * 
+ * A nova versao compartilha os dados da atual; so os pedacos dos times
+ * alterados sao copiados. As partidas sao acrescentadas e aplicadas as
+ * estatisticas da nova versao, que e publicada atomicamente. Leitores
+ * em andamento continuam vendo a versao anterior.
+ * 
+ * @param bv Base versionada
+ * @param novas Partidas a acrescentar
+ * @param n Quantidade de partidas
+ * @return Numero da nova versao, ou 0 se faltou memoria
+ */
+unsigned long long bdversoes_adicionar_partidas(BDVersionada *bv, const Partida *novas, int n);
+
+#endif
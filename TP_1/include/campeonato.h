@@ -0,0 +1,308 @@
+/**
+ * Header: campeonato.h
+ * 
+ * API publica e estavel da biblioteca libcampeonato (.a / .so).
+ * 
+ * Permite que outros programas reutilizem o motor do campeonato (carga
+ * dos CSVs, agregacao das estatisticas e consultas) sem executar o
+ * programa interativo. Diferente das funcoes bdpartidas_listar_*, nenhuma
+ * consulta escreve na saida padrao: os resultados sao devolvidos em
+ * arrays de indices preenchidos pelo chamador, e os dados de cada time
+ * ou partida sao obtidos por indice.
+ * 
+ * Estabilidade:
+ * - A base fica atras de um ponteiro opaco (Campeonato); as estruturas
+ *   internas (BDTimes, BDPartidas) podem mudar sem quebrar quem usa a API
+ * - CampeonatoTime e CampeonatoPartida so ganham campos novos com uma
+ *   nova CAMPEONATO_API_VERSAO
+ * - A biblioteca dinamica exporta apenas as funcoes deste header
+ * 
+ * Exemplo:
+ *   Campeonato *c = campeonato_criar();
+ *   campeonato_carregar_times(c, "times.csv");
+ *   campeonato_carregar_partidas(c, "partidas.csv");
+ *   int idx[16];
+ *   int n = campeonato_buscar_times(c, "Fla", idx, 16);
+ *   for (int i = 0; i < n && i < 16; i++) {
+ *       CampeonatoTime t;
+ *       campeonato_obter_time(c, idx[i], &t);
+ *       ... usa t.nome, t.pontos ...
+ *   }
+ *   campeonato_destruir(c);
+ * 
+ * Uma mesma instancia nao deve ser usada por varias threads ao mesmo
+ * tempo se uma delas estiver carregando ou adicionando partidas.
+ */
+
+#ifndef CAMPEONATO_H
+#define CAMPEONATO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Versao da API (incrementada a cada mudanca incompativel)
+#define CAMPEONATO_API_VERSAO 1
+
+// Marca os simbolos exportados pela biblioteca dinamica
+#if defined(__GNUC__) && !defined(_WIN32)
+#define CAMPEONATO_API __attribute__((visibility("default")))
+#else
+#define CAMPEONATO_API
+#endif
+
+/**
+ * Instancia opaca do campeonato (times, partidas e estatisticas).
+ */
+typedef struct Campeonato Campeonato;
+
+/**
+ * Cursor opaco de uma busca paginada de partidas.
+ */
+typedef struct CampeonatoCursor CampeonatoCursor;
+
+/**
+ * Lado da partida em que o prefixo e testado nas buscas de partidas.
+ */
+typedef enum {
+    CAMPEONATO_MANDANTE,   // Apenas o time mandante
+    CAMPEONATO_VISITANTE,  // Apenas o time visitante
+    CAMPEONATO_QUALQUER    // Mandante ou visitante
+} CampeonatoFiltro;
+
+/**
+ * Dados de um time, com as estatisticas ja agregadas.
+ * 
+ * 'nome' aponta para memoria da instancia e vale ate a proxima carga
+ * ou ate campeonato_destruir().
+ */
+typedef struct {
+    int id;            // ID do time
+    const char *nome;  // Nome em UTF-8
+    int v;             // Vitorias
+    int e;             // Empates
+    int d;             // Derrotas
+    int gm;            // Gols marcados
+    int gs;            // Gols sofridos
+    int saldo;         // Saldo de gols (GM - GS)
+    int pontos;        // Pontos (3*V + E)
+} CampeonatoTime;
+
+/**
+ * Dados de uma partida.
+ */
+typedef struct {
+    int id;              // ID da partida
+    int mandante;        // ID do time mandante
+    int visitante;       // ID do time visitante
+    int gols_mandante;   // Gols do mandante
+    int gols_visitante;  // Gols do visitante
+} CampeonatoPartida;
+
+// ========== Ciclo de vida e carga ==========
+
+/**
+ * Retorna a versao da API com que a biblioteca foi compilada.
+ * 
+ * @return CAMPEONATO_API_VERSAO da biblioteca
+ */
+CAMPEONATO_API int campeonato_versao_api(void);
+
+/**
+ * Cria uma instancia vazia.
+ * 
+ * @return Nova instancia, ou NULL se faltou memoria
+ */
+CAMPEONATO_API Campeonato* campeonato_criar(void);
+
+/**
+ * Libera uma instancia e todos os seus dados.
+ * 
+ * @param c Instancia (NULL e aceito)
+ */
+CAMPEONATO_API void campeonato_destruir(Campeonato *c);
+
+/**
+ * Carrega os times de um CSV ("ID,Nome").
+ * 
+ * Deve ser chamada antes de campeonato_carregar_partidas().
+ * 
+ * @param c Instancia
+ * @param caminho Caminho do arquivo
+ * @return Numero de times carregados, ou 0 em caso de erro
+ */
+CAMPEONATO_API int campeonato_carregar_times(Campeonato *c, const char *caminho);
+
+/**
+ * Carrega as partidas de um CSV e agrega os resultados nos times.
+ * 
+ * @param c Instancia
+ * @param caminho Caminho do arquivo ("ID,Time1ID,Time2ID,Gols1,Gols2")
+ * @return Numero de partidas carregadas, ou 0 em caso de erro
+ */
+CAMPEONATO_API int campeonato_carregar_partidas(Campeonato *c, const char *caminho);
+
+/**
+ * Acrescenta uma partida e agrega o resultado nos times.
+ * 
+ * @param c Instancia
+ * @param p Partida a acrescentar
+ * @return 1 se acrescentada, 0 se faltou memoria
+ */
+CAMPEONATO_API int campeonato_adicionar_partida(Campeonato *c, const CampeonatoPartida *p);
+
+// ========== Acesso por indice ==========
+
+/**
+ * @param c Instancia
+ * @return Numero de times carregados (indices validos: 0..n-1)
+ */
+CAMPEONATO_API int campeonato_num_times(const Campeonato *c);
+
+/**
+ * @param c Instancia
+ * @return Numero de partidas carregadas (indices validos: 0..n-1)
+ */
+CAMPEONATO_API int campeonato_num_partidas(const Campeonato *c);
+
+/**
+ * Obtem os dados de um time.
+ * 
+ * @param c Instancia
+ * @param indice Indice do time (resultado de uma busca)
+ * @param out Onde os dados serao armazenados
+ * @return 1 se sucesso, 0 se o indice e invalido
+ */
+CAMPEONATO_API int campeonato_obter_time(const Campeonato *c, int indice, CampeonatoTime *out);
+
+/**
+ * Obtem os dados de uma partida.
+ * 
+ * @param c Instancia
+ * @param indice Indice da partida (resultado de uma busca)
+ * @param out Onde os dados serao armazenados
+ * @return 1 se sucesso, 0 se o indice e invalido
+ */
+CAMPEONATO_API int campeonato_obter_partida(const Campeonato *c, int indice, CampeonatoPartida *out);
+
+// ========== Consultas ==========
+
+/**
+ * Busca times cujo nome comeca com um prefixo (case-insensitive).
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome
+ * @param indices Array onde os indices dos times serao armazenados
+ * @param max_indices Tamanho do array
+ * @return Total de times encontrados (pode exceder max_indices)
+ */
+CAMPEONATO_API int campeonato_buscar_times(const Campeonato *c, const char *prefixo,
+                                           int *indices, int max_indices);
+
+/**
+ * Busca times cujo nome comeca com algo parecido com o texto (tolera
+ * erros de digitacao, acentos e caixa). Ex: "Flamengp" -> "Flamengo".
+ * 
+ * Resultados do mais parecido para o menos parecido.
+ * 
+ * @param c Instancia
+ * @param texto Texto digitado
+ * @param indices Array onde os indices dos times serao armazenados
+ * @param max_indices Tamanho do array
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+CAMPEONATO_API int campeonato_buscar_times_aproximado(const Campeonato *c, const char *texto,
+                                                      int *indices, int max_indices);
+
+/**
+ * Busca times cujo nome contem um trecho em qualquer posicao (ignora
+ * caixa e acentos). Ex: "paulo" -> "Sao Paulo".
+ * 
+ * Resultados na ordem da base.
+ * 
+ * @param c Instancia
+ * @param trecho Trecho do nome
+ * @param indices Array onde os indices dos times serao armazenados
+ * @param max_indices Tamanho do array
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+CAMPEONATO_API int campeonato_buscar_times_infixo(const Campeonato *c, const char *trecho,
+                                                  int *indices, int max_indices);
+
+/**
+ * Busca partidas de times cujo nome comeca com um prefixo.
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @param indices Array onde os indices das partidas serao armazenados
+ * @param max_indices Tamanho do array
+ * @return Total de partidas encontradas (pode exceder max_indices)
+ */
+CAMPEONATO_API int campeonato_buscar_partidas(const Campeonato *c, const char *prefixo,
+                                              CampeonatoFiltro filtro, int *indices, int max_indices);
+
+/**
+ * Conta partidas de times cujo nome comeca com um prefixo.
+ * 
+ * Usa contadores por time mantidos durante a carga; nao percorre as
+ * partidas (CAMPEONATO_QUALQUER com varios times casando percorre apenas
+ * as partidas desses times como visitantes).
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return Numero de partidas encontradas
+ */
+CAMPEONATO_API int campeonato_contar_partidas(const Campeonato *c, const char *prefixo,
+                                              CampeonatoFiltro filtro);
+
+/**
+ * Abre uma busca paginada de partidas de times cujo nome comeca com um
+ * prefixo.
+ * 
+ * Os times sao marcados uma unica vez, na abertura; as paginas sao obtidas
+ * com campeonato_proxima_pagina_partidas(). O cursor vale ate a proxima
+ * carga na instancia e deve ser liberado com
+ * campeonato_fechar_cursor_partidas().
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return Novo cursor, ou NULL se faltou memoria
+ */
+CAMPEONATO_API CampeonatoCursor* campeonato_abrir_cursor_partidas(const Campeonato *c, const char *prefixo,
+                                                                  CampeonatoFiltro filtro);
+
+/**
+ * Busca a proxima pagina de partidas de um cursor.
+ * 
+ * @param cur Cursor aberto por campeonato_abrir_cursor_partidas()
+ * @param indices Array onde os indices da pagina serao armazenados
+ * @param max_indices Tamanho da pagina
+ * @return Numero de indices nesta pagina (0 quando acabou)
+ */
+CAMPEONATO_API int campeonato_proxima_pagina_partidas(CampeonatoCursor *cur, int *indices, int max_indices);
+
+/**
+ * Libera um cursor.
+ * 
+ * @param cur Cursor (NULL e aceito)
+ */
+CAMPEONATO_API void campeonato_fechar_cursor_partidas(CampeonatoCursor *cur);
+
+/**
+ * Retorna os times na ordem da classificacao (Parte I: ID crescente).
+ * 
+ * @param c Instancia
+ * @param indices Array onde os indices dos times serao armazenados
+ * @param max_indices Tamanho do array
+ * @return Numero total de times (pode exceder max_indices), ou 0 se faltou memoria
+ */
+CAMPEONATO_API int campeonato_classificacao(const Campeonato *c, int *indices, int max_indices);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * Header: completar.h
+ *
+ * Define a completacao interativa de nomes de times (type-ahead) usada
+ * pela opcao 1 do menu.
+ *
+ * A cada tecla, a faixa de times cujo nome comeca com o texto digitado e
+ * restringida a partir da faixa do texto anterior no indice de nomes
+ * (bdtimes_estreitar_faixa(), O(log n) por tecla), e os primeiros nomes
+ * da faixa aparecem abaixo da linha de entrada. Apagar um caractere volta
+ * a faixa guardada daquele tamanho, sem nova busca.
+ *
+ * Teclas:
+ * - Enter: confirma o texto digitado
+ * - Tab: completa com o maior prefixo comum dos nomes da faixa
+ * - Backspace: apaga o ultimo caractere
+ * - Ctrl-C / Ctrl-D: cancela
+ *
+ * So funciona com entrada e saida em um terminal; fora dele (entrada
+ * redirecionada, Windows) quem chama le a linha inteira como antes.
+ */
+
+#ifndef COMPLETAR_H
+#define COMPLETAR_H
+
+#include "bd_times.h"
+
+// Nomes mostrados abaixo da linha de entrada
+#define COMPLETAR_SUGESTOES 8
+
+/**
+ * Le um nome ou prefixo de time do terminal, com completacao.
+ *
+ * O terminal fica em modo nao canonico (sem eco, tecla a tecla) durante
+ * a leitura e e restaurado antes de retornar.
+ *
+ * @param bd Base de times (com o indice de nomes cobrindo todos os times)
+ * @param rotulo Texto exibido antes do que e digitado
+ * @param buf Buffer de saida
+ * @param cap Tamanho do buffer (incluindo o '\0')
+ * @return 1 se um texto foi confirmado, 0 se a leitura foi cancelada
+ *         (ou EOF), -1 se a completacao nao esta disponivel (stdin ou
+ *         stdout fora de um terminal, ou indice de nomes desatualizado)
+ */
+int completar_ler_nome(const BDTimes *bd, const char *rotulo, char *buf, int cap);
+
+#endif
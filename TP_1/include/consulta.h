@@ -0,0 +1,110 @@
+/**
+ * Header: consulta.h
+ * 
+ * Define a linguagem de comandos de consulta usada pelo modo batch
+ * (execucao nao interativa, sem menus nem prompts).
+ * 
+ * Cada linha de entrada contem um comando:
+ * - "team <prefixo>"  (ou "time"):      times cujo nome comeca com o prefixo
+ *   (sem nenhum, mostra os que contem o texto, como "contains", e depois
+ *   os de nome parecido, como "fuzzy")
+ * - "contains <texto>" (ou "contem"):   times cujo nome contem o texto,
+ *   sem diferenciar caixa nem acentos (ver bdtimes_buscar_infixo)
+ * - "fuzzy <texto>"   (ou "aprox"):     times de nome parecido com o texto
+ *   (tolera erros de digitacao e acentos; ver bdtimes_buscar_aproximado)
+ * - "home <prefixo>"  (ou "mandante"):  partidas pelo prefixo do mandante
+ * - "away <prefixo>"  (ou "visitante"): partidas pelo prefixo do visitante
+ * - "any <prefixo>"   (ou "qualquer"):  partidas pelo prefixo de qualquer time
+ * - "count-home <prefixo>" (ou "conta-mandante"), "count-away <prefixo>"
+ *   (ou "conta-visitante"), "count-any <prefixo>" (ou "conta-qualquer"):
+ *   apenas o numero de partidas que a listagem correspondente exibiria
+ * - "table"           (ou "tabela"):    tabela de classificacao
+ * - "add <linha CSV>" (ou "adicionar"): acrescenta uma partida
+ *   ("ID,Time1ID,Time2ID,Gols1,Gols2"); apenas no modo servidor
+ * 
+ * Linhas em branco e linhas iniciadas por '#' sao ignoradas.
+ * 
+ * Os comandos sao interpretados uma unica vez (consulta_parse) e depois
+ * executados em sequencia, com a saida indo para um escritor bufferizado.
+ */
+
+#ifndef CONSULTA_H
+#define CONSULTA_H
+
+#include <stdio.h>
+#include "bd_times.h"
+#include "bd_partidas.h"
+#include "escritor.h"
+
+/**
+ * Tipos de comando reconhecidos.
+ */
+typedef enum {
+    CONSULTA_TIME,             // Busca de times por prefixo
+    CONSULTA_INFIXO,           // Busca de times por trecho do nome
+    CONSULTA_APROX,            // Busca aproximada de times
+    CONSULTA_MANDANTE,         // Partidas por prefixo do mandante
+    CONSULTA_VISITANTE,        // Partidas por prefixo do visitante
+    CONSULTA_QUALQUER,         // Partidas por prefixo de qualquer time
+    CONSULTA_CONTA_MANDANTE,   // Numero de partidas por prefixo do mandante
+    CONSULTA_CONTA_VISITANTE,  // Numero de partidas por prefixo do visitante
+    CONSULTA_CONTA_QUALQUER,   // Numero de partidas por prefixo de qualquer time
+    CONSULTA_TABELA,           // Tabela de classificacao
+    CONSULTA_ESTATISTICAS,     // Metricas internas (metricas.h)
+    CONSULTA_MEMORIA,          // Memoria por subsistema (memoria.h)
+    CONSULTA_ADICIONAR         // Ingestao de uma partida (somente modo servidor)
+} TipoConsulta;
+
+/**
+ * Um comando ja interpretado.
+ * 
+ * 'arg' aponta para dentro da linha original (que deve continuar
+ * valida enquanto a consulta for usada). Para CONSULTA_TABELA,
+ * CONSULTA_ESTATISTICAS e CONSULTA_MEMORIA, 'arg' e uma string vazia.
+ */
+typedef struct {
+    TipoConsulta tipo;   // Tipo do comando
+    const char *arg;     // Prefixo (sem espacos nas pontas)
+} Consulta;
+
+/**
+ * Interpreta uma linha de comando.
+ * 
+ * A linha e modificada in-place (espacos removidos, terminadores inseridos).
+ * 
+ * @param linha Linha a interpretar (modificada)
+ * @param out Consulta resultante (apenas se retorno 1)
+ * @return 1 se a linha e um comando valido, 0 se e invalida,
+ *         -1 se e vazia ou comentario
+ */
+int consulta_parse(char *linha, Consulta *out);
+
+/**
+ * Executa uma consulta escrevendo o resultado no escritor.
+ * 
+ * Apenas leitura: CONSULTA_ADICIONAR nao e executada aqui (quem suporta
+ * ingestao, como o servidor, trata esse comando antes).
+ * 
+ * @param c Consulta a executar
+ * @param bdt Base de times
+ * @param bdp Base de partidas
+ * @param w Escritor de destino
+ */
+void consulta_executar(const Consulta *c, const BDTimes *bdt, const BDPartidas *bdp, Escritor *w);
+
+/**
+ * Executa em lote todos os comandos de um arquivo.
+ * 
+ * Le toda a entrada, interpreta cada linha uma unica vez e depois
+ * executa os comandos em sequencia. Linhas invalidas sao reportadas
+ * em stderr (com o numero da linha) e ignoradas.
+ * 
+ * @param in Arquivo de comandos (ex: stdin)
+ * @param bdt Base de times
+ * @param bdp Base de partidas
+ * @param w Escritor de destino
+ * @return Numero de comandos executados, ou -1 em caso de erro de leitura/memoria
+ */
+int consulta_executar_lote(FILE *in, const BDTimes *bdt, const BDPartidas *bdp, Escritor *w);
+
+#endif
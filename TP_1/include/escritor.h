@@ -0,0 +1,192 @@
+/**
+ * Header: escritor.h
+ *
+ * Define um escritor bufferizado para saida de alto volume.
+ *
+ * Este modulo oferece funcionalidades para:
+ * - Acumular a saida em um buffer interno e gravar em blocos grandes (fwrite)
+ * - Escrever strings, bytes, caracteres repetidos e inteiros sem printf
+ * - Escrever texto UTF-8 ajustado a uma largura fixa (tabelas alinhadas)
+ *
+ * Todas as rotinas de exportacao e listagem usam este escritor, de modo
+ * que a mesma logica serve para a tela (stdout), para arquivos e para
+ * memoria (respostas do modo servidor).
+ */
+
+#ifndef ESCRITOR_H
+#define ESCRITOR_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Tamanho do buffer interno do escritor (64 KiB por descarga)
+#define ESCRITOR_BUFFER 65536
+
+/**
+ * Estrutura que representa um escritor bufferizado.
+ *
+ * Os bytes sao acumulados em 'buf' e so sao gravados no FILE de destino
+ * quando o buffer enche ou quando escritor_descarregar() e chamada.
+ *
+ * No modo memoria (escritor_memoria), as descargas sao acumuladas em
+ * 'mem', que cresce conforme necessario, em vez de irem para um arquivo.
+ * 
+ * O campo 'erro' fica em 1 se alguma gravacao falhar; as escritas
+ * seguintes sao ignoradas e o erro e reportado ao fechar.
+ */
+typedef struct {
+    FILE *f;                     // Arquivo de destino (NULL no modo memoria)
+    char *mem;                   // Saida acumulada no modo memoria
+    size_t mem_len;              // Bytes validos em 'mem'
+    size_t mem_cap;              // Capacidade alocada de 'mem'
+    int proprio;                 // 1 se o escritor abriu o arquivo (e deve fecha-lo)
+    int erro;                    // 1 se alguma gravacao falhou
+    size_t len;                  // Numero de bytes pendentes no buffer
+    char buf[ESCRITOR_BUFFER];   // Buffer de saida
+} Escritor;
+
+// ========== Abertura e fechamento ==========
+
+/**
+ * Abre um arquivo para escrita bufferizada.
+ *
+ * O arquivo e aberto em modo binario ("wb") para que a saida seja
+ * identica em Windows e Linux.
+ *
+ * @param w Escritor a ser inicializado
+ * @param caminho Caminho do arquivo a criar/sobrescrever
+ * @return 1 se o arquivo foi aberto, 0 em caso de erro
+ */
+int escritor_abrir(Escritor *w, const char *caminho);
+
+/**
+ * Associa o escritor a um FILE ja aberto (ex: stdout).
+ *
+ * O FILE nao e fechado por escritor_fechar(), apenas descarregado.
+ *
+ * @param w Escritor a ser inicializado
+ * @param f Arquivo de destino
+ */
+void escritor_de_arquivo(Escritor *w, FILE *f);
+
+/**
+ * Inicializa o escritor no modo memoria.
+ * 
+ * A saida fica disponivel em escritor_conteudo() e a memoria e liberada
+ * por escritor_liberar(). O mesmo escritor pode ser reaproveitado entre
+ * varias saidas com escritor_limpar().
+ *
+ * @param w Escritor a ser inicializado
+ */
+void escritor_memoria(Escritor *w);
+
+/**
+ * Retorna a saida acumulada por um escritor no modo memoria.
+ *
+ * Descarrega o buffer interno antes de retornar.
+ *
+ * @param w Escritor no modo memoria
+ * @param len Onde o numero de bytes sera armazenado
+ * @return Ponteiro para os bytes (valido ate a proxima escrita)
+ */
+const char* escritor_conteudo(Escritor *w, size_t *len);
+
+/**
+ * Descarta a saida acumulada (modo memoria), mantendo a memoria alocada.
+ *
+ * @param w Escritor no modo memoria
+ */
+void escritor_limpar(Escritor *w);
+
+/**
+ * Libera a memoria de um escritor no modo memoria.
+ *
+ * @param w Escritor no modo memoria
+ */
+void escritor_liberar(Escritor *w);
+
+/**
+ * Grava no destino todos os bytes pendentes no buffer.
+ *
+ * @param w Escritor
+ * @return 1 se nao houve erro ate agora, 0 caso contrario
+ */
+int escritor_descarregar(Escritor *w);
+
+/**
+ * Descarrega o buffer e fecha o arquivo se ele foi aberto pelo escritor.
+ *
+ * @param w Escritor
+ * @return 1 se toda a saida foi gravada com sucesso, 0 caso contrario
+ */
+int escritor_fechar(Escritor *w);
+
+// ========== Escrita ==========
+
+/**
+ * Escreve 'n' bytes arbitrarios.
+ *
+ * @param w Escritor
+ * @param dados Bytes a escrever
+ * @param n Quantidade de bytes
+ */
+void escritor_bytes(Escritor *w, const void *dados, size_t n);
+
+/**
+ * Escreve uma string terminada em '\0' (sem o terminador).
+ *
+ * @param w Escritor
+ * @param s String a escrever
+ */
+void escritor_str(Escritor *w, const char *s);
+
+/**
+ * Escreve um unico caractere.
+ *
+ * @param w Escritor
+ * @param c Caractere a escrever
+ */
+void escritor_char(Escritor *w, char c);
+
+/**
+ * Escreve o caractere 'c' repetido 'n' vezes (preenchimento de colunas).
+ *
+ * @param w Escritor
+ * @param c Caractere de preenchimento
+ * @param n Numero de repeticoes (valores <= 0 nao escrevem nada)
+ */
+void escritor_repetir(Escritor *w, char c, int n);
+
+/**
+ * Escreve um inteiro em decimal, sem passar por printf.
+ *
+ * @param w Escritor
+ * @param v Valor a escrever
+ */
+void escritor_int(Escritor *w, int v);
+
+/**
+ * Escreve um inteiro alinhado a esquerda em uma coluna de largura fixa.
+ *
+ * Equivale a printf("%-*d", largura, v): completa com espacos a direita
+ * e nunca trunca o numero.
+ *
+ * @param w Escritor
+ * @param v Valor a escrever
+ * @param largura Largura minima da coluna
+ */
+void escritor_int_ajustado(Escritor *w, int v, int largura);
+
+/**
+ * Escreve uma string UTF-8 ajustada para uma largura visual fixa.
+ *
+ * Mesmo comportamento de print_utf8_padded(): completa com espacos
+ * ou trunca com '…' quando a string excede a largura.
+ *
+ * @param w Escritor
+ * @param s String UTF-8
+ * @param largura Largura visual desejada (em colunas)
+ */
+void escritor_utf8_ajustado(Escritor *w, const char *s, int largura);
+
+#endif
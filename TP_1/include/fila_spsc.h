@@ -0,0 +1,107 @@
+/**
+ * Header: fila_spsc.h
+ * 
+ * Define uma fila circular sem travas (lock-free) para exatamente um
+ * produtor e um consumidor (SPSC), usada para ligar a thread que le e
+ * interpreta o CSV de partidas a thread que agrega as estatisticas.
+ * 
+ * Cada posicao da fila carrega um lote de ate FILA_LOTE partidas, de modo
+ * que o custo de sincronizacao (duas operacoes atomicas) e dividido entre
+ * centenas de registros.
+ * 
+ * Uso (sem copias: os lotes sao preenchidos e lidos direto na fila):
+ *   Produtor:                          Consumidor:
+ *     LotePartidas *l = fila_reservar(f);  const LotePartidas *l = fila_frente(f);
+ *     ... preenche l->itens, l->n ...      ... usa l->itens[0..l->n) ...
+ *     fila_publicar(f);                    fila_consumir(f);
+ */
+
+#ifndef FILA_SPSC_H
+#define FILA_SPSC_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include "bd_partidas.h"
+
+// Numero de posicoes da fila (potencia de 2)
+#define FILA_SLOTS 64
+
+// Partidas por posicao (lote)
+#define FILA_LOTE 256
+
+/**
+ * Um lote de partidas ja interpretadas.
+ */
+typedef struct {
+    Partida itens[FILA_LOTE];  // Partidas do lote
+    int n;                     // Numero de partidas validas
+} LotePartidas;
+
+/**
+ * Fila circular SPSC.
+ * 
+ * 'cauda' e escrita apenas pelo produtor e 'cabeca' apenas pelo
+ * consumidor; cada uma fica em sua propria linha de cache para evitar
+ * falso compartilhamento.
+ */
+typedef struct {
+    LotePartidas slots[FILA_SLOTS];          // Posicoes da fila
+    _Alignas(64) atomic_size_t cabeca;       // Proxima posicao a consumir
+    _Alignas(64) atomic_size_t cauda;        // Proxima posicao a produzir
+    _Alignas(64) atomic_int fechada;         // 1 quando o produtor terminou
+    size_t pico;                             // Maior ocupacao observada (high-water mark)
+} FilaSPSC;
+
+/**
+ * Inicializa a fila vazia.
+ * 
+ * @param f Fila
+ */
+void fila_iniciar(FilaSPSC *f);
+
+/**
+ * (Produtor) Obtem a proxima posicao livre para preencher.
+ * 
+ * @param f Fila
+ * @return Lote a preencher, ou NULL se a fila esta cheia
+ */
+LotePartidas* fila_reservar(FilaSPSC *f);
+
+/**
+ * (Produtor) Publica o lote obtido em fila_reservar().
+ * 
+ * @param f Fila
+ */
+void fila_publicar(FilaSPSC *f);
+
+/**
+ * (Produtor) Indica que nao havera mais lotes.
+ * 
+ * @param f Fila
+ */
+void fila_fechar(FilaSPSC *f);
+
+/**
+ * (Consumidor) Obtem o proximo lote publicado.
+ * 
+ * @param f Fila
+ * @return Lote a consumir, ou NULL se a fila esta vazia no momento
+ */
+const LotePartidas* fila_frente(FilaSPSC *f);
+
+/**
+ * (Consumidor) Libera o lote obtido em fila_frente().
+ * 
+ * @param f Fila
+ */
+void fila_consumir(FilaSPSC *f);
+
+/**
+ * (Consumidor) Verifica se o produtor terminou e a fila esvaziou.
+ * 
+ * @param f Fila
+ * @return 1 se nao ha mais lotes a consumir
+ */
+int fila_terminou(FilaSPSC *f);
+
+#endif
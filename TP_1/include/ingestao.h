@@ -0,0 +1,46 @@
+/**
+ * Header: ingestao.h
+ * 
+ * Define a carga de partidas em pipeline: uma thread leitora/parser
+ * interpreta o CSV e envia lotes de partidas, por uma fila SPSC sem travas
+ * (fila_spsc.h), a thread agregadora, que armazena as partidas e atualiza
+ * as estatisticas dos times. Leitura, parsing e agregacao ficam sobrepostos.
+ * 
+ * O resultado e identico a bdpartidas_carregar_csv() seguido de
+ * bdpartidas_aplicar_em_bdtimes(): as partidas sao agregadas na ordem
+ * do arquivo.
+ */
+
+#ifndef INGESTAO_H
+#define INGESTAO_H
+
+#include <stddef.h>
+#include "bd_times.h"
+#include "bd_partidas.h"
+
+/**
+ * Estatisticas de uma carga em pipeline (para ajuste da fila).
+ */
+typedef struct {
+    int carregadas;          // Partidas armazenadas na base
+    int ignoradas;           // Linhas rejeitadas pelo parser
+    size_t lotes;            // Lotes que passaram pela fila
+    size_t pico_fila;        // Maior numero de lotes na fila ao mesmo tempo
+    size_t capacidade_fila;  // Capacidade da fila (FILA_SLOTS)
+} EstatIngestao;
+
+/**
+ * Carrega as partidas de um CSV e aplica os resultados nos times.
+ * 
+ * A thread chamadora faz o papel de agregadora; uma thread auxiliar le
+ * e interpreta o arquivo.
+ * 
+ * @param bdp Base de partidas onde as partidas serao armazenadas
+ * @param bdt Base de times cujas estatisticas serao atualizadas
+ * @param caminho Caminho do arquivo CSV de partidas
+ * @param est Estatisticas da carga (pode ser NULL)
+ * @return Numero de partidas carregadas, ou 0 se houver erro ao abrir
+ */
+int ingestao_carregar_partidas(BDPartidas *bdp, BDTimes *bdt, const char *caminho, EstatIngestao *est);
+
+#endif
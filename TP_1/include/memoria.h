@@ -0,0 +1,117 @@
+/**
+ * Header: memoria.h
+ *
+ * Define os alocadores com etiqueta (tag) usados por todo o sistema.
+ *
+ * Este modulo oferece funcionalidades para:
+ * - Alocar, realocar e liberar memoria marcando o subsistema dono
+ *   (times, partidas, indices, caches, versoes, servidor, ...)
+ * - Contabilizar, por subsistema, os bytes reservados, o pico e o numero
+ *   de blocos vivos, para dimensionar os containers pelo tamanho dos dados
+ *
+ * Cada bloco carrega um pequeno cabecalho com o tamanho e a etiqueta, de
+ * modo que mem_liberar() nao precisa saber nem o tamanho nem o dono.
+ * Memoria obtida aqui deve ser liberada com mem_liberar(), nunca com free().
+ */
+
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <stddef.h>
+
+/**
+ * Subsistemas contabilizados.
+ */
+typedef enum {
+    MEM_TIMES,        // Arrays de times (BDTimes), em todas as versoes
+    MEM_PARTIDAS,     // Arrays de partidas (BDPartidas), em todas as versoes
+    MEM_INDICES,      // Indices e vetores de resultado (ordem por ID, marcas, buscas)
+    MEM_CACHES,       // Caches de consulta
+    MEM_VERSOES,      // Descritores das versoes da base (modo servidor)
+    MEM_FILA,         // Fila de lotes da carga em pipeline
+    MEM_ESCRITORES,   // Escritores bufferizados e suas saidas em memoria
+    MEM_CONSULTAS,    // Comandos do modo batch (texto e vetor de consultas)
+    MEM_SERVIDOR,     // Conexoes, buffers e threads do servidor
+    MEM_METRICAS,     // Blocos de metricas por thread
+    MEM_API,          // Instancias da biblioteca (campeonato.h)
+    MEM_TOTAL         // Numero de subsistemas
+} TagMemoria;
+
+/**
+ * Contabilidade de um subsistema.
+ */
+typedef struct {
+    size_t reservado;   // Bytes alocados e ainda nao liberados
+    size_t pico;        // Maior valor de 'reservado' ja observado
+    size_t blocos;      // Blocos vivos
+    size_t alocacoes;   // Total de alocacoes/realocacoes feitas
+} EstatMemoria;
+
+/**
+ * Aloca 'n' bytes para um subsistema (como malloc).
+ *
+ * @param tag Subsistema dono
+ * @param n Tamanho em bytes
+ * @return Ponteiro para a memoria, ou NULL se faltou memoria
+ */
+void* mem_alocar(TagMemoria tag, size_t n);
+
+/**
+ * Aloca 'n' bytes alinhados a 'alinhamento' (como aligned_alloc), para
+ * estruturas com membros _Alignas maiores que o de malloc.
+ *
+ * mem_realocar() preserva o alinhamento do bloco.
+ *
+ * @param tag Subsistema dono
+ * @param alinhamento Potencia de 2
+ * @param n Tamanho em bytes
+ * @return Ponteiro para a memoria, ou NULL se faltou memoria
+ */
+void* mem_alocar_alinhada(TagMemoria tag, size_t alinhamento, size_t n);
+
+/**
+ * Aloca 'qtd' elementos de 'tam' bytes zerados (como calloc).
+ *
+ * @param tag Subsistema dono
+ * @param qtd Numero de elementos
+ * @param tam Tamanho de cada elemento
+ * @return Ponteiro para a memoria, ou NULL se faltou memoria (ou overflow)
+ */
+void* mem_zerada(TagMemoria tag, size_t qtd, size_t tam);
+
+/**
+ * Muda o tamanho de um bloco (como realloc). Com p == NULL, aloca.
+ *
+ * Em caso de falha o bloco original continua valido. Blocos de
+ * mem_alocar_alinhada() sao copiados para um novo bloco com o mesmo
+ * alinhamento.
+ *
+ * @param tag Subsistema dono (o mesmo da alocacao original)
+ * @param p Bloco obtido deste modulo, ou NULL
+ * @param n Novo tamanho em bytes
+ * @return Ponteiro para o bloco (possivelmente movido), ou NULL se faltou memoria
+ */
+void* mem_realocar(TagMemoria tag, void *p, size_t n);
+
+/**
+ * Libera um bloco obtido deste modulo. Aceita NULL.
+ *
+ * @param p Bloco a liberar
+ */
+void mem_liberar(void *p);
+
+/**
+ * Le a contabilidade de um subsistema.
+ *
+ * @param tag Subsistema
+ * @param out Estatisticas
+ */
+void mem_estatisticas(TagMemoria tag, EstatMemoria *out);
+
+/**
+ * @param tag Subsistema
+ * @return Nome do subsistema para relatorios
+ */
+const char* mem_nome(TagMemoria tag);
+
+#endif
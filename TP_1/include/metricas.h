@@ -0,0 +1,201 @@
+/**
+ * Header: metricas.h
+ *
+ * Define os contadores e temporizadores internos do sistema.
+ *
+ * Este modulo oferece funcionalidades para:
+ * - Contar eventos dos caminhos quentes (linhas lidas/rejeitadas, bytes,
+ *   buscas, partidas agregadas, acertos dos contadores de partidas)
+ * - Acumular o tempo gasto em cada etapa (carga, agregacao, busca, saida)
+ * - Registrar a latencia de cada consulta em histogramas log-lineares
+ *   (estilo HDR) por tipo de consulta, com p50/p90/p99/p999
+ * - Somar os contadores de todas as threads e escrever um relatorio
+ *
+ * Cada thread escreve apenas no seu proprio bloco de contadores
+ * (_Thread_local), sem travas nem instrucoes atomicas de leitura-escrita:
+ * um incremento custa uma carga e um armazenamento comuns. Os blocos sao
+ * registrados em uma lista global na primeira escrita de cada thread e
+ * somados apenas quando alguem le as metricas. Os blocos sobrevivem ao
+ * fim da thread, de modo que o trabalho de threads ja encerradas (ex: o
+ * parser da ingestao) continua contado.
+ */
+
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdatomic.h>
+#include "escritor.h"
+#include "rastro.h"
+
+/**
+ * Metricas coletadas. As de prefixo MET_NS_ sao tempos em nanossegundos.
+ */
+typedef enum {
+    MET_LINHAS_LIDAS,          // Linhas de dados lidas dos CSVs (sem cabecalho)
+    MET_LINHAS_REJEITADAS,     // Linhas descartadas pelo parser
+    MET_BYTES_LIDOS,           // Bytes lidos dos CSVs
+    MET_PARTIDAS_AGREGADAS,    // Partidas aplicadas nas estatisticas dos times
+    MET_BUSCAS_TIMES,          // Buscas de times por prefixo
+    MET_BUSCAS_PARTIDAS,       // Buscas/listagens de partidas por prefixo
+    MET_CONTAGENS_RAPIDAS,     // Contagens respondidas pelos contadores dos times
+    MET_CONTAGENS_LISTAS,      // Contagens que percorreram as listas dos visitantes
+    MET_BYTES_ESCRITOS,        // Bytes gravados pelos escritores
+    MET_NS_CARGA_TIMES,        // Tempo de carga do CSV de times
+    MET_NS_CARGA_PARTIDAS,     // Tempo de leitura e parsing do CSV de partidas
+    MET_NS_AGREGACAO,          // Tempo aplicando partidas nos times
+    MET_NS_BUSCA,              // Tempo nas buscas (times e partidas)
+    MET_NS_SAIDA,              // Tempo formatando listagens e tabelas
+    MET_TOTAL                  // Numero de metricas
+} Metrica;
+
+/**
+ * Tipos de consulta com histograma de latencia.
+ */
+typedef enum {
+    LAT_BUSCA_TIMES,           // bdtimes_buscar_por_prefixo
+    LAT_BUSCA_APROX,           // bdtimes_buscar_aproximado
+    LAT_BUSCA_INFIXO,          // bdtimes_buscar_infixo
+    LAT_BUSCA_LOTE,            // bdtimes_buscar_prefixos (o lote inteiro)
+    LAT_LISTAR_MANDANTE,       // Listagem de partidas por mandante (busca + saida)
+    LAT_LISTAR_VISITANTE,      // Listagem de partidas por visitante (busca + saida)
+    LAT_LISTAR_QUALQUER,       // Listagem de partidas por qualquer time (busca + saida)
+    LAT_CONTAGEM,              // bdpartidas_contar_por_prefixo
+    LAT_CLASSIFICACAO,         // Tabela de classificacao
+    LAT_TOTAL                  // Numero de tipos
+} TipoLatencia;
+
+// Histograma log-linear: valores (ns) abaixo de HIST_SUB ficam em baldes
+// exatos; acima, cada potencia de 2 e dividida em HIST_SUB baldes iguais,
+// o que limita o erro relativo a 1/HIST_SUB (~3%). Latencias acima de
+// 2^(HIST_MAGNITUDES + 4) ns (~68 s) caem no ultimo balde.
+#define HIST_SUB 32
+#define HIST_MAGNITUDES 32
+#define HIST_BALDES (HIST_SUB * HIST_MAGNITUDES)
+
+/**
+ * Histograma de latencias de um tipo de consulta (em uma thread).
+ */
+typedef struct {
+    atomic_ullong baldes[HIST_BALDES];   // Contagem por balde
+    atomic_ullong max;                   // Maior latencia registrada (ns)
+} HistLatencia;
+
+/**
+ * Bloco de contadores de uma thread.
+ *
+ * Os contadores sao atomicos apenas para que a leitura por outra thread
+ * seja bem definida; a thread dona usa cargas e armazenamentos relaxados.
+ * Os histogramas ficam no proprio bloco (alocado uma vez por thread),
+ * de modo que registrar uma latencia nunca aloca memoria.
+ */
+typedef struct BlocoMetricas {
+    atomic_ullong v[MET_TOTAL];        // Valor de cada metrica
+    HistLatencia lat[LAT_TOTAL];       // Histograma de cada tipo de consulta
+    struct BlocoMetricas *prox;        // Proximo bloco na lista global
+} BlocoMetricas;
+
+// Bloco da thread atual (NULL ate a primeira metrica registrada)
+extern _Thread_local BlocoMetricas *metricas_local;
+
+/**
+ * Cria e registra o bloco de contadores da thread atual.
+ *
+ * Chamada automaticamente por metricas_somar() na primeira vez.
+ *
+ * @return Bloco da thread, ou NULL se faltou memoria
+ */
+BlocoMetricas* metricas_registrar_thread(void);
+
+/**
+ * Soma um valor a uma metrica da thread atual.
+ *
+ * @param m Metrica
+ * @param v Valor a somar (quantidade de eventos, bytes ou nanossegundos)
+ */
+static inline void metricas_somar(Metrica m, unsigned long long v) {
+    BlocoMetricas *b = metricas_local;
+    if (!b && !(b = metricas_registrar_thread())) return;
+    unsigned long long atual = atomic_load_explicit(&b->v[m], memory_order_relaxed);
+    atomic_store_explicit(&b->v[m], atual + v, memory_order_relaxed);
+}
+
+/**
+ * @return Instante atual em nanossegundos (relogio monotonico)
+ */
+unsigned long long metricas_agora_ns(void);
+
+/**
+ * Grava no rastro (rastro.h) o intervalo de uma etapa, com o nome da
+ * metrica e a categoria da etapa (carga, parse, agregacao, busca, saida).
+ *
+ * @param m Metrica MET_NS_*
+ * @param inicio Instante inicial (ns)
+ * @param dt Duracao (ns)
+ */
+void metricas_rastrear(Metrica m, unsigned long long inicio, unsigned long long dt);
+
+/**
+ * Soma o tempo decorrido desde 'inicio' a uma metrica de tempo.
+ *
+ * Com o rastro ligado (--trace), o intervalo tambem vira um evento.
+ *
+ * @param m Metrica MET_NS_*
+ * @param inicio Instante obtido com metricas_agora_ns()
+ * @return Tempo decorrido em ns (para registrar tambem como latencia)
+ */
+static inline unsigned long long metricas_tempo(Metrica m, unsigned long long inicio) {
+    unsigned long long dt = metricas_agora_ns() - inicio;
+    metricas_somar(m, dt);
+    if (rastro_ativo) metricas_rastrear(m, inicio, dt);
+    return dt;
+}
+
+/**
+ * Registra a latencia de uma consulta no histograma da thread atual.
+ *
+ * Sem travas e sem alocacao (exceto o registro do bloco na primeira
+ * metrica da thread).
+ *
+ * @param tipo Tipo da consulta
+ * @param ns Latencia em nanossegundos
+ */
+void metricas_latencia(TipoLatencia tipo, unsigned long long ns);
+
+/**
+ * Resumo de um histograma de latencias (todas as threads).
+ */
+typedef struct {
+    unsigned long long n;      // Numero de consultas registradas
+    unsigned long long p50;    // Percentis (ns, limite superior do balde)
+    unsigned long long p90;
+    unsigned long long p99;
+    unsigned long long p999;
+    unsigned long long max;    // Maior latencia (ns, exata)
+} ResumoLatencia;
+
+/**
+ * Calcula o resumo de latencias de um tipo de consulta.
+ *
+ * @param tipo Tipo da consulta
+ * @param out Resumo (zerado se nao houver registros)
+ */
+void metricas_resumo_latencia(TipoLatencia tipo, ResumoLatencia *out);
+
+/**
+ * Le o total de cada metrica, somando os blocos de todas as threads.
+ *
+ * Os valores de threads ainda em atividade podem estar no meio de uma
+ * atualizacao (cada contador e lido atomicamente, mas nao o conjunto).
+ *
+ * @param total Array de MET_TOTAL posicoes que recebe as somas
+ */
+void metricas_ler(unsigned long long total[MET_TOTAL]);
+
+/**
+ * Escreve o relatorio das metricas (uma por linha) em um escritor.
+ *
+ * @param w Escritor de destino
+ */
+void metricas_escrever(Escritor *w);
+
+#endif
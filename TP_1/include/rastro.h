@@ -0,0 +1,66 @@
+/**
+ * Header: rastro.h
+ *
+ * Define o rastro de execucao (trace) no formato JSON do Chrome.
+ *
+ * Este modulo oferece funcionalidades para:
+ * - Gravar, com --trace <arquivo>, um evento por etapa executada (carga,
+ *   parse, agregacao, busca, saida) e por consulta, com inicio e duracao
+ * - Nomear as threads (principal, parser, trabalhadoras) no rastro
+ *
+ * O arquivo abre em chrome://tracing, no Perfetto (ui.perfetto.dev) ou em
+ * qualquer visualizador que aceite o "Trace Event Format". Os marcadores
+ * ficam nos mesmos pontos que ja medem os tempos de metricas.h, de modo
+ * que a linha do tempo e o relatorio de estatisticas contam a mesma
+ * historia.
+ *
+ * Com o rastro desligado (padrao), cada marcador custa apenas o teste de
+ * 'rastro_ativo'. Com ele ligado, os eventos sao gravados sob uma trava:
+ * o rastro serve para entender uma execucao, nao para producao.
+ */
+
+#ifndef RASTRO_H
+#define RASTRO_H
+
+// 1 depois de rastro_abrir() (escrito antes de criar qualquer thread)
+extern int rastro_ativo;
+
+/**
+ * Abre o arquivo de rastro e marca o instante zero da linha do tempo.
+ *
+ * O arquivo e fechado automaticamente ao encerrar o programa (atexit).
+ * A thread que abre o rastro e nomeada "principal".
+ *
+ * @param caminho Arquivo de destino (.json)
+ * @return 1 se sucesso, 0 se nao foi possivel criar o arquivo
+ */
+int rastro_abrir(const char *caminho);
+
+/**
+ * Da nome a thread atual na linha do tempo.
+ *
+ * @param nome Nome exibido pelo visualizador
+ */
+void rastro_nomear_thread(const char *nome);
+
+/**
+ * Grava um evento com inicio e duracao na thread atual.
+ *
+ * @param nome Nome do evento
+ * @param categoria Categoria (etapa) do evento
+ * @param inicio_ns Inicio, obtido com metricas_agora_ns()
+ * @param dur_ns Duracao em nanossegundos
+ * @param arg Argumento exibido junto com o evento (ex: o prefixo buscado), ou NULL
+ */
+void rastro_evento(const char *nome, const char *categoria,
+                   unsigned long long inicio_ns, unsigned long long dur_ns,
+                   const char *arg);
+
+/**
+ * Fecha o arquivo de rastro, completando o JSON.
+ *
+ * @return 1 se o arquivo foi gravado sem erros, 0 caso contrario
+ */
+int rastro_fechar(void);
+
+#endif
@@ -0,0 +1,49 @@
+/**
+ * Header: servidor.h
+ * 
+ * Define o modo servidor: o programa carrega os dados uma unica vez e
+ * responde consultas de clientes locais por um socket de dominio UNIX.
+ * 
+ * Protocolo (mensagens com prefixo de tamanho):
+ * - Requisicao: u32 big-endian com o tamanho N, seguido de N bytes com um
+ *   comando no mesmo formato do modo batch ("team Fla", "home Cor", "table")
+ * - Resposta: u32 big-endian com o tamanho M, seguido de M bytes com o
+ *   texto produzido pelo comando (o mesmo que o modo batch escreveria)
+ * 
+ * Um cliente pode enviar varias requisicoes pela mesma conexao; as
+ * respostas chegam na mesma ordem.
+ * 
+ * O comando "add <linha CSV>" acrescenta uma partida enquanto outras
+ * consultas continuam sendo atendidas: as consultas leem instantaneos
+ * imutaveis da base versionada (bd_versoes.h), sem travas.
+ * 
+ * Arquitetura: uma thread com laco de eventos epoll aceita conexoes e
+ * detecta dados disponiveis; um conjunto fixo de threads trabalhadoras
+ * le, executa e responde as requisicoes. Disponivel apenas no Linux.
+ */
+
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include "bd_versoes.h"
+
+// Numero padrao de threads trabalhadoras
+#define SERVIDOR_WORKERS_PADRAO 4
+
+// Tamanho maximo aceito para uma requisicao (em bytes)
+#define SERVIDOR_MAX_REQUISICAO 4096
+
+/**
+ * Executa o servidor ate receber SIGINT ou SIGTERM.
+ * 
+ * Cada trabalhadora e registrada como leitora da base versionada; as
+ * consultas usam a versao publicada no momento em que comecam.
+ * 
+ * @param caminho_socket Caminho do socket UNIX (arquivo existente e substituido)
+ * @param n_workers Numero de threads trabalhadoras (1 a MAX_LEITORES)
+ * @param bv Base versionada ja inicializada
+ * @return 0 se encerrou normalmente, 1 em caso de erro
+ */
+int servidor_executar(const char *caminho_socket, int n_workers, BDVersionada *bv);
+
+#endif
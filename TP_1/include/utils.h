@@ -8,6 +8,7 @@
  * - Manipulacao de strings (trim, lowercase, prefixos)
  * - Leitura segura de entrada do usuario
  * - Conversao segura de strings para inteiros
+ * - Tokenizacao reentrante de linhas CSV (cursor de campos)
  * - Tratamento correto de texto UTF-8 (contagem de caracteres, alinhamento)
  * 
  * As funcoes UTF-8 sao essenciais para exibir nomes de times que podem
@@ -106,29 +107,194 @@ void pause_prompt(void);
  */
 int safe_atoi(const char *s, int *out);
 
+/**
+ * Converte um trecho de 'n' bytes (nao necessariamente terminado em '\0')
+ * para inteiro, com as mesmas regras de safe_atoi().
+ * 
+ * @param s Inicio do trecho
+ * @param n Numero de bytes do trecho
+ * @param out Ponteiro onde o valor convertido sera armazenado (apenas se sucesso)
+ * @return 1 se a conversao foi bem sucedida, 0 se houver erro
+ */
+int safe_atoi_n(const char *s, size_t n, int *out);
+
+// ========== Tokenizacao reentrante de CSV ==========
+
+/**
+ * Cursor sobre os campos de uma linha CSV.
+ * 
+ * Substitui strtok(): todo o estado fica na propria estrutura (e nao em
+ * uma variavel global escondida), e a linha original nao e modificada.
+ * Assim varias threads podem interpretar linhas ao mesmo tempo.
+ * 
+ * Uso:
+ *   CursorCSV c;
+ *   cursor_iniciar(&c, linha, strlen(linha));
+ *   const char *campo; size_t len;
+ *   while (cursor_proximo(&c, &campo, &len)) { ... }
+ */
+typedef struct {
+    const char *p;    // Inicio do proximo campo
+    const char *fim;  // Fim da linha (exclusivo)
+    int acabou;       // 1 depois que o ultimo campo foi entregue
+} CursorCSV;
+
+/**
+ * Inicializa um cursor sobre os 'len' primeiros bytes de uma linha.
+ * 
+ * Quebras de linha ('\n', '\r') no final sao ignoradas.
+ * 
+ * @param c Cursor a inicializar
+ * @param linha Inicio da linha
+ * @param len Numero de bytes da linha
+ */
+void cursor_iniciar(CursorCSV *c, const char *linha, size_t len);
+
+/**
+ * Avanca para o proximo campo separado por virgula.
+ * 
+ * O campo retornado nao inclui a virgula nem espacos nas pontas.
+ * Campos vazios (",,") sao retornados com len = 0.
+ * 
+ * @param c Cursor
+ * @param campo Onde o inicio do campo sera armazenado
+ * @param len Onde o tamanho do campo sera armazenado
+ * @return 1 se um campo foi lido, 0 se a linha terminou
+ */
+int cursor_proximo(CursorCSV *c, const char **campo, size_t *len);
+
 // ========== Funcoes para manipulacao de UTF-8 ==========
 
 /**
- * Calcula a largura visual de uma string UTF-8.
+ * Conta os code points de uma string UTF-8.
  * 
  * Retorna o numero de code points (caracteres) na string, contando
  * corretamente caracteres multi-byte UTF-8.
  * 
  * IMPORTANTE: Esta funcao conta code points, nao bytes. Por exemplo:
  * - "abc" tem 3 code points (3 bytes)
- * - "ção" tem 4 code points (5 bytes, pois 'ç' e 'ã' usam 2 bytes cada)
+ * - "ção" tem 3 code points (5 bytes, pois 'ç' e 'ã' usam 2 bytes cada)
  * 
- * Limitacoes: Nao lida com caracteres combinados (combining characters)
+ * Para alinhar texto na tela use utf8_largura(), que conta colunas.
  * 
  * @param s String UTF-8 a ser medida
- * @return Numero de code points (largura visual) da string
+ * @return Numero de code points da string
  */
 int utf8_len(const char *s);
 
+/**
+ * Calcula a largura de exibicao de uma string UTF-8, em colunas do
+ * terminal.
+ * 
+ * Marcas combinantes e caracteres de formato (ex: acento agudo U+0301,
+ * ZWJ) ocupam 0 colunas; ideogramas, hangul, kana e emojis (East Asian
+ * Width W/F), 2; os demais, 1. As larguras vem de tabelas de dois niveis
+ * geradas no build a partir de tools/larguras_unicode.txt (Unicode 14.0).
+ * 
+ * Limitacao: sequencias de emoji unidas por ZWJ contam a soma das partes.
+ * 
+ * @param s String UTF-8 a ser medida
+ * @return Colunas ocupadas no terminal
+ */
+int utf8_largura(const char *s);
+
+/**
+ * Versao de utf8_largura() para os 'n' primeiros bytes de um texto.
+ * 
+ * @param s Texto UTF-8 (nao precisa terminar em '\0')
+ * @param n Numero de bytes
+ * @return Colunas ocupadas no terminal
+ */
+int utf8_largura_n(const char *s, size_t n);
+
+/**
+ * Mede o maior prefixo de uma string que cabe em uma largura.
+ * 
+ * Usada para truncar nomes sem cortar caracteres multi-byte ao meio.
+ * 
+ * @param s String UTF-8
+ * @param largura Largura maxima (colunas, como em utf8_largura())
+ * @param max_bytes Numero maximo de bytes
+ * @param usada Recebe a largura do prefixo, que fica uma coluna abaixo de
+ *              'largura' quando um caractere largo nao coube (pode ser NULL)
+ * @return Bytes do prefixo
+ */
+int utf8_prefixo_bytes(const char *s, int largura, int max_bytes, int *usada);
+
+/**
+ * Decodifica uma string UTF-8 em code points "dobrados" para comparacao
+ * aproximada (busca tolerante a erros de digitacao).
+ * 
+ * Letras ASCII ficam em minuscula e as letras latinas acentuadas de
+ * U+00C0 a U+00FF viram a letra base (ex: "São" -> "sao"); os demais
+ * code points sao mantidos. Bytes invalidos viram U+FFFD.
+ * 
+ * @param s String UTF-8
+ * @param cps Destino dos code points
+ * @param max Capacidade de 'cps'
+ * @return Numero de code points gravados (no maximo 'max')
+ */
+int utf8_dobrar(const char *s, unsigned int *cps, int max);
+
+/**
+ * Versao de utf8_dobrar() que devolve o texto dobrado em UTF-8
+ * (ex: "São Paulo" -> "sao paulo"). Bytes invalidos viram U+FFFD, de
+ * modo que o resultado pode ter mais bytes que a entrada.
+ * 
+ * @param s String UTF-8
+ * @param dst Destino (terminado em '\0')
+ * @param cap Capacidade de 'dst' em bytes (pelo menos 1)
+ * @return Bytes gravados (sem o '\0')
+ */
+int utf8_dobrar_str(const char *s, char *dst, int cap);
+
+/**
+ * Implementacoes da contagem de code points.
+ */
+typedef enum {
+    UTF8_ESCALAR,   // Byte a byte (portavel)
+    UTF8_SSE2,      // 16 bytes por vez (x86)
+    UTF8_AVX2       // 32 bytes por vez (x86 com AVX2)
+} ImplUtf8;
+
+/**
+ * Conta os code points dos 'n' primeiros bytes de um texto UTF-8.
+ * 
+ * Conta os bytes que nao sao de continuacao (10xxxxxx), usando a
+ * implementacao vetorizada mais rapida que o processador suporta
+ * (detectada na primeira chamada). Textos curtos (< 16 bytes) vao
+ * direto para a versao escalar.
+ * 
+ * @param s Texto UTF-8 (nao precisa terminar em '\0')
+ * @param n Numero de bytes
+ * @return Numero de code points
+ */
+size_t utf8_contar(const char *s, size_t n);
+
+/**
+ * @return Implementacao usada por utf8_contar() e utf8_len()
+ */
+ImplUtf8 utf8_impl_atual(void);
+
+/**
+ * Forca uma implementacao da contagem (benchmarks e comparacoes).
+ * 
+ * @param impl Implementacao desejada
+ * @return 1 se selecionada, 0 se o processador nao a suporta
+ */
+int utf8_usar_impl(ImplUtf8 impl);
+
+/**
+ * @param impl Implementacao
+ * @return Nome da implementacao ("escalar", "sse2", "avx2")
+ */
+const char* utf8_nome_impl(ImplUtf8 impl);
+
 /**
  * Imprime uma string UTF-8 ajustada para uma largura fixa.
  * 
- * Esta funcao garante que a saida ocupe exatamente 'width' code points:
+ * Esta funcao garante que a saida ocupe exatamente 'width' colunas
+ * (medidas por utf8_largura()):
  * - Se a string e mais curta: preenche com espacos a direita
  * - Se a string e mais longa: trunca e adiciona '...' (ellipsis)
  * - Se a string tem exatamente width: imprime como esta
@@ -138,11 +304,26 @@ int utf8_len(const char *s);
  * Exemplos (width=10):
  * - "Fla" -> "Fla       " (7 espacos adicionados)
  * - "Flamengo" -> "Flamengo  " (2 espacos adicionados)
- * - "Independiente" -> "Independen..." (truncado com ellipsis)
+ * - "Independiente" -> "Independi…" (truncado com ellipsis)
+ * - "北京国安足球俱乐部" -> "北京国安 …" (ideogramas ocupam duas colunas)
  * 
  * @param s String UTF-8 a ser impressa
- * @param width Largura visual desejada (em code points)
+ * @param width Largura visual desejada (em colunas)
  */
 void print_utf8_padded(const char *s, int width);
 
+/**
+ * Formata uma string UTF-8 ajustada para uma largura fixa em um buffer.
+ * 
+ * Versao de print_utf8_padded() que escreve em memoria, usada pelos
+ * escritores bufferizados. O resultado sempre termina com '\0'.
+ * 
+ * @param dst Buffer de destino
+ * @param cap Capacidade do buffer em bytes
+ * @param s String UTF-8 a ser ajustada
+ * @param width Largura visual desejada (em colunas)
+ * @return Numero de bytes escritos em dst (sem contar '\0')
+ */
+int utf8_ajustar(char *dst, int cap, const char *s, int width);
+
 #endif
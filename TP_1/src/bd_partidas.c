@@ -8,14 +8,16 @@
  * - Aplicar resultados das partidas nas estatisticas dos times
  * - Listar partidas filtradas por time (mandante, visitante ou ambos)
  * 
- * O sistema usa uma base de dados em memoria (BDPartidas) que armazena ate MAX_PARTIDAS
- * partidas simultaneamente. Cada partida conecta dois times e registra o placar.
+ * O sistema usa uma base de dados em memoria (BDPartidas) com as partidas em
+ * pedacos de tamanho fixo, alocados conforme o arquivo e lido. Cada partida conecta dois times e registra o placar.
  * 
  * Este modulo trabalha em conjunto com bd_times.c, atualizando as estatisticas
  * dos times baseado nos resultados das partidas carregadas.
  */
 
 #include "bd_partidas.h"
+#include "memoria.h"
+#include "metricas.h"
 #include "utils.h"
 #include <stdio.h>
 #include <string.h>
@@ -32,35 +34,141 @@
  */
 void bdpartidas_init(BDPartidas *bd) {
     // Inicializa com zero registros carregados
-    // O array de partidas existe mas nenhum elemento e considerado valido ainda
+    // Os pedacos so sao alocados quando as partidas forem adicionadas
+    bd->pedacos = NULL;
     bd->n = 0;
+    bd->cap_pedacos = 0;
 }
 
 /**
- * Remove caracteres de nova linha do final de uma string.
+ * @param bd Ponteiro para a estrutura BDPartidas
+ * @return Numero de pedacos em uso (os que tem alguma das 'n' partidas)
+ */
+static int pedacos_usados(const BDPartidas *bd) {
+    return (bd->n + PARTIDAS_POR_PEDACO - 1) >> BITS_PEDACO_PARTIDAS;
+}
+
+/**
+ * Libera a memoria de uma base de partidas.
  * 
- * Esta funcao auxiliar limpa o final de strings lidas com fgets(),
- * removendo caracteres '\n' e '\r' que geralmente ficam anexados.
- * A string e modificada in-place.
+ * Pedacos compartilhados com outras bases ficam com elas.
  * 
- * @param s String a ser limpa (modificada diretamente)
+ * @param bd Ponteiro para a estrutura BDPartidas
  */
-static void chomp(char *s) {
-    // Obtem o tamanho atual da string
-    size_t n = strlen(s);
-    
-    // Remove caracteres de nova linha do final da string
-    // Percorre de tras para frente enquanto encontrar '\n' ou '\r'
-    while (n > 0 && (s[n - 1] == '\n' || s[n - 1] == '\r')) {
-        s[--n] = '\0';  // Substitui o caractere por terminador nulo
+void bdpartidas_liberar(BDPartidas *bd) {
+    int usados = pedacos_usados(bd);
+    for (int p = 0; p < usados; p++) {
+        if (--bd->pedacos[p]->refs == 0) mem_liberar(bd->pedacos[p]);
+    }
+    mem_liberar(bd->pedacos);
+    bdpartidas_init(bd);
+}
+
+/**
+ * Acrescenta uma partida ao final da base.
+ * 
+ * Um pedaco novo e alocado a cada PARTIDAS_POR_PEDACO partidas; o array
+ * de pedacos dobra a cada realocacao. As partidas ja armazenadas nunca
+ * sao movidas.
+ * 
+ * @param bd Ponteiro para a estrutura BDPartidas
+ * @param p Partida a acrescentar
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_adicionar(BDPartidas *bd, const Partida *p) {
+    if ((bd->n & (PARTIDAS_POR_PEDACO - 1)) == 0) {
+        int usados = pedacos_usados(bd);
+        if (usados == bd->cap_pedacos) {
+            int cap = bd->cap_pedacos ? bd->cap_pedacos * 2 : 4;
+            PedacoPartidas **novo = mem_realocar(MEM_PARTIDAS, bd->pedacos,
+                                                 (size_t)cap * sizeof(PedacoPartidas*));
+            if (!novo) return 0;
+            bd->pedacos = novo;
+            bd->cap_pedacos = cap;
+        }
+        PedacoPartidas *pedaco = mem_alocar(MEM_PARTIDAS, sizeof(PedacoPartidas));
+        if (!pedaco) return 0;
+        pedaco->refs = 1;
+        bd->pedacos[usados] = pedaco;
     }
+    *bdpartidas_partida(bd, bd->n++) = *p;
+    return 1;
+}
+
+/**
+ * Copia uma base de partidas.
+ * 
+ * Copia profunda: pedacos novos, sem nada em comum com a origem (ver
+ * bdpartidas_compartilhar() para o contrario).
+ * 
+ * @param dst Base de destino (nao precisa estar inicializada)
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_copiar(BDPartidas *dst, const BDPartidas *src) {
+    bdpartidas_init(dst);
+    int usados = pedacos_usados(src);
+    if (usados == 0) return 1;
+
+    dst->pedacos = mem_alocar(MEM_PARTIDAS, (size_t)usados * sizeof(PedacoPartidas*));
+    if (!dst->pedacos) return 0;
+    dst->cap_pedacos = usados;
+    for (int p = 0; p < usados; p++) {
+        PedacoPartidas *pedaco = mem_alocar(MEM_PARTIDAS, sizeof(PedacoPartidas));
+        if (!pedaco) {
+            dst->n = p << BITS_PEDACO_PARTIDAS;
+            bdpartidas_liberar(dst);
+            return 0;
+        }
+        // Copia apenas as partidas validas
+        int em_uso = src->n - (p << BITS_PEDACO_PARTIDAS);
+        if (em_uso > PARTIDAS_POR_PEDACO) em_uso = PARTIDAS_POR_PEDACO;
+        memcpy(pedaco->partidas, src->pedacos[p]->partidas, (size_t)em_uso * sizeof(Partida));
+        memcpy(pedaco->mandante, src->pedacos[p]->mandante, (size_t)em_uso * sizeof(int));
+        memcpy(pedaco->ant_visitante, src->pedacos[p]->ant_visitante, (size_t)em_uso * sizeof(int));
+        pedaco->refs = 1;
+        dst->pedacos[p] = pedaco;
+    }
+    dst->n = src->n;
+    return 1;
+}
+
+/**
+ * Cria uma base que compartilha os pedacos de outra.
+ * 
+ * Copia apenas o array de ponteiros para os pedacos, incrementando o
+ * contador de cada um. Os contadores nao sao atomicos: quem compartilha,
+ * acrescenta e libera as bases deve faze-lo de uma unica thread (em
+ * bd_versoes.c, o escritor).
+ * 
+ * @param dst Base de destino (nao precisa estar inicializada)
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_compartilhar(BDPartidas *dst, const BDPartidas *src) {
+    bdpartidas_init(dst);
+    int usados = pedacos_usados(src);
+    if (usados == 0) return 1;
+
+    // Folga para os pedacos que o destino alocar ao acrescentar
+    int cap = usados + 4;
+    dst->pedacos = mem_alocar(MEM_PARTIDAS, (size_t)cap * sizeof(PedacoPartidas*));
+    if (!dst->pedacos) return 0;
+    memcpy(dst->pedacos, src->pedacos, (size_t)usados * sizeof(PedacoPartidas*));
+    for (int p = 0; p < usados; p++) dst->pedacos[p]->refs++;
+    dst->n = src->n;
+    dst->cap_pedacos = cap;
+    return 1;
 }
 
 /**
  * Faz o parsing de uma linha do arquivo CSV de partidas.
  * 
- * Esta funcao auxiliar processa uma linha no formato "ID,Time1ID,Time2ID,Gols1,Gols2"
- * e extrai os cinco campos numericos. A linha e modificada no processo (strtok).
+ * Esta funcao processa uma linha no formato "ID,Time1ID,Time2ID,Gols1,Gols2"
+ * e extrai os cinco campos numericos. A linha NAO e modificada: os campos
+ * sao percorridos com um cursor (CursorCSV) e convertidos direto da linha,
+ * sem estado global. Por isso a funcao e reentrante e pode ser usada por
+ * varias threads ao mesmo tempo.
  * 
  * Formato esperado: "ID,Time1ID,Time2ID,Gols1,Gols2"
  * Exemplo: "0,5,3,2,1" representa:
@@ -68,44 +176,31 @@ static void chomp(char *s) {
  *   - Time 5 (mandante) x Time 3 (visitante)
  *   - Placar: 2 x 1
  * 
- * @param linha String contendo a linha a ser processada (sera modificada)
+ * @param linha Linha a ser processada
+ * @param len Numero de bytes da linha
  * @param out Ponteiro para a estrutura Partida onde os dados serao armazenados
  * @return 1 se o parsing foi bem sucedido, 0 se houver erro
  */
-static int parse_partida_linha(char *linha, Partida *out) {
-    // Remove caracteres de nova linha e espacos em branco
-    chomp(linha);
-    str_trim(linha);
+int bdpartidas_parse_linha(const char *linha, size_t len, Partida *out) {
+    CursorCSV cur;
+    cursor_iniciar(&cur, linha, len);
 
-    char *tok;      // Ponteiro para o token atual
-    int vals[5];    // Array temporario para armazenar os 5 valores
-    int i = 0;      // Indice atual no array de valores
+    const char *campo;  // Inicio do campo atual
+    size_t n;           // Tamanho do campo atual
+    int vals[5];        // Array temporario para armazenar os 5 valores
+    int i = 0;          // Indice atual no array de valores
 
-    // Extrai o primeiro campo (ID da partida)
-    tok = strtok(linha, ",");
-    
-    // Loop para extrair todos os 5 campos
-    while (tok && i < 5) {
-        // Limpa espacos em branco do campo
-        str_trim(tok);
-        chomp(tok);
-        
-        // Converte o campo de string para inteiro
-        int v;
-        if (!safe_atoi(tok, &v)) {
+    // Extrai os 5 campos, convertendo cada um para inteiro
+    while (i < 5 && cursor_proximo(&cur, &campo, &n)) {
+        if (!safe_atoi_n(campo, n, &vals[i])) {
             // Campo invalido (nao e um numero valido)
             return 0;
         }
-        
-        // Armazena o valor no array temporario
-        vals[i++] = v;
-        
-        // Extrai o proximo campo
-        tok = strtok(NULL, ",");
+        i++;
     }
     
     // Verifica se exatamente 5 campos foram extraidos
-    if (i != 5) return 0;  // Linha incompleta ou com campos extras
+    if (i != 5) return 0;  // Linha incompleta
 
     // Popula a estrutura Partida com os valores extraidos
     out->id    = vals[0];  // ID da partida
@@ -137,6 +232,8 @@ static int parse_partida_linha(char *linha, Partida *out) {
  * @return Numero de partidas carregadas com sucesso, ou 0 se houver erro ao abrir o arquivo
  */
 int bdpartidas_carregar_csv(BDPartidas *bd, const char *caminho) {
+    unsigned long long inicio = metricas_agora_ns();
+
     // Abre o arquivo CSV para leitura
     FILE *f = fopen(caminho, "r");
     if (!f) {
@@ -154,35 +251,38 @@ int bdpartidas_carregar_csv(BDPartidas *bd, const char *caminho) {
     }
 
     int count = 0;  // Contador de partidas carregadas com sucesso
+    unsigned long long linhas = 0, rejeitadas = 0, bytes = strlen(buf);
     
     // Le cada linha do arquivo ate o fim
     while (fgets(buf, sizeof(buf), f)) {
-        // Verifica se ja atingiu o limite maximo de partidas
-        if (bd->n >= MAX_PARTIDAS) {
-            fprintf(stderr, "Limite de partidas atingido (%d)\n", MAX_PARTIDAS);
-            break;
-        }
-        
-        // Cria uma copia da linha para nao modificar o buffer original
-        char linha[512];
-        strncpy(linha, buf, sizeof(linha) - 1);
-        linha[sizeof(linha) - 1] = '\0';
+        size_t len = strlen(buf);
+        linhas++;
+        bytes += len;
 
         // Faz o parsing da linha extraindo todos os campos
         Partida p;
-        if (!parse_partida_linha(linha, &p)) {
+        if (!bdpartidas_parse_linha(buf, len, &p)) {
             // Se o parsing falhar, ignora esta linha e continua
             fprintf(stderr, "Linha de partida ignorada (parse falhou): %s", buf);
+            rejeitadas++;
             continue;
         }
         
         // Adiciona a partida ao array e incrementa o contador
-        bd->partidas[bd->n++] = p;
+        if (!bdpartidas_adicionar(bd, &p)) {
+            fprintf(stderr, "Memoria insuficiente ao carregar partidas (%d carregadas)\n", count);
+            break;
+        }
         count++;
     }
     
     // Fecha o arquivo apos terminar a leitura
     fclose(f);
+
+    metricas_somar(MET_LINHAS_LIDAS, linhas);
+    metricas_somar(MET_LINHAS_REJEITADAS, rejeitadas);
+    metricas_somar(MET_BYTES_LIDOS, bytes);
+    metricas_tempo(MET_NS_CARGA_PARTIDAS, inicio);
     
     return count;  // Retorna quantas partidas foram carregadas
 }
@@ -205,98 +305,667 @@ int bdpartidas_carregar_csv(BDPartidas *bd, const char *caminho) {
  * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
  * @param bdt Ponteiro para a estrutura BDTimes cujas estatisticas serao atualizadas
  */
-void bdpartidas_aplicar_em_bdtimes(const BDPartidas *bdp, BDTimes *bdt) {
+void bdpartidas_aplicar_em_bdtimes(BDPartidas *bdp, BDTimes *bdt) {
+    unsigned long long inicio = metricas_agora_ns();
+
     // Percorre todas as partidas carregadas
-    for (int i = 0; i < bdp->n; i++) {
-        const Partida *p = &bdp->partidas[i];
-        
-        // Busca os dois times participantes da partida
-        Time *t1 = bdtimes_buscar_por_id(bdt, p->time1);  // Time mandante
-        Time *t2 = bdtimes_buscar_por_id(bdt, p->time2);  // Time visitante
-        
-        // Verifica se ambos os times foram encontrados
-        if (!t1 || !t2) {
-            // Um ou ambos os times nao existem na base de dados
-            fprintf(stderr, "Aviso: partida %d referencia time inexistente (%d,%d)\n", 
+    bdpartidas_aplicar_intervalo(bdp, 0, bdp->n, bdt);
+
+    metricas_somar(MET_PARTIDAS_AGREGADAS, (unsigned long long)bdp->n);
+    metricas_tempo(MET_NS_AGREGACAO, inicio);
+}
+
+/**
+ * Aplica o resultado de uma partida nos dois times ja localizados.
+ * 
+ * @param p Partida a aplicar
+ * @param t1 Time mandante (NULL se nao existe)
+ * @param t2 Time visitante (NULL se nao existe)
+ * @return 1 se aplicada, 0 se algum dos times nao existe
+ */
+static int aplicar_nos_times(const Partida *p, Time *t1, Time *t2) {
+    // Contadores de partidas: a partida aparece nas listagens de um time
+    // existente mesmo que o adversario nao exista, entao conta do mesmo jeito
+    if (t1) {
+        t1->jm++;
+        t1->jogos++;
+    }
+    if (t2) {
+        t2->jv++;
+        if (t2 != t1) t2->jogos++;
+    }
+    
+    // Verifica se ambos os times foram encontrados
+    if (!t1 || !t2) {
+        // Um ou ambos os times nao existem na base de dados
+        fprintf(stderr, "Aviso: partida %d referencia time inexistente (%d,%d)\n", 
+                p->id, p->time1, p->time2);
+        return 0;  // Partida ignorada
+    }
+    
+    // Atualiza as estatisticas do time mandante (t1)
+    // Para t1: gols feitos = g1, gols sofridos = g2
+    time_acumular_partida(t1, p->g1, p->g2);
+    
+    // Atualiza as estatisticas do time visitante (t2)
+    // Para t2: gols feitos = g2, gols sofridos = g1 (perspectiva invertida)
+    time_acumular_partida(t2, p->g2, p->g1);
+    return 1;
+}
+
+/**
+ * Guarda a posicao do mandante de uma partida aplicada (usada por
+ * bdpartidas_contar_por_prefixo()).
+ * 
+ * @param bdp Base de partidas
+ * @param i Posicao da partida
+ * @param s1 Posicao do mandante na base de times (-1 se nao existe)
+ */
+static void guardar_mandante(BDPartidas *bdp, int i, int s1) {
+    bdp->pedacos[i >> BITS_PEDACO_PARTIDAS]->mandante[i & (PARTIDAS_POR_PEDACO - 1)] = s1;
+}
+
+/**
+ * Acrescenta uma partida aplicada a lista de partidas do visitante
+ * (Time.ult_visitante, encadeada por PedacoPartidas.ant_visitante).
+ * 
+ * @param bdp Base de partidas
+ * @param i Posicao da partida
+ * @param t2 Time visitante
+ */
+static void encadear_visitante(BDPartidas *bdp, int i, Time *t2) {
+    bdp->pedacos[i >> BITS_PEDACO_PARTIDAS]->ant_visitante[i & (PARTIDAS_POR_PEDACO - 1)] = t2->ult_visitante;
+    t2->ult_visitante = i;
+}
+
+// Partidas cujos times sao localizados de uma vez (bdtimes_slots_por_id)
+#define PARTIDAS_POR_BLOCO 256
+
+/**
+ * Localiza os times de um bloco de partidas.
+ * 
+ * @param bdp Base de partidas
+ * @param bdt Base de times
+ * @param indices Posicoes das partidas na base, ou NULL para as
+ *                partidas de..de+m-1
+ * @param de Primeira partida do bloco (posicao em 'indices' ou na base)
+ * @param m Partidas no bloco (ate PARTIDAS_POR_BLOCO)
+ * @param slots Saida: 2*m posicoes na base de times (mandante em 2k,
+ *              visitante em 2k+1; -1 se o time nao existe)
+ */
+static void localizar_times(const BDPartidas *bdp, const BDTimes *bdt, const int *indices,
+                            int de, int m, int *slots) {
+    for (int k = 0; k < m; k++) {
+        const Partida *p = bdpartidas_partida(bdp, indices ? indices[de + k] : de + k);
+        slots[2 * k] = p->time1;
+        slots[2 * k + 1] = p->time2;
+    }
+    bdtimes_slots_por_id(bdt, slots, 2 * m, slots);
+}
+
+// ========== Agregacao por blocos de times ==========
+
+// Times por bloco da particao: 512 * sizeof(Time) (~52 KB) cabe na L2
+#define BITS_BLOCO_TIMES 9
+
+// Partidas particionadas de cada vez (limita a memoria auxiliar a ~2.5 MB)
+#define PARTICAO_PARTIDAS PARTIDAS_POR_AGREGACAO
+
+// Abaixo disso a particao nao compensa (intervalo curto ou times na cache)
+#define PARTICAO_MIN_PARTIDAS 4096
+#define PARTICAO_MIN_TIMES (4 << BITS_BLOCO_TIMES)
+
+// Lados de uma atualizacao (campo 'flags' de Atualizacao)
+#define ATUALIZA_MANDANTE 1   // Time mandante (senao, visitante)
+#define ATUALIZA_PLACAR   2   // Os dois times existem: acumula o resultado
+#define ATUALIZA_JOGO     4   // Conta mais uma partida distinta do time
+
+/**
+ * Atualizacao de um time por uma partida (um registro por lado existente).
+ */
+typedef struct {
+    int slot;    // Posicao do time na base de times
+    int gf;      // Gols feitos pelo time
+    int gs;      // Gols sofridos pelo time
+    int flags;   // ATUALIZA_*
+    int partida; // Posicao da partida (lista de partidas do visitante)
+} Atualizacao;
+
+// Agregacao por blocos ligada (bdpartidas_agregar_por_blocos)
+static int agregar_por_blocos = 0;
+
+/**
+ * Liga ou desliga a agregacao por blocos de times.
+ * 
+ * @param ativo 1 para particionar as atualizacoes, 0 para aplica-las
+ *              partida a partida
+ */
+void bdpartidas_agregar_por_blocos(int ativo) {
+    agregar_por_blocos = ativo ? 1 : 0;
+}
+
+/**
+ * @return 1 se a agregacao por blocos esta ligada
+ */
+int bdpartidas_agregando_por_blocos(void) {
+    return agregar_por_blocos;
+}
+
+/**
+ * Aplica um trecho de partidas particionando as atualizacoes por bloco de times.
+ * 
+ * 1. Localiza os times de todas as partidas do trecho
+ * 2. Emite os avisos de times inexistentes, na ordem das partidas
+ * 3. Conta as atualizacoes de cada bloco de times e, com as somas
+ *    acumuladas, espalha-as em 'part' agrupadas por bloco (radix de um
+ *    digito: o bloco do time)
+ * 4. Aplica bloco a bloco: os times de um bloco ficam na cache enquanto
+ *    recebem todas as suas atualizacoes
+ * 
+ * As estatisticas sao somas, entao a ordem de aplicacao nao muda o
+ * resultado.
+ * 
+ * @param bdp Base de partidas
+ * @param de Primeira partida do trecho
+ * @param m Partidas no trecho (ate PARTICAO_PARTIDAS)
+ * @param bdt Base de times
+ * @param slots Auxiliar com 2*PARTICAO_PARTIDAS posicoes
+ * @param part Auxiliar com 2*PARTICAO_PARTIDAS atualizacoes
+ * @param inicio Auxiliar com um contador por bloco, mais um
+ * @return Numero de partidas aplicadas (com os dois times existentes)
+ */
+static int aplicar_particionado(BDPartidas *bdp, int de, int m, BDTimes *bdt,
+                                int *slots, Atualizacao *part, int *inicio) {
+    int blocos = (bdt->n >> BITS_BLOCO_TIMES) + 1;
+    int aplicadas = 0;
+
+    localizar_times(bdp, bdt, NULL, de, m, slots);
+
+    memset(inicio, 0, (size_t)(blocos + 1) * sizeof(int));
+    for (int k = 0; k < m; k++) {
+        int s1 = slots[2 * k];
+        int s2 = slots[2 * k + 1];
+        if (s1 >= 0) inicio[(s1 >> BITS_BLOCO_TIMES) + 1]++;
+        if (s2 >= 0) inicio[(s2 >> BITS_BLOCO_TIMES) + 1]++;
+        if (s1 < 0 || s2 < 0) {
+            const Partida *p = bdpartidas_partida(bdp, de + k);
+            fprintf(stderr, "Aviso: partida %d referencia time inexistente (%d,%d)\n",
                     p->id, p->time1, p->time2);
-            continue;  // Pula esta partida e continua com a proxima
+        } else {
+            aplicadas++;
         }
-        
-        // Atualiza as estatisticas do time mandante (t1)
-        // Para t1: gols feitos = g1, gols sofridos = g2
-        time_acumular_partida(t1, p->g1, p->g2);
-        
-        // Atualiza as estatisticas do time visitante (t2)
-        // Para t2: gols feitos = g2, gols sofridos = g1 (perspectiva invertida)
-        time_acumular_partida(t2, p->g2, p->g1);
     }
+    for (int b = 0; b < blocos; b++) inicio[b + 1] += inicio[b];
+
+    // Espalha: inicio[b] avanca ate o fim do bloco b
+    for (int k = 0; k < m; k++) {
+        const Partida *p = bdpartidas_partida(bdp, de + k);
+        int s1 = slots[2 * k];
+        int s2 = slots[2 * k + 1];
+        int placar = s1 >= 0 && s2 >= 0 ? ATUALIZA_PLACAR : 0;
+        guardar_mandante(bdp, de + k, s1);
+        if (s1 >= 0) {
+            Atualizacao *a = &part[inicio[s1 >> BITS_BLOCO_TIMES]++];
+            a->slot = s1;
+            a->gf = p->g1;
+            a->gs = p->g2;
+            a->flags = ATUALIZA_MANDANTE | ATUALIZA_JOGO | placar;
+        }
+        if (s2 >= 0) {
+            Atualizacao *a = &part[inicio[s2 >> BITS_BLOCO_TIMES]++];
+            a->slot = s2;
+            a->gf = p->g2;
+            a->gs = p->g1;
+            a->flags = (s2 != s1 ? ATUALIZA_JOGO : 0) | placar;
+            a->partida = de + k;
+        }
+    }
+
+    // Depois do espalhamento, inicio[blocos - 1] e o total de atualizacoes
+    int total = inicio[blocos - 1];
+    for (int u = 0; u < total; u++) {
+        const Atualizacao *a = &part[u];
+        Time *t = bdtimes_time(bdt, a->slot);
+        if (a->flags & ATUALIZA_MANDANTE) {
+            t->jm++;
+        } else {
+            t->jv++;
+            encadear_visitante(bdp, a->partida, t);
+        }
+        if (a->flags & ATUALIZA_JOGO) t->jogos++;
+        if (a->flags & ATUALIZA_PLACAR) time_acumular_partida(t, a->gf, a->gs);
+    }
+    return aplicadas;
+}
+
+/**
+ * Aplica os resultados de um intervalo de partidas nas estatisticas dos times.
+ * 
+ * @param bdp Base de partidas
+ * @param de Primeira partida (posicao na base)
+ * @param ate Posicao apos a ultima partida
+ * @param bdt Base de times cujas estatisticas serao atualizadas
+ * @return Numero de partidas aplicadas (com os dois times existentes)
+ */
+int bdpartidas_aplicar_intervalo(BDPartidas *bdp, int de, int ate, BDTimes *bdt) {
+    int slots[2 * PARTIDAS_POR_BLOCO];
+    int aplicadas = 0;
+
+    if (agregar_por_blocos && ate - de >= PARTICAO_MIN_PARTIDAS && bdt->n >= PARTICAO_MIN_TIMES) {
+        int *aux = mem_alocar(MEM_INDICES, 2 * PARTICAO_PARTIDAS * sizeof(int));
+        Atualizacao *part = mem_alocar(MEM_INDICES, 2 * PARTICAO_PARTIDAS * sizeof(Atualizacao));
+        int *inicio = mem_alocar(MEM_INDICES, (size_t)((bdt->n >> BITS_BLOCO_TIMES) + 2) * sizeof(int));
+        if (aux && part && inicio) {
+            for (int i = de; i < ate; i += PARTICAO_PARTIDAS) {
+                int m = ate - i < PARTICAO_PARTIDAS ? ate - i : PARTICAO_PARTIDAS;
+                aplicadas += aplicar_particionado(bdp, i, m, bdt, aux, part, inicio);
+            }
+            de = ate;
+        }
+        // Sem memoria para a particao: aplica partida a partida
+        mem_liberar(aux);
+        mem_liberar(part);
+        mem_liberar(inicio);
+    }
+
+    for (int i = de; i < ate; i += PARTIDAS_POR_BLOCO) {
+        int m = ate - i < PARTIDAS_POR_BLOCO ? ate - i : PARTIDAS_POR_BLOCO;
+        localizar_times(bdp, bdt, NULL, i, m, slots);
+        for (int k = 0; k < m; k++) {
+            Time *t1 = slots[2 * k] >= 0 ? bdtimes_time(bdt, slots[2 * k]) : NULL;
+            Time *t2 = slots[2 * k + 1] >= 0 ? bdtimes_time(bdt, slots[2 * k + 1]) : NULL;
+            guardar_mandante(bdp, i + k, slots[2 * k]);
+            if (t2) encadear_visitante(bdp, i + k, t2);
+            aplicadas += aplicar_nos_times(bdpartidas_partida(bdp, i + k), t1, t2);
+        }
+    }
+    return aplicadas;
+}
+
+/**
+ * Aplica o resultado de uma unica partida da base nas estatisticas dos times.
+ * 
+ * Usada pela ingestao de uma partida avulsa; lotes de partidas passam
+ * diretamente por bdpartidas_aplicar_intervalo().
+ * 
+ * @param bdp Base de partidas
+ * @param i Posicao da partida na base
+ * @param bdt Base de times cujas estatisticas serao atualizadas
+ * @return 1 se aplicada, 0 se algum dos times nao existe
+ */
+int bdpartidas_aplicar_partida(BDPartidas *bdp, int i, BDTimes *bdt) {
+    return bdpartidas_aplicar_intervalo(bdp, i, i + 1, bdt);
 }
 
+// Nome exibido quando uma partida referencia um time inexistente
+#define NOME_DESCONHECIDO "(desconhecido)"
+
 /**
- * Busca o nome de um time pelo seu ID.
+ * Marca os times cujo nome comeca com o prefixo (case-insensitive).
  * 
- * Funcao auxiliar usada pelas funcoes de listagem de partidas.
- * Procura um time na base e retorna seu nome.
+ * O teste de prefixo e feito uma unica vez por time, e nao uma vez por
+ * partida: as partidas apenas consultam essas marcas.
  * 
- * @param bdt Ponteiro para a estrutura BDTimes onde buscar
- * @param id ID do time procurado
- * @return Nome do time encontrado, ou "(desconhecido)" se nao existir
+ * @param bdt Base de times
+ * @param prefixo Prefixo do nome
+ * @return Array com bdt->n marcas (1 = nome casa; liberar com mem_liberar),
+ *         ou NULL se faltou memoria
  */
-static const char* nome_do_time(const BDTimes *bdt, int id) {
-    // Busca linear por um time com o ID especificado
+static unsigned char* marcar_times(const BDTimes *bdt, const char *prefixo) {
+    unsigned char *casa = mem_alocar(MEM_INDICES, (size_t)bdt->n + 1);
+    if (!casa) {
+        fprintf(stderr, "Memoria insuficiente para a busca de partidas\n");
+        return NULL;
+    }
     for (int i = 0; i < bdt->n; i++) {
-        if (bdt->times[i].id == id) {
-            return bdt->times[i].nome;
+        casa[i] = str_starts_with_case_insensitive(bdtimes_time(bdt, i)->nome, prefixo) ? 1 : 0;
+    }
+    return casa;
+}
+
+/**
+ * Verifica se uma partida passa no filtro, dadas as marcas dos times.
+ * 
+ * @param s Posicoes do mandante e do visitante (localizar_times(); -1 se
+ *          o time nao existe na base)
+ * @param casa Marcas calculadas por marcar_times()
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return 1 se a partida passa no filtro
+ */
+static int partida_casa(const int *s, const unsigned char *casa, FiltroPartida filtro) {
+    int s1 = s[0];
+    int s2 = s[1];
+    int m1 = s1 >= 0 && casa[s1];
+    int m2 = s2 >= 0 && casa[s2];
+
+    switch (filtro) {
+        case FILTRO_MANDANTE:  return m1;
+        case FILTRO_VISITANTE: return m2;
+        default:               return m1 || m2;
+    }
+}
+
+/**
+ * Busca as partidas em que um time com o prefixo dado participa.
+ * 
+ * Mesma filtragem das listagens, mas sem escrever nada: os indices das
+ * partidas encontradas (posicoes na base de partidas, em ordem crescente)
+ * sao armazenados no array fornecido. Com max_indices = 0, apenas conta.
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas
+ * @param bdt Ponteiro para a estrutura BDTimes (nomes dos times)
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @param indices Array onde os indices encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de partidas encontradas (pode exceder max_indices)
+ */
+int bdpartidas_buscar_por_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo,
+                                  FiltroPartida filtro, int *indices, int max_indices) {
+    unsigned long long inicio = metricas_agora_ns();
+    int found = 0;
+    unsigned char *casa = marcar_times(bdt, prefixo);
+    if (!casa) return 0;
+
+    int slots[2 * PARTIDAS_POR_BLOCO];
+    for (int i = 0; i < bdp->n; i += PARTIDAS_POR_BLOCO) {
+        int m = bdp->n - i < PARTIDAS_POR_BLOCO ? bdp->n - i : PARTIDAS_POR_BLOCO;
+        localizar_times(bdp, bdt, NULL, i, m, slots);
+        for (int k = 0; k < m; k++) {
+            if (!partida_casa(&slots[2 * k], casa, filtro)) continue;
+            if (found < max_indices) indices[found] = i + k;
+            found++;
         }
     }
-    
-    // Time nao encontrado
-    return "(desconhecido)";
+
+    mem_liberar(casa);
+    metricas_somar(MET_BUSCAS_PARTIDAS, 1);
+    metricas_tempo(MET_NS_BUSCA, inicio);
+    return found;
 }
 
 /**
- * Lista partidas filtrando pelo prefixo do time mandante.
+ * Conta as partidas de um time que casa com o prefixo.
+ * 
+ * Com 'descontar', percorre a lista das partidas em que o time foi
+ * visitante e desconta as que tiveram como mandante outro time que tambem
+ * casa: essas ja foram contadas nos jogos do mandante.
+ * 
+ * @param bdp Base de partidas (listas dos visitantes)
+ * @param bdt Base de times
+ * @param slot Posicao do time na base de times
+ * @param prefixo Prefixo do nome
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @param descontar 1 para descontar as partidas entre times que casam
+ * @return Numero de partidas do time
+ */
+static int contar_time(const BDPartidas *bdp, const BDTimes *bdt, int slot, const char *prefixo,
+                       FiltroPartida filtro, int descontar) {
+    const Time *t = bdtimes_time(bdt, slot);
+    if (filtro == FILTRO_MANDANTE) return t->jm;
+    if (filtro == FILTRO_VISITANTE) return t->jv;
+
+    int total = t->jogos;
+    for (int i = descontar ? t->ult_visitante : -1; i >= 0; ) {
+        const PedacoPartidas *pedaco = bdp->pedacos[i >> BITS_PEDACO_PARTIDAS];
+        int k = i & (PARTIDAS_POR_PEDACO - 1);
+        int s1 = pedaco->mandante[k];
+        if (s1 >= 0 && s1 != slot &&
+            str_starts_with_case_insensitive(bdtimes_time(bdt, s1)->nome, prefixo)) {
+            total--;
+        }
+        i = pedaco->ant_visitante[k];
+    }
+    return total;
+}
+
+/**
+ * Conta as partidas em que um time com o prefixo dado participa.
+ * 
+ * Responde a partir dos contadores de cada time (jm, jv, jogos), mantidos
+ * por bdpartidas_aplicar_intervalo(), sem percorrer o array de partidas:
+ * - Os times que casam sao a faixa do prefixo no indice de nomes, mais os
+ *   times acrescentados depois da indexacao (testados um a um)
+ * - Mandante/visitante: soma de jm/jv desses times
+ * - Qualquer: soma de jogos. Com varios times, uma partida entre dois
+ *   deles seria contada duas vezes; cada uma e descontada uma vez,
+ *   percorrendo so as partidas em que esses times foram visitantes
+ * 
+ * Times com ID repetido: as partidas sao atribuidas ao primeiro time com
+ * o ID, como nas listagens.
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas
+ * @param bdt Ponteiro para a estrutura BDTimes (com contadores atualizados)
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return Numero de partidas (igual ao numero de linhas da listagem)
+ */
+int bdpartidas_contar_por_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo,
+                                  FiltroPartida filtro) {
+    unsigned long long inicio = metricas_agora_ns();
+    FaixaNomes faixa;
+    int casados = bdtimes_faixa_prefixo(bdt, prefixo, &faixa);
+    for (int s = bdt->nomes.n; s < bdt->n; s++) {
+        casados += str_starts_with_case_insensitive(bdtimes_time(bdt, s)->nome, prefixo);
+    }
+
+    int descontar = filtro == FILTRO_QUALQUER && casados > 1;
+    int total = 0;
+    for (int k = faixa.inicio; k < faixa.fim; k++) {
+        total += contar_time(bdp, bdt, bdt->nomes.ordem[k], prefixo, filtro, descontar);
+    }
+    for (int s = bdt->nomes.n; s < bdt->n; s++) {
+        if (str_starts_with_case_insensitive(bdtimes_time(bdt, s)->nome, prefixo)) {
+            total += contar_time(bdp, bdt, s, prefixo, filtro, descontar);
+        }
+    }
+
+    metricas_somar(descontar ? MET_CONTAGENS_LISTAS : MET_CONTAGENS_RAPIDAS, 1);
+    metricas_latencia(LAT_CONTAGEM, metricas_tempo(MET_NS_BUSCA, inicio));
+    return total;
+}
+
+/**
+ * Abre um cursor de busca paginada: marca os times uma unica vez.
+ * 
+ * @param cur Cursor a inicializar (fechar com bdpartidas_fechar_cursor)
+ * @param bdp Base de partidas
+ * @param bdt Base de times
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdpartidas_abrir_cursor(CursorPartidas *cur, const BDPartidas *bdp, const BDTimes *bdt,
+                            const char *prefixo, FiltroPartida filtro) {
+    // Uma busca paginada conta como uma busca, qualquer que seja o numero
+    // de paginas
+    metricas_somar(MET_BUSCAS_PARTIDAS, 1);
+    unsigned long long inicio = metricas_agora_ns();
+    cur->bdp = bdp;
+    cur->bdt = bdt;
+    cur->filtro = filtro;
+    cur->pos = 0;
+    cur->casa = marcar_times(bdt, prefixo);
+    metricas_tempo(MET_NS_BUSCA, inicio);
+    return cur->casa != NULL;
+}
+
+/**
+ * Busca a proxima pagina de um cursor.
  * 
- * Exibe todas as partidas onde o nome do time mandante (time1) comeca
- * com o prefixo especificado. A busca e case-insensitive (ignora maiusculas/minusculas).
+ * Examina as partidas a partir da posicao guardada no cursor ate
+ * preencher a pagina ou chegar ao fim da base.
+ * 
+ * @param cur Cursor aberto por bdpartidas_abrir_cursor()
+ * @param indices Array onde os indices da pagina serao armazenados
+ * @param max_indices Tamanho da pagina
+ * @return Numero de indices armazenados nesta pagina (0 = fim)
+ */
+int bdpartidas_proxima_pagina(CursorPartidas *cur, int *indices, int max_indices) {
+    const BDPartidas *bdp = cur->bdp;
+    if (!cur->casa || cur->pos >= bdp->n || max_indices <= 0) return 0;
+
+    unsigned long long inicio = metricas_agora_ns();
+    int found = 0;
+    int i = cur->pos;
+    int slots[2 * PARTIDAS_POR_BLOCO];
+    while (i < bdp->n && found < max_indices) {
+        int m = bdp->n - i < PARTIDAS_POR_BLOCO ? bdp->n - i : PARTIDAS_POR_BLOCO;
+        localizar_times(bdp, cur->bdt, NULL, i, m, slots);
+        for (int k = 0; k < m && found < max_indices; k++, i++) {
+            if (partida_casa(&slots[2 * k], cur->casa, cur->filtro)) {
+                indices[found++] = i;
+            }
+        }
+    }
+    cur->pos = i;
+    metricas_tempo(MET_NS_BUSCA, inicio);
+    return found;
+}
+
+/**
+ * Fecha um cursor, liberando as marcas dos times.
+ * 
+ * @param cur Cursor (pode ter falhado ao abrir)
+ */
+void bdpartidas_fechar_cursor(CursorPartidas *cur) {
+    mem_liberar(cur->casa);
+    cur->casa = NULL;
+}
+
+/**
+ * Escreve linhas de partidas (resultado de uma busca) em um escritor.
+ * 
+ * Formato de cada linha: | ID | Time1 | G1 x G2 | Time2 |
+ * Times inexistentes na base aparecem como NOME_DESCONHECIDO.
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas
+ * @param bdt Ponteiro para a estrutura BDTimes (nomes dos times)
+ * @param indices Indices das partidas a escrever (posicoes na base de partidas)
+ * @param n Quantidade de indices
+ * @param w Escritor de destino
+ */
+void bdpartidas_escrever_partidas(const BDPartidas *bdp, const BDTimes *bdt,
+                                  const int *indices, int n, Escritor *w) {
+    unsigned long long inicio = metricas_agora_ns();
+    int slots[2 * PARTIDAS_POR_BLOCO];
+    for (int k = 0; k < n; k++) {
+        const Partida *p = bdpartidas_partida(bdp, indices[k]);
+        if (k % PARTIDAS_POR_BLOCO == 0) {
+            int m = n - k < PARTIDAS_POR_BLOCO ? n - k : PARTIDAS_POR_BLOCO;
+            localizar_times(bdp, bdt, indices, k, m, slots);
+        }
+        int s1 = slots[2 * (k % PARTIDAS_POR_BLOCO)];
+        int s2 = slots[2 * (k % PARTIDAS_POR_BLOCO) + 1];
+
+        escritor_str(w, "| ");
+        escritor_int(w, p->id);
+        escritor_str(w, " | ");
+        escritor_str(w, s1 >= 0 ? bdtimes_time(bdt, s1)->nome : NOME_DESCONHECIDO);
+        escritor_str(w, " | ");
+        escritor_int(w, p->g1);
+        escritor_str(w, " x ");
+        escritor_int(w, p->g2);
+        escritor_str(w, " | ");
+        escritor_str(w, s2 >= 0 ? bdtimes_time(bdt, s2)->nome : NOME_DESCONHECIDO);
+        escritor_str(w, " |\n");
+    }
+    metricas_tempo(MET_NS_SAIDA, inicio);
+}
+
+// Numero de partidas buscadas por pagina nas listagens
+#define PAGINA_LISTAGEM 256
+
+/**
+ * Escreve a listagem de partidas filtradas por prefixo em um escritor.
+ * 
+ * Implementacao unica das tres listagens (mandante, visitante, qualquer),
+ * em duas etapas separadas: a busca (um CursorPartidas, com os times
+ * marcados uma unica vez) produz os indices das partidas, pagina a pagina,
+ * e bdpartidas_escrever_partidas os formata.
  * 
  * Formato de saida:
  * | ID | Time1 | Placar | Time2 |
  * | 5  | Flamengo | 3 x 1 | Santos |
  * 
- * Se nenhuma partida for encontrada, uma mensagem informativa e exibida.
+ * Se nenhuma partida for encontrada, uma mensagem informativa e escrita.
  * 
  * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
  * @param bdt Ponteiro para a estrutura BDTimes para buscar nomes dos times
- * @param prefixo Prefixo do nome do time mandante a buscar (ex: "Fla")
+ * @param prefixo Prefixo do nome do time a buscar
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @param w Escritor de destino
  */
-void bdpartidas_listar_por_mandante_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo) {
+void bdpartidas_escrever_listagem(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo,
+                                  FiltroPartida filtro, Escritor *w) {
+    unsigned long long inicio = metricas_agora_ns();
     int count = 0;  // Contador de partidas encontradas
     
     // Imprime o cabecalho da tabela
-    printf("| ID | Time1 |  | Time2 |\n");
-    printf("|----|-------|--|-------|\n");
+    escritor_str(w, "| ID | Time1 |  | Time2 |\n");
+    escritor_str(w, "|----|-------|--|-------|\n");
     
-    // Percorre todas as partidas carregadas
-    for (int i = 0; i < bdp->n; i++) {
-        const Partida *p = &bdp->partidas[i];
-        
-        // Busca o nome do time mandante
-        const char *n1 = nome_do_time(bdt, p->time1);
-        
-        // Verifica se o nome do mandante comeca com o prefixo (case-insensitive)
-        if (str_starts_with_case_insensitive(n1, prefixo)) {
-            // Partida encontrada! Busca o nome do visitante e imprime a linha
-            const char *n2 = nome_do_time(bdt, p->time2);
-            printf("| %d | %s | %d x %d | %s |\n", p->id, n1, p->g1, p->g2, n2);
-            count++;
+    // Marca os times uma unica vez (ao abrir o cursor); depois busca e
+    // escreve as partidas encontradas, uma pagina por vez
+    CursorPartidas cur;
+    if (bdpartidas_abrir_cursor(&cur, bdp, bdt, prefixo, filtro)) {
+        int pagina[PAGINA_LISTAGEM];
+        int n;
+        while ((n = bdpartidas_proxima_pagina(&cur, pagina, PAGINA_LISTAGEM)) > 0) {
+            bdpartidas_escrever_partidas(bdp, bdt, pagina, n, w);
+            count += n;
         }
     }
+    bdpartidas_fechar_cursor(&cur);
     
     // Se nenhuma partida foi encontrada, informa ao usuario
     if (count == 0) {
-        printf("Nenhuma partida encontrada para mandante com prefixo: %s\n", prefixo);
+        static const char *lado[] = { "mandante", "visitante", "mandante ou visitante" };
+        escritor_str(w, "Nenhuma partida encontrada para ");
+        escritor_str(w, lado[filtro]);
+        escritor_str(w, " com prefixo: ");
+        escritor_str(w, prefixo);
+        escritor_char(w, '\n');
     }
+
+    // Latencia da listagem inteira (busca + saida), por filtro
+    static const TipoLatencia tipo[] = { LAT_LISTAR_MANDANTE, LAT_LISTAR_VISITANTE, LAT_LISTAR_QUALQUER };
+    metricas_latencia(tipo[filtro], metricas_agora_ns() - inicio);
+}
+
+/**
+ * Executa uma listagem escrevendo diretamente na saida padrao.
+ * 
+ * Funcao auxiliar das tres funcoes publicas de listagem.
+ */
+static void listar_em_stdout(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo,
+                             FiltroPartida filtro) {
+    Escritor *w = mem_alocar(MEM_ESCRITORES, sizeof(Escritor));
+    if (!w) return;
+    escritor_de_arquivo(w, stdout);
+    bdpartidas_escrever_listagem(bdp, bdt, prefixo, filtro, w);
+    escritor_fechar(w);
+    mem_liberar(w);
+}
+
+/**
+ * Lista partidas filtrando pelo prefixo do time mandante.
+ * 
+ * Exibe todas as partidas onde o nome do time mandante (time1) comeca
+ * com o prefixo especificado. A busca e case-insensitive (ignora maiusculas/minusculas).
+ * 
+ * Formato de saida:
+ * | ID | Time1 | Placar | Time2 |
+ * | 5  | Flamengo | 3 x 1 | Santos |
+ * 
+ * Se nenhuma partida for encontrada, uma mensagem informativa e exibida.
+ * 
+ * @param bdp Ponteiro para a estrutura BDPartidas contendo as partidas
+ * @param bdt Ponteiro para a estrutura BDTimes para buscar nomes dos times
+ * @param prefixo Prefixo do nome do time mandante a buscar (ex: "Fla")
+ */
+void bdpartidas_listar_por_mandante_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo) {
+    listar_em_stdout(bdp, bdt, prefixo, FILTRO_MANDANTE);
 }
 
 /**
@@ -316,32 +985,7 @@ void bdpartidas_listar_por_mandante_prefixo(const BDPartidas *bdp, const BDTimes
  * @param prefixo Prefixo do nome do time visitante a buscar (ex: "Pal")
  */
 void bdpartidas_listar_por_visitante_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo) {
-    int count = 0;  // Contador de partidas encontradas
-    
-    // Imprime o cabecalho da tabela
-    printf("| ID | Time1 |  | Time2 |\n");
-    printf("|----|-------|--|-------|\n");
-    
-    // Percorre todas as partidas carregadas
-    for (int i = 0; i < bdp->n; i++) {
-        const Partida *p = &bdp->partidas[i];
-        
-        // Busca o nome do time visitante
-        const char *n2 = nome_do_time(bdt, p->time2);
-        
-        // Verifica se o nome do visitante comeca com o prefixo (case-insensitive)
-        if (str_starts_with_case_insensitive(n2, prefixo)) {
-            // Partida encontrada! Busca o nome do mandante e imprime a linha
-            const char *n1 = nome_do_time(bdt, p->time1);
-            printf("| %d | %s | %d x %d | %s |\n", p->id, n1, p->g1, p->g2, n2);
-            count++;
-        }
-    }
-    
-    // Se nenhuma partida foi encontrada, informa ao usuario
-    if (count == 0) {
-        printf("Nenhuma partida encontrada para visitante com prefixo: %s\n", prefixo);
-    }
+    listar_em_stdout(bdp, bdt, prefixo, FILTRO_VISITANTE);
 }
 
 /**
@@ -365,31 +1009,5 @@ void bdpartidas_listar_por_visitante_prefixo(const BDPartidas *bdp, const BDTime
  * @param prefixo Prefixo do nome do time a buscar (ex: "Cor")
  */
 void bdpartidas_listar_por_qualquer_prefixo(const BDPartidas *bdp, const BDTimes *bdt, const char *prefixo) {
-    int count = 0;  // Contador de partidas encontradas
-    
-    // Imprime o cabecalho da tabela
-    printf("| ID | Time1 |  | Time2 |\n");
-    printf("|----|-------|--|-------|\n");
-    
-    // Percorre todas as partidas carregadas
-    for (int i = 0; i < bdp->n; i++) {
-        const Partida *p = &bdp->partidas[i];
-        
-        // Busca os nomes de ambos os times
-        const char *n1 = nome_do_time(bdt, p->time1);  // Mandante
-        const char *n2 = nome_do_time(bdt, p->time2);  // Visitante
-        
-        // Verifica se qualquer um dos nomes comeca com o prefixo (case-insensitive)
-        if (str_starts_with_case_insensitive(n1, prefixo) || 
-            str_starts_with_case_insensitive(n2, prefixo)) {
-            // Partida encontrada! Imprime a linha com os dados completos
-            printf("| %d | %s | %d x %d | %s |\n", p->id, n1, p->g1, p->g2, n2);
-            count++;
-        }
-    }
-    
-    // Se nenhuma partida foi encontrada, informa ao usuario
-    if (count == 0) {
-        printf("Nenhuma partida encontrada para mandante ou visitante com prefixo: %s\n", prefixo);
-    }
+    listar_em_stdout(bdp, bdt, prefixo, FILTRO_QUALQUER);
 }
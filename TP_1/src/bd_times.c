@@ -9,34 +9,18 @@
  * - Calcular pontuacao e saldo de gols
  * - Imprimir e exportar a tabela de classificacao
  * 
- * O sistema usa uma base de dados em memoria (BDTimes) que armazena ate MAX_TIMES
- * times simultaneamente. Cada time possui um ID unico, nome e estatisticas acumuladas.
+ * O sistema usa uma base de dados em memoria (BDTimes) com os times em
+ * pedacos de tamanho fixo, alocados conforme o arquivo e lido. Cada time possui um ID unico, nome e estatisticas acumuladas.
  */
 
 #include "bd_times.h"
+#include "memoria.h"
+#include "metricas.h"
 #include "utils.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
-
-/**
- * Remove caracteres de nova linha deixados por fgets.
- * 
- * Esta funcao auxiliar limpa o final de strings lidas com fgets(),
- * removendo caracteres '\n' e '\r' que geralmente ficam anexados.
- * A string e modificada in-place.
- * 
- * @param s String a ser limpa (modificada diretamente)
- */
-static void chomp(char *s) {
-    // Obtem o tamanho atual da string
-    size_t n = strlen(s);
-    
-    // Remove caracteres de nova linha do final da string
-    // Percorre de tras para frente enquanto encontrar '\n' ou '\r'
-    while (n > 0 && (s[n - 1] == '\n' || s[n - 1] == '\r')) {
-        s[--n] = '\0';  // Substitui o caractere por terminador nulo
-    }
-}
+#include <stdlib.h>
 
 /**
  * Inicializa a estrutura de banco de dados de times.
@@ -48,8 +32,360 @@ static void chomp(char *s) {
  */
 void bdtimes_init(BDTimes *bd) {
     // Inicializa com zero registros carregados
-    // O array de times existe mas nenhum elemento e considerado valido ainda
+    // Os pedacos so sao alocados quando os times forem adicionados
+    bd->pedacos = NULL;
     bd->n = 0;
+    bd->cap_pedacos = 0;
+    bd->ids.tabela = NULL;
+    bd->ids.baldes = 0;
+    bd->ids.bits = 0;
+    bd->ids.n = 0;
+    bd->aprox.inicio = NULL;
+    bd->aprox.times = NULL;
+    bd->aprox.baldes = 0;
+    bd->aprox.n = 0;
+    bd->infixo.texto = NULL;
+    bd->infixo.sufixos = NULL;
+    bd->infixo.inicio_nome = NULL;
+    bd->infixo.num_sufixos = 0;
+    bd->infixo.n = 0;
+    bd->nomes.ordem = NULL;
+    bd->nomes.n = 0;
+    bd->refs_indices = NULL;
+}
+
+/**
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return Numero de pedacos em uso (os que tem algum dos 'n' times)
+ */
+static int pedacos_usados(const BDTimes *bd) {
+    return (bd->n + TIMES_POR_PEDACO - 1) >> BITS_PEDACO_TIMES;
+}
+
+/**
+ * Libera os arrays dos indices de busca (sem zerar os campos).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ */
+static void liberar_indices(BDTimes *bd) {
+    mem_liberar(bd->ids.tabela);
+    mem_liberar(bd->aprox.inicio);
+    mem_liberar(bd->aprox.times);
+    mem_liberar(bd->infixo.texto);
+    mem_liberar(bd->infixo.sufixos);
+    mem_liberar(bd->infixo.inicio_nome);
+    mem_liberar(bd->nomes.ordem);
+}
+
+/**
+ * Libera a memoria de uma base de times.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ */
+void bdtimes_liberar(BDTimes *bd) {
+    // Pedacos e indices compartilhados ficam com as outras bases
+    int usados = pedacos_usados(bd);
+    for (int p = 0; p < usados; p++) {
+        if (--bd->pedacos[p]->refs == 0) mem_liberar(bd->pedacos[p]);
+    }
+    mem_liberar(bd->pedacos);
+    if (!bd->refs_indices || --*bd->refs_indices == 0) {
+        liberar_indices(bd);
+        mem_liberar(bd->refs_indices);
+    }
+    bdtimes_init(bd);
+}
+
+/**
+ * Garante espaco em 'pedacos' para mais um pedaco.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+static int reservar_pedaco(BDTimes *bd) {
+    if (pedacos_usados(bd) < bd->cap_pedacos) return 1;
+    int cap = bd->cap_pedacos ? bd->cap_pedacos * 2 : 4;
+    PedacoTimes **novo = mem_realocar(MEM_TIMES, bd->pedacos, (size_t)cap * sizeof(PedacoTimes*));
+    if (!novo) return 0;
+    bd->pedacos = novo;
+    bd->cap_pedacos = cap;
+    return 1;
+}
+
+/**
+ * Copia um pedaco compartilhado para que so esta base o use.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param p Indice do pedaco
+ * @return 1 se sucesso, 0 se faltou memoria (o pedaco continua compartilhado)
+ */
+static int separar_pedaco(BDTimes *bd, int p) {
+    PedacoTimes *antigo = bd->pedacos[p];
+    if (antigo->refs == 1) return 1;
+
+    PedacoTimes *novo = mem_alocar(MEM_TIMES, sizeof(PedacoTimes));
+    if (!novo) return 0;
+    int em_uso = bd->n - (p << BITS_PEDACO_TIMES);
+    if (em_uso > TIMES_POR_PEDACO) em_uso = TIMES_POR_PEDACO;
+    memcpy(novo->times, antigo->times, (size_t)em_uso * sizeof(Time));
+    novo->refs = 1;
+    antigo->refs--;
+    bd->pedacos[p] = novo;
+    return 1;
+}
+
+/**
+ * Acrescenta um time ao final da base.
+ * 
+ * Um pedaco novo e alocado a cada TIMES_POR_PEDACO times; o array de
+ * pedacos dobra a cada realocacao. Se o ultimo pedaco e compartilhado,
+ * ele e copiado antes.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param t Time a acrescentar
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_adicionar(BDTimes *bd, const Time *t) {
+    int p = bd->n >> BITS_PEDACO_TIMES;
+    if ((bd->n & (TIMES_POR_PEDACO - 1)) == 0) {
+        if (!reservar_pedaco(bd)) return 0;
+        PedacoTimes *pedaco = mem_alocar(MEM_TIMES, sizeof(PedacoTimes));
+        if (!pedaco) return 0;
+        pedaco->refs = 1;
+        bd->pedacos[p] = pedaco;
+    } else if (!separar_pedaco(bd, p)) {
+        return 0;
+    }
+    Time *novo = bdtimes_time(bd, bd->n++);
+    *novo = *t;
+
+    // Medidas do nome para a tabela, calculadas uma unica vez
+    size_t bytes = strlen(novo->nome);
+    novo->nome_bytes = (unsigned char)bytes;
+    novo->nome_largura = (unsigned char)utf8_largura_n(novo->nome, bytes);
+    int usada;
+    novo->nome_corte = (unsigned char)utf8_prefixo_bytes(novo->nome, LARGURA_COLUNA_TIME - 1,
+                                                         MAX_NOME_TIME - 1, &usada);
+    novo->nome_corte_largura = (unsigned char)usada;
+    return 1;
+}
+
+/**
+ * Copia o indice de IDs de uma base para outra.
+ * 
+ * @param dst Indice de destino (vazio)
+ * @param src Indice de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+static int copiar_indice_ids(IndiceIds *dst, const IndiceIds *src) {
+    if (src->baldes == 0) return 1;
+
+    dst->tabela = mem_alocar(MEM_INDICES, (size_t)src->baldes * sizeof(EntradaId));
+    if (!dst->tabela) return 0;
+    memcpy(dst->tabela, src->tabela, (size_t)src->baldes * sizeof(EntradaId));
+    dst->baldes = src->baldes;
+    dst->bits = src->bits;
+    dst->n = src->n;
+    return 1;
+}
+
+/**
+ * Copia o indice de busca aproximada de uma base para outra.
+ * 
+ * @param dst Indice de destino (vazio)
+ * @param src Indice de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+static int copiar_indice_aprox(IndiceAprox *dst, const IndiceAprox *src) {
+    if (src->baldes == 0) return 1;
+
+    size_t bytes_inicio = (size_t)(src->baldes + 1) * sizeof(unsigned int);
+    size_t bytes_times = (size_t)src->inicio[src->baldes] * sizeof(int);
+    dst->inicio = mem_alocar(MEM_INDICES, bytes_inicio);
+    dst->times = mem_alocar(MEM_INDICES, bytes_times ? bytes_times : sizeof(int));
+    if (!dst->inicio || !dst->times) return 0;
+    memcpy(dst->inicio, src->inicio, bytes_inicio);
+    memcpy(dst->times, src->times, bytes_times);
+    dst->baldes = src->baldes;
+    dst->n = src->n;
+    return 1;
+}
+
+/**
+ * Copia o indice de busca por trecho de uma base para outra.
+ * 
+ * @param dst Indice de destino (vazio)
+ * @param src Indice de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+static int copiar_indice_infixo(IndiceInfixo *dst, const IndiceInfixo *src) {
+    if (src->n == 0) return 1;
+
+    size_t bytes_texto = (size_t)src->inicio_nome[src->n];
+    size_t bytes_sufixos = (size_t)src->num_sufixos * sizeof(int);
+    size_t bytes_inicio = ((size_t)src->n + 1) * sizeof(int);
+    dst->texto = mem_alocar(MEM_INDICES, bytes_texto ? bytes_texto : 1);
+    dst->sufixos = mem_alocar(MEM_INDICES, bytes_sufixos ? bytes_sufixos : sizeof(int));
+    dst->inicio_nome = mem_alocar(MEM_INDICES, bytes_inicio);
+    if (!dst->texto || !dst->sufixos || !dst->inicio_nome) return 0;
+    memcpy(dst->texto, src->texto, bytes_texto);
+    memcpy(dst->sufixos, src->sufixos, bytes_sufixos);
+    memcpy(dst->inicio_nome, src->inicio_nome, bytes_inicio);
+    dst->num_sufixos = src->num_sufixos;
+    dst->n = src->n;
+    return 1;
+}
+
+/**
+ * Copia o indice de nomes de uma base para outra.
+ * 
+ * @param dst Indice de destino (vazio)
+ * @param src Indice de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+static int copiar_indice_nomes(IndiceNomes *dst, const IndiceNomes *src) {
+    if (src->n == 0) return 1;
+
+    dst->ordem = mem_alocar(MEM_INDICES, (size_t)src->n * sizeof(int));
+    if (!dst->ordem) return 0;
+    memcpy(dst->ordem, src->ordem, (size_t)src->n * sizeof(int));
+    dst->n = src->n;
+    return 1;
+}
+
+/**
+ * Copia os quatro indices de busca de uma base para outra.
+ * 
+ * @param dst Base de destino (sem indices)
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 se faltou memoria (o que foi copiado fica em 'dst')
+ */
+static int copiar_indices(BDTimes *dst, const BDTimes *src) {
+    return copiar_indice_ids(&dst->ids, &src->ids) &&
+           copiar_indice_aprox(&dst->aprox, &src->aprox) &&
+           copiar_indice_infixo(&dst->infixo, &src->infixo) &&
+           copiar_indice_nomes(&dst->nomes, &src->nomes);
+}
+
+/**
+ * Copia uma base de times.
+ * 
+ * Copia profunda: pedacos e indices de busca novos, sem nada em comum
+ * com a origem (ver bdtimes_compartilhar() para o contrario).
+ * 
+ * @param dst Base de destino (nao precisa estar inicializada)
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_copiar(BDTimes *dst, const BDTimes *src) {
+    bdtimes_init(dst);
+    if (src->n == 0) return 1;
+
+    // Copia apenas os pedacos em uso
+    int usados = pedacos_usados(src);
+    dst->pedacos = mem_alocar(MEM_TIMES, (size_t)usados * sizeof(PedacoTimes*));
+    if (!dst->pedacos) return 0;
+    dst->cap_pedacos = usados;
+    for (int p = 0; p < usados; p++) {
+        PedacoTimes *pedaco = mem_alocar(MEM_TIMES, sizeof(PedacoTimes));
+        if (!pedaco) {
+            dst->n = p << BITS_PEDACO_TIMES;
+            bdtimes_liberar(dst);
+            return 0;
+        }
+        int em_uso = src->n - (p << BITS_PEDACO_TIMES);
+        if (em_uso > TIMES_POR_PEDACO) em_uso = TIMES_POR_PEDACO;
+        memcpy(pedaco->times, src->pedacos[p]->times, (size_t)em_uso * sizeof(Time));
+        pedaco->refs = 1;
+        dst->pedacos[p] = pedaco;
+    }
+    dst->n = src->n;
+
+    if (!copiar_indices(dst, src)) {
+        bdtimes_liberar(dst);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Cria uma base que compartilha os pedacos e os indices de outra.
+ * 
+ * Copia apenas o array de ponteiros para os pedacos (incrementando o
+ * contador de cada um) e as estruturas dos indices, que apontam para os
+ * mesmos arrays. Os contadores nao sao atomicos: quem compartilha,
+ * altera e libera as bases deve faze-lo de uma unica thread (em
+ * bd_versoes.c, o escritor).
+ * 
+ * @param dst Base de destino (nao precisa estar inicializada)
+ * @param src Base de origem
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_compartilhar(BDTimes *dst, BDTimes *src) {
+    bdtimes_init(dst);
+    if (!src->refs_indices) {
+        src->refs_indices = mem_alocar(MEM_INDICES, sizeof(int));
+        if (!src->refs_indices) return 0;
+        *src->refs_indices = 1;
+    }
+
+    int usados = pedacos_usados(src);
+    if (usados > 0) {
+        dst->pedacos = mem_alocar(MEM_TIMES, (size_t)usados * sizeof(PedacoTimes*));
+        if (!dst->pedacos) return 0;
+        memcpy(dst->pedacos, src->pedacos, (size_t)usados * sizeof(PedacoTimes*));
+        for (int p = 0; p < usados; p++) dst->pedacos[p]->refs++;
+    }
+    dst->n = src->n;
+    dst->cap_pedacos = usados;
+
+    dst->ids = src->ids;
+    dst->aprox = src->aprox;
+    dst->infixo = src->infixo;
+    dst->nomes = src->nomes;
+    dst->refs_indices = src->refs_indices;
+    (*dst->refs_indices)++;
+    return 1;
+}
+
+/**
+ * Prepara um time para alteracao (copia o pedaco se compartilhado).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param i Posicao do time
+ * @return Ponteiro para o time, ou NULL se faltou memoria
+ */
+Time* bdtimes_alterar(BDTimes *bd, int i) {
+    if (!separar_pedaco(bd, i >> BITS_PEDACO_TIMES)) return NULL;
+    return bdtimes_time(bd, i);
+}
+
+/**
+ * Garante que os indices de busca sao so desta base, copiando-os se
+ * forem compartilhados (antes de reconstruir algum deles).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (os indices continuam compartilhados)
+ */
+static int indices_proprios(BDTimes *bd) {
+    if (!bd->refs_indices) return 1;
+    if (*bd->refs_indices > 1) {
+        BDTimes copia;
+        bdtimes_init(&copia);
+        if (!copiar_indices(&copia, bd)) {
+            liberar_indices(&copia);
+            return 0;
+        }
+        (*bd->refs_indices)--;
+        bd->ids = copia.ids;
+        bd->aprox = copia.aprox;
+        bd->infixo = copia.infixo;
+        bd->nomes = copia.nomes;
+    } else {
+        mem_liberar(bd->refs_indices);
+    }
+    bd->refs_indices = NULL;
+    return 1;
 }
 
 /**
@@ -69,6 +405,10 @@ void time_zerar_stats(Time *t) {
     t->d = 0;   // Zera derrotas
     t->gm = 0;  // Zera gols marcados
     t->gs = 0;  // Zera gols sofridos
+    t->jm = 0;  // Zera partidas como mandante
+    t->jv = 0;  // Zera partidas como visitante
+    t->jogos = 0;  // Zera partidas disputadas
+    t->ult_visitante = -1;  // Nenhuma partida como visitante
 }
 
 /**
@@ -139,41 +479,39 @@ int time_saldo(const Time *t) {
  * Faz o parsing de uma linha do arquivo CSV de times.
  * 
  * Esta funcao auxiliar processa uma linha no formato "ID,Nome" e extrai
- * os dois campos separadamente. A linha e modificada no processo (strtok).
+ * os dois campos separadamente. A linha NAO e modificada: os campos sao
+ * percorridos com um cursor (CursorCSV), sem o estado global de strtok,
+ * o que torna a funcao reentrante (segura para varias threads).
  * 
  * Formato esperado: "ID,Nome"
  * Exemplo: "0,Flamengo"
  * 
- * @param linha String contendo a linha a ser processada (sera modificada)
+ * @param linha Linha a ser processada
+ * @param len Numero de bytes da linha
  * @param id Ponteiro onde o ID extraido sera armazenado
  * @param nome Buffer onde o nome extraido sera copiado (deve ter tamanho MAX_NOME_TIME)
  * @return 1 se o parsing foi bem sucedido, 0 se houver erro
  */
-static int parse_time_linha(char *linha, int *id, char *nome) {
-    // Remove caracteres de nova linha e espacos em branco
-    chomp(linha);
-    str_trim(linha);
-
-    // Extrai o primeiro campo (ID)
-    char *tok = strtok(linha, ",");
-    if (!tok) return 0;  // Linha vazia ou sem virgula
+static int parse_time_linha(const char *linha, size_t len, int *id, char *nome) {
+    CursorCSV cur;
+    cursor_iniciar(&cur, linha, len);
     
-    // Converte o ID de string para inteiro
+    const char *campo;
+    size_t n;
+
+    // Extrai o primeiro campo (ID) e converte para inteiro
+    if (!cursor_proximo(&cur, &campo, &n)) return 0;  // Linha vazia
     int tmp_id;
-    if (!safe_atoi(tok, &tmp_id)) return 0;  // ID invalido (nao e numero)
+    if (!safe_atoi_n(campo, n, &tmp_id)) return 0;    // ID invalido (nao e numero)
 
     // Extrai o segundo campo (Nome)
-    tok = strtok(NULL, ",");
-    if (!tok) return 0;  // Falta o campo nome
+    if (!cursor_proximo(&cur, &campo, &n) || n == 0) return 0;  // Falta o campo nome
     
-    // Limpa espacos em branco do nome
-    str_trim(tok);
-    chomp(tok);
-
     // Copia os valores extraidos para os parametros de saida
+    if (n > MAX_NOME_TIME - 1) n = MAX_NOME_TIME - 1;
     *id = tmp_id;
-    strncpy(nome, tok, MAX_NOME_TIME - 1);
-    nome[MAX_NOME_TIME - 1] = '\0';  // Garante terminacao nula
+    memcpy(nome, campo, n);
+    nome[n] = '\0';  // Garante terminacao nula
     
     return 1;  // Sucesso
 }
@@ -198,6 +536,8 @@ static int parse_time_linha(char *linha, int *id, char *nome) {
  * @return Numero de times carregados com sucesso, ou 0 se houver erro ao abrir o arquivo
  */
 int bdtimes_carregar_csv(BDTimes *bd, const char *caminho) {
+    unsigned long long inicio = metricas_agora_ns();
+
     // Abre o arquivo CSV para leitura
     FILE *f = fopen(caminho, "r");
     if (!f) {
@@ -215,26 +555,21 @@ int bdtimes_carregar_csv(BDTimes *bd, const char *caminho) {
     }
 
     int count = 0;  // Contador de times carregados com sucesso
+    unsigned long long linhas = 0, rejeitadas = 0, bytes = strlen(buf);
     
     // Le cada linha do arquivo ate o fim
     while (fgets(buf, sizeof(buf), f)) {
-        // Verifica se ja atingiu o limite maximo de times
-        if (bd->n >= MAX_TIMES) {
-            fprintf(stderr, "Limite de times atingido (%d)\n", MAX_TIMES);
-            break;
-        }
-        
-        // Cria uma copia da linha para nao modificar o buffer original
-        char linha[256];
-        strncpy(linha, buf, sizeof(linha) - 1);
-        linha[sizeof(linha) - 1] = '\0';
+        size_t len = strlen(buf);
+        linhas++;
+        bytes += len;
 
         // Faz o parsing da linha extraindo ID e nome
         int id;
         char nome[MAX_NOME_TIME];
-        if (!parse_time_linha(linha, &id, nome)) {
+        if (!parse_time_linha(buf, len, &id, nome)) {
             // Se o parsing falhar, ignora esta linha e continua
             fprintf(stderr, "Linha de time ignorada (parse falhou): %s", buf);
+            rejeitadas++;
             continue;
         }
         
@@ -249,37 +584,166 @@ int bdtimes_carregar_csv(BDTimes *bd, const char *caminho) {
         time_zerar_stats(&t);
         
         // Adiciona o time ao array e incrementa o contador
-        bd->times[bd->n++] = t;
+        if (!bdtimes_adicionar(bd, &t)) {
+            fprintf(stderr, "Memoria insuficiente ao carregar times (%d carregados)\n", count);
+            break;
+        }
         count++;
     }
     
     // Fecha o arquivo apos terminar a leitura
     fclose(f);
+
+    if (!bdtimes_indexar_ids(bd) || !bdtimes_indexar_aproximado(bd) ||
+        !bdtimes_indexar_infixo(bd) || !bdtimes_indexar_nomes(bd)) {
+        fprintf(stderr, "Memoria insuficiente para os indices de busca\n");
+    }
+
+    metricas_somar(MET_LINHAS_LIDAS, linhas);
+    metricas_somar(MET_LINHAS_REJEITADAS, rejeitadas);
+    metricas_somar(MET_BYTES_LIDOS, bytes);
+    metricas_tempo(MET_NS_CARGA_TIMES, inicio);
     
     return count;  // Retorna quantos times foram carregados
 }
 
+// ========== Indice de IDs ==========
+
+// IDs tratados por grupo em bdtimes_slots_por_id: o bastante para manter
+// varias faltas de cache em andamento, pouco para a pre-busca nao expulsar
+// da cache os baldes do proprio grupo
+#define IDS_POR_GRUPO 16
+
+// Pre-busca de um endereco para leitura (sem efeito fora do GCC/Clang)
+#if defined(__GNUC__)
+#define PREBUSCAR(p) __builtin_prefetch((p), 0, 3)
+#else
+#define PREBUSCAR(p) ((void)(p))
+#endif
+
 /**
- * Busca um time pelo seu ID.
+ * Calcula o balde de um ID (hash multiplicativo de Fibonacci).
+ * 
+ * @param id ID do time
+ * @param bits log2 do numero de baldes (>= 1)
+ * @return Balde inicial da sondagem
+ */
+static unsigned int balde_id(int id, int bits) {
+    return ((unsigned int)id * 0x9E3779B1u) >> (32 - bits);
+}
+
+/**
+ * Sonda a tabela de IDs a partir de um balde.
+ * 
+ * @param ix Indice de IDs (com baldes > 0)
+ * @param id ID procurado
+ * @param b Balde inicial (balde_id())
+ * @return Posicao do time, ou -1 se o ID nao esta na tabela
+ */
+static int sondar_id(const IndiceIds *ix, int id, unsigned int b) {
+    unsigned int mascara = (unsigned int)ix->baldes - 1;
+    for (;; b = (b + 1) & mascara) {
+        const EntradaId *e = &ix->tabela[b];
+        if (e->slot < 0) return -1;
+        if (e->id == id) return e->slot;
+    }
+}
+
+/**
+ * Procura um ID entre os times que o indice nao cobre.
+ * 
+ * @param bd Base de times
+ * @param id ID procurado
+ * @return Posicao do time, ou -1 se nao existir
+ */
+static int slot_fora_do_indice(const BDTimes *bd, int id) {
+    for (int i = bd->ids.n; i < bd->n; i++) {
+        if (bdtimes_time(bd, i)->id == id) return i;
+    }
+    return -1;
+}
+
+/**
+ * (Re)constroi o indice de IDs.
+ * 
+ * Os times entram em ordem de posicao; um ID ja presente nao e
+ * sobrescrito, de modo que vale o primeiro time com o ID.
  * 
- * Procura linearmente na base de dados por um time com o ID especificado.
- * Esta busca e eficiente para bases pequenas (ate MAX_TIMES = 64 times).
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_ids(BDTimes *bd) {
+    if (!indices_proprios(bd)) return 0;
+    int bits = 4;
+    while (bits < 30 && (1 << bits) < 2 * bd->n) bits++;
+    int baldes = 1 << bits;
+
+    EntradaId *tabela = mem_alocar(MEM_INDICES, (size_t)baldes * sizeof(EntradaId));
+    if (!tabela) return 0;
+    for (int b = 0; b < baldes; b++) tabela[b].slot = -1;
+
+    unsigned int mascara = (unsigned int)baldes - 1;
+    for (int i = 0; i < bd->n; i++) {
+        int id = bdtimes_time(bd, i)->id;
+        unsigned int b = balde_id(id, bits);
+        while (tabela[b].slot >= 0 && tabela[b].id != id) b = (b + 1) & mascara;
+        if (tabela[b].slot < 0) {
+            tabela[b].id = id;
+            tabela[b].slot = i;
+        }
+    }
+
+    mem_liberar(bd->ids.tabela);
+    bd->ids.tabela = tabela;
+    bd->ids.baldes = baldes;
+    bd->ids.bits = bits;
+    bd->ids.n = bd->n;
+    return 1;
+}
+
+/**
+ * Busca um time pelo seu ID.
  * 
  * @param bd Ponteiro para a estrutura BDTimes onde buscar
  * @param id ID do time procurado
  * @return Ponteiro para o Time encontrado, ou NULL se nao existir
  */
 Time* bdtimes_buscar_por_id(BDTimes *bd, int id) {
-    // Percorre todos os times carregados
-    for (int i = 0; i < bd->n; i++) {
-        if (bd->times[i].id == id) {
-            // Time encontrado! Retorna um ponteiro para ele
-            return &bd->times[i];
+    int s = -1;
+    if (bd->ids.baldes > 0) s = sondar_id(&bd->ids, id, balde_id(id, bd->ids.bits));
+    if (s < 0) s = slot_fora_do_indice(bd, id);
+    return s >= 0 ? bdtimes_time(bd, s) : NULL;
+}
+
+/**
+ * Converte varios IDs em posicoes de times de uma vez (hash de todos os
+ * IDs do grupo, pre-busca de todos os baldes, sondagem).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param ids IDs a converter
+ * @param n Numero de IDs
+ * @param slots Saida: posicao de cada time, ou -1 (pode ser o proprio 'ids')
+ */
+void bdtimes_slots_por_id(const BDTimes *bd, const int *ids, int n, int *slots) {
+    const IndiceIds *ix = &bd->ids;
+    if (ix->baldes == 0) {
+        for (int i = 0; i < n; i++) slots[i] = slot_fora_do_indice(bd, ids[i]);
+        return;
+    }
+
+    int fora = bd->n > ix->n;  // Ha times que o indice nao cobre
+    for (int base = 0; base < n; base += IDS_POR_GRUPO) {
+        int m = n - base < IDS_POR_GRUPO ? n - base : IDS_POR_GRUPO;
+        unsigned int baldes[IDS_POR_GRUPO];
+        for (int k = 0; k < m; k++) baldes[k] = balde_id(ids[base + k], ix->bits);
+        for (int k = 0; k < m; k++) PREBUSCAR(&ix->tabela[baldes[k]]);
+        for (int k = 0; k < m; k++) {
+            int id = ids[base + k];
+            int s = sondar_id(ix, id, baldes[k]);
+            if (s < 0 && fora) s = slot_fora_do_indice(bd, id);
+            slots[base + k] = s;
         }
     }
-    
-    // Time nao encontrado
-    return NULL;
 }
 
 /**
@@ -300,13 +764,14 @@ Time* bdtimes_buscar_por_id(BDTimes *bd, int id) {
  * @param max_indices Tamanho maximo do array indices
  * @return Total de times encontrados (pode ser maior que max_indices)
  */
-int bdtimes_buscar_por_prefixo(BDTimes *bd, const char *prefixo, int *indices, int max_indices) {
+int bdtimes_buscar_por_prefixo(const BDTimes *bd, const char *prefixo, int *indices, int max_indices) {
+    unsigned long long inicio = metricas_agora_ns();
     int found = 0;  // Contador de times encontrados
     
     // Percorre todos os times carregados
     for (int i = 0; i < bd->n; i++) {
         // Verifica se o nome do time comeca com o prefixo (case-insensitive)
-        if (str_starts_with_case_insensitive(bd->times[i].nome, prefixo)) {
+        if (str_starts_with_case_insensitive(bdtimes_time(bd, i)->nome, prefixo)) {
             // Time encontrado!
             
             // Armazena o indice apenas se ainda ha espaco no array
@@ -319,232 +784,1433 @@ int bdtimes_buscar_por_prefixo(BDTimes *bd, const char *prefixo, int *indices, i
         }
     }
     
+    metricas_somar(MET_BUSCAS_TIMES, 1);
+    metricas_latencia(LAT_BUSCA_TIMES, metricas_tempo(MET_NS_BUSCA, inicio));
     return found;  // Retorna o total de times encontrados
 }
 
+// ========== Busca aproximada ==========
+
+// Code points considerados de um nome ou texto buscado
+#define APROX_MAX_CPS (MAX_NOME_TIME - 1)
+// Limites do numero de baldes do indice de trigramas
+#define APROX_MIN_BALDES 256
+#define APROX_MAX_BALDES (1 << 18)
+
 /**
- * Exporta a tabela de classificacao para um arquivo CSV com formatacao alinhada.
+ * Calcula o balde de um trigrama (hash dos tres code points).
  * 
- * Esta funcao cria/sobrescreve o arquivo "bd_classificacao.csv" contendo todos
- * os times ordenados por ID, com colunas separadas por "|" e alinhadas para
- * facilitar a leitura visual.
+ * @param a Primeiro code point
+ * @param b Segundo code point
+ * @param c Terceiro code point
+ * @param baldes Numero de baldes (potencia de 2)
+ * @return Balde do trigrama
+ */
+static unsigned int balde_trigrama(unsigned int a, unsigned int b, unsigned int c, int baldes) {
+    unsigned int h = (a * 0x9E3779B1u) ^ (b * 0x85EBCA77u) ^ (c * 0xC2B2AE3Du);
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h & (unsigned int)(baldes - 1);
+}
+
+/**
+ * Calcula os baldes distintos dos trigramas de um texto dobrado,
+ * precedido de um espaco ("Flamengo": " fl", "fla", "lam", ...).
  * 
- * Formato do arquivo:
- * - Cabecalho com nomes das colunas
- * - Linha separadora com hifens
- * - Uma linha por time com todos os dados estatisticos
- * - Todas as colunas alinhadas usando espacos
+ * O espaco inicial faz o primeiro caractere contar em dois trigramas,
+ * de modo que um texto de n code points tem n - 1 trigramas.
  * 
- * @param bd Ponteiro para a estrutura BDTimes contendo os times a exportar
- * @return 1 se a exportacao foi bem sucedida, 0 em caso de erro
+ * @param cps Texto dobrado
+ * @param n Numero de code points
+ * @param baldes Numero de baldes do indice
+ * @param out Baldes distintos, em ordem crescente (ate n posicoes)
+ * @return Numero de baldes gravados em 'out'
  */
-static int bdtimes_exportar_csv(const BDTimes *bd) {
-    // Nome do arquivo CSV de saida (sera criado no diretorio atual)
-    const char *nome_arquivo = "bd_classificacao.csv";
-    
-    // Abre o arquivo em modo de escrita (sobrescreve se ja existir)
-    FILE *f = fopen(nome_arquivo, "w");
-    if (!f) {
-        // Se falhar ao criar o arquivo, exibe mensagem de erro e retorna 0
-        fprintf(stderr, "Erro ao criar arquivo CSV: %s\n", nome_arquivo);
+static int baldes_trigramas(const unsigned int *cps, int n, int baldes, unsigned int *out) {
+    int m = 0;
+    for (int j = 0; j + 1 < n; j++) {
+        unsigned int b = balde_trigrama(j == 0 ? ' ' : cps[j - 1], cps[j], cps[j + 1], baldes);
+
+        // Insercao ordenada, descartando repetidos (poucas dezenas de itens)
+        int k = m;
+        while (k > 0 && out[k - 1] > b) k--;
+        if (k > 0 && out[k - 1] == b) continue;
+        for (int i = m; i > k; i--) out[i] = out[i - 1];
+        out[k] = b;
+        m++;
+    }
+    return m;
+}
+
+/**
+ * (Re)constroi o indice de trigramas da busca aproximada.
+ * 
+ * A primeira passada dobra cada nome, guarda os baldes dos seus trigramas
+ * e conta o tamanho de cada balde; a segunda espalha os times pelas
+ * listas (cada uma em ordem crescente de indice).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_aproximado(BDTimes *bd) {
+    if (!indices_proprios(bd)) return 0;
+    int baldes = APROX_MIN_BALDES;
+    while (baldes < bd->n && baldes < APROX_MAX_BALDES) baldes *= 2;
+
+    unsigned int *inicio = mem_alocar(MEM_INDICES, (size_t)(baldes + 1) * sizeof(unsigned int));
+    if (!inicio) return 0;
+    memset(inicio, 0, (size_t)(baldes + 1) * sizeof(unsigned int));
+
+    // Baldes de cada time, em sequencia: os do time i comecam em
+    // bs[pos[i]] (pos tem n + 1 posicoes)
+    size_t cap_bs = (size_t)bd->n * 16 + APROX_MAX_CPS;
+    unsigned int *bs = mem_alocar(MEM_INDICES, cap_bs * sizeof(unsigned int));
+    unsigned int *pos = mem_alocar(MEM_INDICES, ((size_t)bd->n + 1) * sizeof(unsigned int));
+    if (!bs || !pos) {
+        mem_liberar(bs);
+        mem_liberar(pos);
+        mem_liberar(inicio);
         return 0;
     }
 
-    // Define as larguras de cada coluna para alinhamento consistente
-    // Estas larguras devem ser suficientes para acomodar os dados mais longos
-    const int W_ID   = 3;   // Largura para o ID do time
-    const int W_TIME = 12;  // Largura para o nome do time
-    const int W_V    = 2;   // Largura para vitorias
-    const int W_E    = 2;   // Largura para empates
-    const int W_D    = 2;   // Largura para derrotas
-    const int W_GM   = 3;   // Largura para gols marcados
-    const int W_GS   = 3;   // Largura para gols sofridos
-    const int W_S    = 3;   // Largura para saldo de gols
-    const int W_PG   = 3;   // Largura para pontos ganhos
-
-    // Escreve a linha de cabecalho com os nomes das colunas
-    fprintf(f, "| %-*s | %-*s | %-*s | %-*s | %-*s | %-*s | %-*s | %-*s | %-*s |\n",
-            W_ID, "ID", W_TIME, "Time", W_V, "V", W_E, "E", W_D, "D",
-            W_GM, "GM", W_GS, "GS", W_S, "S", W_PG, "PG");
-
-    // Escreve a linha separadora usando hifens para cada coluna
-    fprintf(f, "|-");
-    for (int i = 0; i < W_ID; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_TIME; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_V; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_E; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_D; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_GM; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_GS; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_S; i++) fputc('-', f);
-    fprintf(f, "-|-");
-    for (int i = 0; i < W_PG; i++) fputc('-', f);
-    fprintf(f, "-|\n");
-
-    // Percorre todos os IDs possiveis de 0 a 9999
-    // Esta abordagem garante que os times sejam exportados em ordem crescente de ID
-    for (int id = 0; id < 10000; id++) {
-        // Para cada ID, procura se existe um time correspondente
-        for (int i = 0; i < bd->n; i++) {
-            if (bd->times[i].id == id) {
-                // Time encontrado! Vamos escrever seus dados no arquivo
-                const Time *t = &bd->times[i];
-                
-                // Calcula os valores derivados (saldo e pontos)
-                int saldo = time_saldo(t);     // Saldo = gols marcados - gols sofridos
-                int pontos = time_pontos(t);   // Pontos = 3*vitorias + empates
-                
-                // Escreve uma linha formatada com todos os dados do time
-                // Usa formatacao com largura fixa (%-*s para strings, %-*d para numeros)
-                // O hifen (-) indica alinhamento a esquerda
-                fprintf(f, "| %-*d | %-*s | %-*d | %-*d | %-*d | %-*d | %-*d | %-*d | %-*d |\n",
-                        W_ID, t->id,           // ID do time
-                        W_TIME, t->nome,       // Nome do time
-                        W_V, t->v,             // Vitorias
-                        W_E, t->e,             // Empates
-                        W_D, t->d,             // Derrotas
-                        W_GM, t->gm,           // Gols marcados
-                        W_GS, t->gs,           // Gols sofridos
-                        W_S, saldo,            // Saldo de gols
-                        W_PG, pontos);         // Pontos ganhos
+    // 1a passada: baldes de cada nome e tamanho de cada balde, contado
+    // em inicio[b + 1]
+    unsigned int cps[APROX_MAX_CPS];
+    size_t total = 0;
+    for (int i = 0; i < bd->n; i++) {
+        if (total + APROX_MAX_CPS > cap_bs) {
+            unsigned int *maior = mem_realocar(MEM_INDICES, bs, cap_bs * 2 * sizeof(unsigned int));
+            if (!maior) {
+                mem_liberar(bs);
+                mem_liberar(pos);
+                mem_liberar(inicio);
+                return 0;
             }
+            bs = maior;
+            cap_bs *= 2;
         }
+        pos[i] = (unsigned int)total;
+        int n = utf8_dobrar(bdtimes_time(bd, i)->nome, cps, APROX_MAX_CPS);
+        int m = baldes_trigramas(cps, n, baldes, bs + total);
+        for (int k = 0; k < m; k++) inicio[bs[total + k] + 1]++;
+        total += (size_t)m;
     }
+    pos[bd->n] = (unsigned int)total;
+    for (int b = 0; b < baldes; b++) inicio[b + 1] += inicio[b];
 
-    // Fecha o arquivo apos escrever todos os dados
-    fclose(f);
-    
-    // Informa ao usuario que o arquivo foi criado com sucesso
-    printf("[Sistema] Arquivo '%s' criado/atualizado com sucesso.\n", nome_arquivo);
-    
-    return 1;  // Retorna 1 indicando sucesso na operacao
+    int *times = mem_alocar(MEM_INDICES, (total ? total : 1) * sizeof(int));
+    if (!times) {
+        mem_liberar(bs);
+        mem_liberar(pos);
+        mem_liberar(inicio);
+        return 0;
+    }
+
+    // 2a passada: inicio[b] serve de cursor do balde b e termina no
+    // inicio do balde b + 1; o deslocamento final restaura os inicios
+    for (int i = 0; i < bd->n; i++) {
+        for (unsigned int k = pos[i]; k < pos[i + 1]; k++) times[inicio[bs[k]]++] = i;
+    }
+    memmove(inicio + 1, inicio, (size_t)baldes * sizeof(unsigned int));
+    inicio[0] = 0;
+    mem_liberar(bs);
+    mem_liberar(pos);
+
+    mem_liberar(bd->aprox.inicio);
+    mem_liberar(bd->aprox.times);
+    bd->aprox.inicio = inicio;
+    bd->aprox.times = times;
+    bd->aprox.baldes = baldes;
+    bd->aprox.n = bd->n;
+    return 1;
 }
 
 /**
- * Imprime a tabela de classificacao dos times na tela em formato visual.
- * Alem de imprimir na tela, esta funcao tambem exporta os dados para um arquivo CSV.
+ * Numero maximo de edicoes toleradas para um texto de n code points.
+ */
+static int aprox_limite(int n) {
+    return n <= 4 ? 0 : n <= 10 ? 1 : 2;
+}
+
+/**
+ * Distancia de edicao entre um texto e o prefixo mais proximo de um nome
+ * (ambos dobrados), limitada a k.
  * 
- * A tabela e impressa com colunas alinhadas e separadas por pipes (|) para facilitar
- * a leitura. Os times sao ordenados por ID de forma crescente.
+ * Programacao dinamica linha a linha (uma linha por caractere do texto);
+ * para assim que todos os valores de uma linha passam de k.
  * 
- * Colunas exibidas:
- * - ID: Identificador unico do time
- * - Time: Nome do time (truncado se muito longo)
- * - V: Numero de vitorias
- * - E: Numero de empates
- * - D: Numero de derrotas
- * - GM: Gols marcados pelo time
- * - GS: Gols sofridos pelo time
- * - S: Saldo de gols (GM - GS)
- * - PG: Pontos ganhos (3*V + E)
+ * @param q Texto
+ * @param nq Code points do texto
+ * @param s Nome (basta os nq + k primeiros code points)
+ * @param ns Code points do nome
+ * @param k Distancia maxima de interesse
+ * @return Distancia (0 a k), ou k + 1 se passar de k
+ */
+static int distancia_prefixo(const unsigned int *q, int nq, const unsigned int *s, int ns, int k) {
+    int linha[APROX_MAX_CPS + 1];   // linha[j]: distancia entre q[0..i) e s[0..j)
+    for (int j = 0; j <= ns; j++) linha[j] = j;
+
+    for (int i = 1; i <= nq; i++) {
+        int diag = linha[0];
+        linha[0] = i;
+        int menor = i;
+        for (int j = 1; j <= ns; j++) {
+            int cima = linha[j];
+            int v = diag + (q[i - 1] != s[j - 1]);
+            if (cima + 1 < v) v = cima + 1;
+            if (linha[j - 1] + 1 < v) v = linha[j - 1] + 1;
+            diag = cima;
+            linha[j] = v;
+            if (v < menor) menor = v;
+        }
+        if (menor > k) return k + 1;
+    }
+
+    int d = k + 1;
+    for (int j = 0; j <= ns; j++) {
+        if (linha[j] < d) d = linha[j];
+    }
+    return d;
+}
+
+/**
+ * Comparador para qsort de achados (distancia nos 32 bits altos, indice
+ * nos baixos).
+ */
+static int cmp_achado(const void *a, const void *b) {
+    unsigned long long x = *(const unsigned long long*)a;
+    unsigned long long y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Busca times cujo nome comeca com algo parecido com o texto ja dobrado.
  * 
- * @param bd Ponteiro para a estrutura BDTimes contendo os dados dos times
+ * 1. Calcula k (aprox_limite()) e os T baldes distintos
+ *    dos seus trigramas
+ * 2. Conta, para cada time do indice, em quantas dessas listas ele
+ *    aparece; os que chegam a T - 3k viram candidatos (um nome a ate k
+ *    edicoes perde no maximo 3k trigramas). Times fora do indice (ou
+ *    todos, se T - 3k <= 0) tambem sao candidatos
+ * 3. Calcula a distancia de edicao de cada candidato e ordena os achados
+ * 
+ * Percorrer as listas inteiras com um contador por time saiu mais rapido
+ * que intercalar so as 3k + 1 menores e procurar os candidatos nas demais
+ * por busca binaria, mesmo com trigramas presentes em todos os nomes
+ * ("Time 123"): o contador e sequencial, a busca binaria nao.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar (com n > 0)
+ * @param q Code points do texto dobrado
+ * @param nq Quantidade de code points em q (> 0)
+ * @param indices Array onde os indices dos times encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode ser maior que max_indices), ou -1 se faltou memoria
  */
-void bdtimes_imprimir_classificacao(const BDTimes *bd) {
-    // Define as larguras visuais de cada coluna na tabela
-    // Estas larguras determinam quantos caracteres/espacos cada coluna ocupara
-    const int W_ID   = 3;   // Largura da coluna ID
-    const int W_TIME = 12;  // Largura da coluna Time (nomes serao truncados se excederem)
-    const int W_V    = 2;   // Largura da coluna Vitorias
-    const int W_E    = 2;   // Largura da coluna Empates
-    const int W_D    = 2;   // Largura da coluna Derrotas
-    const int W_GM   = 3;   // Largura da coluna Gols Marcados
-    const int W_GS   = 3;   // Largura da coluna Gols Sofridos
-    const int W_S    = 3;   // Largura da coluna Saldo
-    const int W_PG   = 3;   // Largura da coluna Pontos Ganhos
-
-    // Imprime o cabecalho da tabela com os nomes das colunas
-    printf("| "); print_utf8_padded("ID", W_ID);
-    printf(" | "); print_utf8_padded("Time", W_TIME);
-    printf(" | "); print_utf8_padded("V", W_V);
-    printf(" | "); print_utf8_padded("E", W_E);
-    printf(" | "); print_utf8_padded("D", W_D);
-    printf(" | "); print_utf8_padded("GM", W_GM);
-    printf(" | "); print_utf8_padded("GS", W_GS);
-    printf(" | "); print_utf8_padded("S", W_S);
-    printf(" | "); print_utf8_padded("PG", W_PG);
-    printf(" |\n");
-
-    // Imprime a linha separadora para alinhar visualmente a tabela
-    // Esta linha contem hifens sob cada coluna
-    printf("|-"); for (int i = 0; i < W_ID; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_TIME; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_V; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_E; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_D; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_GM; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_GS; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_S; i++) putchar('-');
-    printf("-|-"); for (int i = 0; i < W_PG; i++) putchar('-');
-    printf("-|\n");
-
-    // Percorre todos os IDs possiveis em ordem crescente (0 a 9999)
-    // Esta estrategia garante que a saida seja ordenada por ID
-    for (int id = 0; id < 10000; id++) {
-        // Para cada ID, verifica se existe um time correspondente no banco de dados
-        for (int i = 0; i < bd->n; i++) {
-            if (bd->times[i].id == id) {
-                // Time encontrado! Vamos imprimir seus dados
-                const Time *t = &bd->times[i];
-                char tmp[32];  // Buffer temporario para converter numeros em strings
-
-                // Imprime o ID do time
-                printf("| ");
-                snprintf(tmp, sizeof(tmp), "%d", t->id);
-                print_utf8_padded(tmp, W_ID);
-
-                // Imprime o nome do time (sera truncado com '...' se exceder W_TIME)
-                printf(" | ");
-                print_utf8_padded(t->nome, W_TIME);
-
-                // Imprime o numero de vitorias
-                printf(" | ");
-                snprintf(tmp, sizeof(tmp), "%d", t->v);
-                print_utf8_padded(tmp, W_V);
-
-                // Imprime o numero de empates
-                printf(" | ");
-                snprintf(tmp, sizeof(tmp), "%d", t->e);
-                print_utf8_padded(tmp, W_E);
-
-                // Imprime o numero de derrotas
-                printf(" | ");
-                snprintf(tmp, sizeof(tmp), "%d", t->d);
-                print_utf8_padded(tmp, W_D);
-
-                // Imprime os gols marcados
-                printf(" | ");
-                snprintf(tmp, sizeof(tmp), "%d", t->gm);
-                print_utf8_padded(tmp, W_GM);
-
-                // Imprime os gols sofridos
-                printf(" | ");
-                snprintf(tmp, sizeof(tmp), "%d", t->gs);
-                print_utf8_padded(tmp, W_GS);
-
-                // Imprime o saldo de gols (calculado pela funcao time_saldo)
-                printf(" | ");
-                snprintf(tmp, sizeof(tmp), "%d", time_saldo(t));
-                print_utf8_padded(tmp, W_S);
-
-                // Imprime os pontos ganhos (calculado pela funcao time_pontos)
-                printf(" | ");
-                snprintf(tmp, sizeof(tmp), "%d", time_pontos(t));
-                print_utf8_padded(tmp, W_PG);
-
-                printf(" |\n");
+static int buscar_aproximado_dobrado(const BDTimes *bd, const unsigned int *q, int nq,
+                                     int *indices, int max_indices) {
+    const IndiceAprox *ix = &bd->aprox;
+    unsigned int bq[APROX_MAX_CPS];
+
+    int k = aprox_limite(nq);
+    int nb = ix->baldes ? baldes_trigramas(q, nq, ix->baldes, bq) : 0;
+    int minimo = nb - 3 * k;
+
+    int *cand = mem_alocar(MEM_INDICES, (size_t)bd->n * sizeof(int));
+    if (!cand) return -1;
+    int ncand = 0;
+
+    // Filtro pelos trigramas
+    int coberto = 0;
+    if (minimo > 0) {
+        unsigned char *cont = mem_alocar(MEM_INDICES, (size_t)ix->n + 1);
+        if (!cont) {
+            mem_liberar(cand);
+            return -1;
+        }
+        memset(cont, 0, (size_t)ix->n + 1);
+        for (int b = 0; b < nb; b++) {
+            for (unsigned int p = ix->inicio[bq[b]]; p < ix->inicio[bq[b] + 1]; p++) {
+                int t = ix->times[p];
+                if (++cont[t] == minimo) cand[ncand++] = t;
             }
         }
+        mem_liberar(cont);
+        coberto = ix->n;
+    }
+    for (int i = coberto; i < bd->n; i++) cand[ncand++] = i;
+
+    // Verificacao; os achados sao pares (distancia, indice)
+    unsigned long long *achados = mem_alocar(MEM_INDICES, (size_t)(ncand ? ncand : 1) * sizeof(unsigned long long));
+    if (!achados) {
+        mem_liberar(cand);
+        return -1;
+    }
+    int found = 0;
+    unsigned int s[APROX_MAX_CPS];
+    int max_s = nq + k < APROX_MAX_CPS ? nq + k : APROX_MAX_CPS;
+    for (int c = 0; c < ncand; c++) {
+        int ns = utf8_dobrar(bdtimes_time(bd, cand[c])->nome, s, max_s);
+        int d = distancia_prefixo(q, nq, s, ns, k);
+        if (d <= k) achados[found++] = ((unsigned long long)d << 32) | (unsigned int)cand[c];
+    }
+    mem_liberar(cand);
+
+    qsort(achados, (size_t)found, sizeof(unsigned long long), cmp_achado);
+    for (int i = 0; i < found && i < max_indices; i++) {
+        indices[i] = (int)(achados[i] & 0xFFFFFFFFu);
+    }
+    mem_liberar(achados);
+    return found;
+}
+
+/**
+ * Busca times de nome parecido com o texto (ver bd_times.h).
+ * 
+ * Texto vazio (ou so com caracteres ignorados) nao encontra nada, mas
+ * conta como uma busca nas metricas, como as demais.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param texto Texto digitado
+ * @param indices Array onde os indices encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+int bdtimes_buscar_aproximado(const BDTimes *bd, const char *texto, int *indices, int max_indices) {
+    unsigned long long inicio = metricas_agora_ns();
+
+    unsigned int q[APROX_MAX_CPS];
+    int nq = utf8_dobrar(texto, q, APROX_MAX_CPS);
+    int found = 0;
+    if (nq > 0 && bd->n > 0) found = buscar_aproximado_dobrado(bd, q, nq, indices, max_indices);
+
+    metricas_somar(MET_BUSCAS_TIMES, 1);
+    metricas_latencia(LAT_BUSCA_APROX, metricas_tempo(MET_NS_BUSCA, inicio));
+    return found;
+}
+
+// ========== Busca por trecho ==========
+
+// Buckets menores que isso sao ordenados por insercao
+#define SUFIXOS_INSERCAO 32
+
+/**
+ * Ordena sufixos por radix sort MSD (um byte por nivel).
+ * 
+ * Os sufixos ja tem em comum os 'd' primeiros bytes. Cada nivel distribui
+ * os sufixos pelo byte d, de forma estavel, e ordena recursivamente cada
+ * grupo; o grupo do '\0' (fim do nome) ja esta pronto. Como a entrada
+ * comeca em ordem de posicao e todos os passos sao estaveis, sufixos
+ * iguais ficam em ordem de posicao. O custo e proporcional ao prefixo
+ * que distingue cada sufixo (no maximo o tamanho do nome).
+ * 
+ * @param texto Nomes dobrados, cada um terminado em '\0'
+ * @param suf Sufixos a ordenar
+ * @param tmp Area auxiliar com n posicoes
+ * @param n Numero de sufixos
+ * @param d Bytes ja comparados
+ */
+static void ordenar_sufixos(const unsigned char *texto, int *suf, int *tmp, int n, int d) {
+    if (n < SUFIXOS_INSERCAO) {
+        for (int i = 1; i < n; i++) {
+            int s = suf[i];
+            int j = i;
+            while (j > 0 && strcmp((const char*)texto + suf[j - 1] + d, (const char*)texto + s + d) > 0) {
+                suf[j] = suf[j - 1];
+                j--;
+            }
+            suf[j] = s;
+        }
+        return;
+    }
+
+    int inicio[257] = { 0 };
+    for (int i = 0; i < n; i++) inicio[texto[suf[i] + d] + 1]++;
+    for (int c = 0; c < 256; c++) inicio[c + 1] += inicio[c];
+
+    int pos[256];
+    memcpy(pos, inicio, sizeof(pos));
+    for (int i = 0; i < n; i++) tmp[pos[texto[suf[i] + d]]++] = suf[i];
+    memcpy(suf, tmp, (size_t)n * sizeof(int));
+
+    for (int c = 1; c < 256; c++) {
+        int tam = inicio[c + 1] - inicio[c];
+        if (tam > 1) ordenar_sufixos(texto, suf + inicio[c], tmp, tam, d + 1);
+    }
+}
+
+/**
+ * (Re)constroi o indice de sufixos da busca por trecho.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_infixo(BDTimes *bd) {
+    if (!indices_proprios(bd)) return 0;
+    // Um byte invalido vira U+FFFD (3 bytes): 3 bytes por byte do nome
+    // e um limite seguro para o texto dobrado
+    size_t cap = 1;
+    for (int i = 0; i < bd->n; i++) cap += 3 * (size_t)bdtimes_time(bd, i)->nome_bytes + 1;
+
+    char *texto = mem_alocar(MEM_INDICES, cap);
+    int *inicio_nome = mem_alocar(MEM_INDICES, ((size_t)bd->n + 1) * sizeof(int));
+    if (!texto || !inicio_nome) {
+        mem_liberar(texto);
+        mem_liberar(inicio_nome);
+        return 0;
+    }
+
+    size_t usado = 0;
+    int num_sufixos = 0;
+    for (int i = 0; i < bd->n; i++) {
+        inicio_nome[i] = (int)usado;
+        int bytes = utf8_dobrar_str(bdtimes_time(bd, i)->nome, texto + usado, 3 * MAX_NOME_TIME);
+        for (int k = 0; k < bytes; k++) {
+            num_sufixos += ((unsigned char)texto[usado + k] & 0xC0) != 0x80;
+        }
+        usado += (size_t)bytes + 1;
+    }
+    inicio_nome[bd->n] = (int)usado;
+
+    int *sufixos = mem_alocar(MEM_INDICES, (num_sufixos ? (size_t)num_sufixos : 1) * sizeof(int));
+    int *tmp = mem_alocar(MEM_INDICES, (num_sufixos ? (size_t)num_sufixos : 1) * sizeof(int));
+    if (!sufixos || !tmp) {
+        mem_liberar(sufixos);
+        mem_liberar(tmp);
+        mem_liberar(texto);
+        mem_liberar(inicio_nome);
+        return 0;
+    }
+
+    // Sufixos que comecam um caractere (nem '\0' nem byte de continuacao)
+    int k = 0;
+    for (size_t p = 0; p < usado; p++) {
+        unsigned char b = (unsigned char)texto[p];
+        if (b != 0 && (b & 0xC0) != 0x80) sufixos[k++] = (int)p;
+    }
+    ordenar_sufixos((const unsigned char*)texto, sufixos, tmp, num_sufixos, 0);
+    mem_liberar(tmp);
+
+    mem_liberar(bd->infixo.texto);
+    mem_liberar(bd->infixo.sufixos);
+    mem_liberar(bd->infixo.inicio_nome);
+    bd->infixo.texto = texto;
+    bd->infixo.sufixos = sufixos;
+    bd->infixo.inicio_nome = inicio_nome;
+    bd->infixo.num_sufixos = num_sufixos;
+    bd->infixo.n = bd->n;
+    return 1;
+}
+
+/**
+ * Encontra o primeiro sufixo cujos m primeiros bytes sao >= (ou >, se
+ * 'estrito') ao trecho.
+ * 
+ * @param ix Indice de sufixos
+ * @param trecho Trecho dobrado
+ * @param m Bytes do trecho
+ * @param estrito 0 para o limite inferior, 1 para o superior
+ * @return Posicao em ix->sufixos
+ */
+static int limite_sufixos(const IndiceInfixo *ix, const char *trecho, size_t m, int estrito) {
+    int lo = 0, hi = ix->num_sufixos;
+    while (lo < hi) {
+        int meio = lo + (hi - lo) / 2;
+        int c = strncmp(ix->texto + ix->sufixos[meio], trecho, m);
+        if (c < 0 || (estrito && c == 0)) lo = meio + 1;
+        else hi = meio;
+    }
+    return lo;
+}
+
+/**
+ * Encontra o time dono de uma posicao do texto do indice.
+ * 
+ * @param ix Indice de sufixos
+ * @param p Posicao em ix->texto
+ * @return Indice do time
+ */
+static int dono_posicao(const IndiceInfixo *ix, int p) {
+    int lo = 0, hi = ix->n;   // inicio_nome[lo] <= p < inicio_nome[hi]
+    while (hi - lo > 1) {
+        int meio = lo + (hi - lo) / 2;
+        if (ix->inicio_nome[meio] <= p) lo = meio;
+        else hi = meio;
+    }
+    return lo;
+}
+
+/**
+ * Comparador para qsort de indices de times.
+ */
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Busca times cujo nome contem um trecho (dobrado).
+ * 
+ * 1. Duas buscas binarias delimitam os sufixos que comecam com o trecho
+ * 2. Cada sufixo e convertido no time dono (busca binaria em inicio_nome)
+ * 3. Os times sao ordenados e os repetidos (trecho que aparece mais de
+ *    uma vez no nome) descartados
+ * 4. Times fora do indice sao verificados com strstr()
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar (com n > 0)
+ * @param q Trecho dobrado
+ * @param m Tamanho de q em bytes (> 0)
+ * @param indices Array onde os indices dos times encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode ser maior que max_indices), ou -1 se faltou memoria
+ */
+static int buscar_infixo_dobrado(const BDTimes *bd, const char *q, size_t m, int *indices, int max_indices) {
+    const IndiceInfixo *ix = &bd->infixo;
+
+    int lo = 0, hi = 0;
+    if (ix->n > 0) {
+        lo = limite_sufixos(ix, q, m, 0);
+        hi = limite_sufixos(ix, q, m, 1);
+    }
+
+    int *achados = mem_alocar(MEM_INDICES, ((size_t)(hi - lo) + (size_t)(bd->n - ix->n) + 1) * sizeof(int));
+    if (!achados) return -1;
+    int n = 0;
+    for (int i = lo; i < hi; i++) achados[n++] = dono_posicao(ix, ix->sufixos[i]);
+    qsort(achados, (size_t)n, sizeof(int), cmp_int);
+
+    int found = 0;
+    for (int i = 0; i < n; i++) {
+        if (i > 0 && achados[i] == achados[i - 1]) continue;
+        achados[found++] = achados[i];
+    }
+
+    // Times acrescentados depois da indexacao
+    for (int i = ix->n; i < bd->n; i++) {
+        char nome[3 * MAX_NOME_TIME];
+        utf8_dobrar_str(bdtimes_time(bd, i)->nome, nome, (int)sizeof(nome));
+        if (strstr(nome, q)) achados[found++] = i;
+    }
+
+    for (int i = 0; i < found && i < max_indices; i++) indices[i] = achados[i];
+    mem_liberar(achados);
+    return found;
+}
+
+/**
+ * Busca times cujo nome contem um trecho (ver bd_times.h).
+ * 
+ * Trecho vazio nao encontra nada, mas conta como uma busca nas metricas,
+ * como as demais.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param trecho Trecho procurado
+ * @param indices Array onde os indices encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+int bdtimes_buscar_infixo(const BDTimes *bd, const char *trecho, int *indices, int max_indices) {
+    unsigned long long inicio = metricas_agora_ns();
+
+    char q[3 * MAX_NOME_TIME];
+    size_t m = (size_t)utf8_dobrar_str(trecho, q, (int)sizeof(q));
+    int found = 0;
+    if (m > 0 && bd->n > 0) found = buscar_infixo_dobrado(bd, q, m, indices, max_indices);
+
+    metricas_somar(MET_BUSCAS_TIMES, 1);
+    metricas_latencia(LAT_BUSCA_INFIXO, metricas_tempo(MET_NS_BUSCA, inicio));
+    return found;
+}
+
+// ========== Indice de nomes ==========
+
+/**
+ * Ordena textos sem diferenciar caixa ASCII.
+ * 
+ * Os textos vao, em minusculas, para um texto unico, cada um precedido
+ * pela sua posicao em 'textos' (4 bytes) e terminado em '\0', e sao
+ * ordenados pelo mesmo radix sort dos sufixos (cada texto e o "sufixo"
+ * que comeca no seu inicio). Por ser estavel, textos iguais ficam na
+ * ordem original.
+ * 
+ * @param textos Textos a ordenar
+ * @param n Numero de textos
+ * @param ordem Saida: inicio de cada texto (ja em minusculas) no texto
+ *              unico, em ordem; a posicao original esta nos 4 bytes antes
+ * @return Texto unico (liberar com mem_liberar), ou NULL se faltou memoria
+ */
+static unsigned char* ordenar_minusculas(const char *const *textos, int n, int *ordem) {
+    size_t cap = 1;
+    for (int i = 0; i < n; i++) cap += sizeof(int) + strlen(textos[i]) + 1;
+
+    unsigned char *texto = mem_alocar(MEM_INDICES, cap);
+    int *tmp = mem_alocar(MEM_INDICES, (n ? (size_t)n : 1) * sizeof(int));
+    if (!texto || !tmp) {
+        mem_liberar(texto);
+        mem_liberar(tmp);
+        return NULL;
+    }
+
+    int usado = 0;
+    for (int i = 0; i < n; i++) {
+        memcpy(texto + usado, &i, sizeof(int));
+        usado += (int)sizeof(int);
+        ordem[i] = usado;
+        for (const char *c = textos[i]; *c; c++) {
+            texto[usado++] = (unsigned char)tolower((unsigned char)*c);
+        }
+        texto[usado++] = '\0';
+    }
+    ordenar_sufixos(texto, ordem, tmp, n, 0);
+    mem_liberar(tmp);
+    return texto;
+}
+
+/**
+ * Posicao original de um texto ordenado por ordenar_minusculas().
+ */
+static int posicao_original(const unsigned char *texto, int inicio) {
+    int i;
+    memcpy(&i, texto + inicio - sizeof(int), sizeof(int));
+    return i;
+}
+
+/**
+ * (Re)constroi o indice de nomes em ordem alfabetica.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @return 1 se sucesso, 0 se faltou memoria (o indice anterior e mantido)
+ */
+int bdtimes_indexar_nomes(BDTimes *bd) {
+    if (!indices_proprios(bd)) return 0;
+    size_t itens = bd->n ? (size_t)bd->n : 1;
+    const char **nomes = mem_alocar(MEM_INDICES, itens * sizeof(const char*));
+    int *ordem = mem_alocar(MEM_INDICES, itens * sizeof(int));
+    if (!nomes || !ordem) {
+        mem_liberar(nomes);
+        mem_liberar(ordem);
+        return 0;
+    }
+    for (int i = 0; i < bd->n; i++) nomes[i] = bdtimes_time(bd, i)->nome;
+
+    unsigned char *texto = ordenar_minusculas(nomes, bd->n, ordem);
+    mem_liberar(nomes);
+    if (!texto) {
+        mem_liberar(ordem);
+        return 0;
+    }
+    for (int i = 0; i < bd->n; i++) ordem[i] = posicao_original(texto, ordem[i]);
+    mem_liberar(texto);
+
+    mem_liberar(bd->nomes.ordem);
+    bd->nomes.ordem = ordem;
+    bd->nomes.n = bd->n;
+    return 1;
+}
+
+/**
+ * Restringe uma faixa do indice de nomes a um caractere a mais do prefixo.
+ * 
+ * Duas buscas binarias pelo byte 'pos' (em minusculas) dos nomes da
+ * faixa: o primeiro >= c e o primeiro > c. Um nome com exatamente 'pos'
+ * bytes tem '\0' nessa posicao e fica antes de qualquer c.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param faixa Faixa do prefixo de 'pos' bytes (atualizada)
+ * @param pos Bytes do prefixo ja consumidos
+ * @param c Proximo byte do prefixo
+ * @return Numero de times na nova faixa
+ */
+int bdtimes_estreitar_faixa(const BDTimes *bd, FaixaNomes *faixa, int pos, char c) {
+    const int *ordem = bd->nomes.ordem;
+    unsigned char alvo = (unsigned char)tolower((unsigned char)c);
+
+    int lo = faixa->inicio, hi = faixa->fim;
+    while (lo < hi) {
+        int meio = lo + (hi - lo) / 2;
+        unsigned char b = (unsigned char)tolower((unsigned char)bdtimes_time(bd, ordem[meio])->nome[pos]);
+        if (b < alvo) lo = meio + 1; else hi = meio;
+    }
+    int inicio = lo;
+    hi = faixa->fim;
+    while (lo < hi) {
+        int meio = lo + (hi - lo) / 2;
+        unsigned char b = (unsigned char)tolower((unsigned char)bdtimes_time(bd, ordem[meio])->nome[pos]);
+        if (b <= alvo) lo = meio + 1; else hi = meio;
+    }
+    faixa->inicio = inicio;
+    faixa->fim = lo;
+    return lo - inicio;
+}
+
+/**
+ * Calcula a faixa do indice de nomes de um prefixo inteiro.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param prefixo Prefixo do nome
+ * @param faixa Faixa resultante
+ * @return Numero de times na faixa
+ */
+int bdtimes_faixa_prefixo(const BDTimes *bd, const char *prefixo, FaixaNomes *faixa) {
+    faixa->inicio = 0;
+    faixa->fim = bd->nomes.n;
+    for (int pos = 0; prefixo[pos] && faixa->inicio < faixa->fim; pos++) {
+        bdtimes_estreitar_faixa(bd, faixa, pos, prefixo[pos]);
+    }
+    return faixa->fim - faixa->inicio;
+}
+
+// ========== Busca de varios prefixos ==========
+
+/**
+ * Compara um nome com um prefixo ja em minusculas, so nos bytes do
+ * prefixo (a ordem do indice de nomes).
+ * 
+ * @param nome Nome do time
+ * @param chave Prefixo em minusculas
+ * @return < 0 se o nome vem antes dos que comecam com o prefixo, 0 se
+ *         comeca com ele, > 0 se vem depois
+ */
+static int cmp_nome_chave(const char *nome, const unsigned char *chave) {
+    for (; *chave; nome++, chave++) {
+        unsigned char b = (unsigned char)tolower((unsigned char)*nome);
+        if (b != *chave) return b < *chave ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Busca galopante no indice de nomes: a primeira posicao a partir de
+ * 'de' cujo nome compara com a chave como >= 0 (ou > 0, se 'estrito').
+ * 
+ * Dobra o passo a partir de 'de' ate passar do alvo e termina com uma
+ * busca binaria no ultimo intervalo: custa O(log d), com d a distancia
+ * ate o alvo.
+ * 
+ * @param bd Base de times
+ * @param de Primeira posicao candidata
+ * @param chave Prefixo em minusculas
+ * @param estrito 0 para o limite inferior, 1 para o superior
+ * @return Posicao em bd->nomes.ordem (nomes.n se nenhuma)
+ */
+static int galopar_nomes(const BDTimes *bd, int de, const unsigned char *chave, int estrito) {
+    const int *ordem = bd->nomes.ordem;
+    int n = bd->nomes.n;
+    int lo = de, hi = de, passo = 1;
+    while (hi < n && cmp_nome_chave(bdtimes_time(bd, ordem[hi])->nome, chave) < estrito) {
+        lo = hi + 1;
+        hi = de + passo;
+        passo *= 2;
+    }
+    if (hi > n) hi = n;
+    while (lo < hi) {
+        int meio = lo + (hi - lo) / 2;
+        if (cmp_nome_chave(bdtimes_time(bd, ordem[meio])->nome, chave) < estrito) lo = meio + 1; else hi = meio;
+    }
+    return lo;
+}
+
+// Faixas menores que isso voltam a ordem de posicao por qsort
+#define LOTE_MIN_RADIX 256
+
+/**
+ * Ordena posicoes de times (0 <= v[i] < limite) por radix sort LSD, um
+ * byte por passada, so com as passadas que o limite exige.
+ * 
+ * @param v Posicoes a ordenar
+ * @param tmp Area auxiliar com n posicoes
+ * @param n Numero de posicoes
+ * @param limite Maior posicao possivel + 1
+ */
+static void ordenar_posicoes(int *v, int *tmp, int n, int limite) {
+    for (int desloc = 0; desloc < 31 && (limite - 1) >> desloc; desloc += 8) {
+        int inicio[257] = { 0 };
+        for (int i = 0; i < n; i++) inicio[((v[i] >> desloc) & 0xFF) + 1]++;
+        for (int c = 0; c < 256; c++) inicio[c + 1] += inicio[c];
+        for (int i = 0; i < n; i++) tmp[inicio[(v[i] >> desloc) & 0xFF]++] = v[i];
+        memcpy(v, tmp, (size_t)n * sizeof(int));
+    }
+}
+
+/**
+ * Resolve as faixas de todos os prefixos e monta os indices do lote.
+ * 
+ * @param bd Base de times
+ * @param prefixos Prefixos, na ordem de entrada
+ * @param n Numero de prefixos
+ * @param chaves Prefixos em minusculas (ordenar_minusculas())
+ * @param ordem Inicio de cada chave, em ordem
+ * @param faixas Area auxiliar (n posicoes)
+ * @param extras Area auxiliar (n posicoes)
+ * @param inicio Saida: inicio dos times de cada prefixo (n + 1 posicoes)
+ * @return Indices dos times (liberar com mem_liberar), ou NULL se faltou memoria
+ */
+static int* resolver_prefixos(const BDTimes *bd, const char *const *prefixos, int n,
+                              const unsigned char *chaves, const int *ordem,
+                              FaixaNomes *faixas, int *extras, int *inicio) {
+    // Passada unica pelo indice, com os prefixos em ordem
+    int cursor = 0;
+    const unsigned char *anterior = NULL;
+    FaixaNomes faixa = { 0, 0 };
+    for (int k = 0; k < n; k++) {
+        const unsigned char *chave = chaves + ordem[k];
+        if (!anterior || strcmp((const char*)chave, (const char*)anterior) != 0) {
+            faixa.inicio = galopar_nomes(bd, cursor, chave, 0);
+            faixa.fim = galopar_nomes(bd, faixa.inicio, chave, 1);
+            cursor = faixa.inicio;
+            anterior = chave;
+        }
+        faixas[posicao_original(chaves, ordem[k])] = faixa;
+    }
+
+    // Times acrescentados depois da indexacao, um a um
+    for (int i = 0; i < n; i++) {
+        extras[i] = 0;
+        for (int t = bd->nomes.n; t < bd->n; t++) {
+            extras[i] += str_starts_with_case_insensitive(bdtimes_time(bd, t)->nome, prefixos[i]);
+        }
+    }
+
+    inicio[0] = 0;
+    for (int i = 0; i < n; i++) inicio[i + 1] = inicio[i] + (faixas[i].fim - faixas[i].inicio) + extras[i];
+    int maior = 0;
+    for (int i = 0; i < n; i++) {
+        if (faixas[i].fim - faixas[i].inicio > maior) maior = faixas[i].fim - faixas[i].inicio;
+    }
+    int *indices = mem_alocar(MEM_INDICES, (inicio[n] ? (size_t)inicio[n] : 1) * sizeof(int));
+    int *tmp = maior >= LOTE_MIN_RADIX ? mem_alocar(MEM_INDICES, (size_t)maior * sizeof(int)) : NULL;
+    if (!indices || (maior >= LOTE_MIN_RADIX && !tmp)) {
+        mem_liberar(indices);
+        mem_liberar(tmp);
+        return NULL;
+    }
+
+    // Cada faixa vai para a posicao do seu prefixo, em ordem de posicao
+    // na base (a mesma de bdtimes_buscar_por_prefixo)
+    for (int i = 0; i < n; i++) {
+        int *saida = indices + inicio[i];
+        int tam = faixas[i].fim - faixas[i].inicio;
+        if (tam > 0) memcpy(saida, bd->nomes.ordem + faixas[i].inicio, (size_t)tam * sizeof(int));
+        if (tam >= LOTE_MIN_RADIX) {
+            ordenar_posicoes(saida, tmp, tam, bd->nomes.n);
+        } else if (tam > 1) {
+            qsort(saida, (size_t)tam, sizeof(int), cmp_int);
+        }
+        for (int t = bd->nomes.n; extras[i] > 0 && t < bd->n; t++) {
+            if (str_starts_with_case_insensitive(bdtimes_time(bd, t)->nome, prefixos[i])) saida[tam++] = t;
+        }
+    }
+    mem_liberar(tmp);
+    return indices;
+}
+
+/**
+ * Busca os times de varios prefixos de uma vez.
+ * 
+ * Os prefixos sao postos em minusculas e ordenados uma unica vez
+ * (ordenar_minusculas()). Em ordem, o limite inferior da faixa de cada
+ * um nunca fica antes do anterior, entao uma unica passada pelo indice
+ * de nomes resolve todos: cada limite e achado galopando a partir do
+ * anterior, e prefixos repetidos reaproveitam a faixa.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param prefixos Prefixos a buscar
+ * @param n Numero de prefixos
+ * @param lote Resultado (liberar com bdtimes_liberar_lote)
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_buscar_prefixos(const BDTimes *bd, const char *const *prefixos, int n, LotePrefixos *lote) {
+    unsigned long long inicio_ns = metricas_agora_ns();
+    lote->inicio = NULL;
+    lote->indices = NULL;
+
+    size_t itens = n ? (size_t)n : 1;
+    int *ordem = mem_alocar(MEM_INDICES, itens * sizeof(int));
+    FaixaNomes *faixas = mem_alocar(MEM_INDICES, itens * sizeof(FaixaNomes));
+    int *extras = mem_alocar(MEM_INDICES, itens * sizeof(int));
+    int *inicio = mem_alocar(MEM_INDICES, ((size_t)n + 1) * sizeof(int));
+    unsigned char *chaves = ordem ? ordenar_minusculas(prefixos, n, ordem) : NULL;
+
+    int *indices = NULL;
+    if (faixas && extras && inicio && chaves) {
+        indices = resolver_prefixos(bd, prefixos, n, chaves, ordem, faixas, extras, inicio);
+    }
+    mem_liberar(ordem);
+    mem_liberar(faixas);
+    mem_liberar(extras);
+    mem_liberar(chaves);
+    if (!indices) {
+        mem_liberar(inicio);
+        return 0;
+    }
+    lote->inicio = inicio;
+    lote->indices = indices;
+
+    metricas_somar(MET_BUSCAS_TIMES, (unsigned long long)n);
+    metricas_latencia(LAT_BUSCA_LOTE, metricas_tempo(MET_NS_BUSCA, inicio_ns));
+    return 1;
+}
+
+/**
+ * Libera o resultado de bdtimes_buscar_prefixos().
+ * 
+ * @param lote Resultado a liberar
+ */
+void bdtimes_liberar_lote(LotePrefixos *lote) {
+    mem_liberar(lote->inicio);
+    mem_liberar(lote->indices);
+    lote->inicio = NULL;
+    lote->indices = NULL;
+}
+
+/**
+ * Busca times por texto em um dos modos de ModoBusca.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param modo Modo de busca
+ * @param texto Texto digitado
+ * @param indices Array onde os indices dos times encontrados serao armazenados
+ * @param max_indices Tamanho maximo do array indices
+ * @return Total de times encontrados (pode exceder max_indices), ou -1 se faltou memoria
+ */
+int bdtimes_buscar(const BDTimes *bd, ModoBusca modo, const char *texto, int *indices, int max_indices) {
+    switch (modo) {
+        case BUSCA_PREFIXO:    return bdtimes_buscar_por_prefixo(bd, texto, indices, max_indices);
+        case BUSCA_INFIXO:     return bdtimes_buscar_infixo(bd, texto, indices, max_indices);
+        case BUSCA_APROXIMADA: return bdtimes_buscar_aproximado(bd, texto, indices, max_indices);
+    }
+    return 0;
+}
+
+// Indices da primeira tentativa de bdtimes_buscar_todos: cobre quase todas
+// as buscas digitadas, sem precisar contar os resultados antes
+#define BUSCA_INDICES_INICIAL 256
+
+/**
+ * Busca times devolvendo todos os resultados num array alocado.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes onde buscar
+ * @param modo Modo de busca
+ * @param texto Texto digitado
+ * @param indices Saida: array alocado (NULL se nenhum resultado ou erro)
+ * @return Total de times encontrados, ou -1 se faltou memoria
+ */
+int bdtimes_buscar_todos(const BDTimes *bd, ModoBusca modo, const char *texto, int **indices) {
+    *indices = NULL;
+    int cap = BUSCA_INDICES_INICIAL;
+    int *v = mem_alocar(MEM_INDICES, (size_t)cap * sizeof(int));
+    if (!v) return -1;
+
+    int total = bdtimes_buscar(bd, modo, texto, v, cap);
+    if (total > cap) {
+        // Nao coube: refaz a busca com o tamanho exato
+        mem_liberar(v);
+        cap = total;
+        v = mem_alocar(MEM_INDICES, (size_t)cap * sizeof(int));
+        if (!v) return -1;
+        total = bdtimes_buscar(bd, modo, texto, v, cap);
+        if (total > cap) total = cap;
+    }
+    if (total <= 0) {
+        mem_liberar(v);
+        return total;
+    }
+    *indices = v;
+    return total;
+}
+
+/**
+ * Escreve uma lista de times (resultado de uma busca) em um escritor.
+ * 
+ * Formato de saida (uma linha por time, na ordem dos indices):
+ * | ID | Time | V | E | D | GM | GS | S | PG |
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes
+ * @param indices Indices dos times a escrever (posicoes na base)
+ * @param n Quantidade de indices
+ * @param w Escritor de destino
+ */
+void bdtimes_escrever_times(const BDTimes *bd, const int *indices, int n, Escritor *w) {
+    unsigned long long inicio = metricas_agora_ns();
+
+    // Cabecalho da tabela de resultados
+    escritor_str(w, "| ID | Time | V | E | D | GM | GS | S | PG |\n");
+    escritor_str(w, "|----|------|---|---|---|----|----|----|----|\n");
+    
+    for (int i = 0; i < n; i++) {
+        const Time *t = bdtimes_time(bd, indices[i]);
+        const int vals[] = { t->v, t->e, t->d, t->gm, t->gs, time_saldo(t), time_pontos(t) };
+        
+        escritor_str(w, "| ");
+        escritor_int(w, t->id);
+        escritor_str(w, " | ");
+        escritor_str(w, t->nome);
+        for (size_t c = 0; c < sizeof(vals) / sizeof(vals[0]); c++) {
+            escritor_str(w, " | ");
+            escritor_int(w, vals[c]);
+        }
+        escritor_str(w, " |\n");
+    }
+    metricas_tempo(MET_NS_SAIDA, inicio);
+}
+
+// Larguras das colunas da tabela de classificacao (tela e formato "tabela")
+#define W_ID   3   // Largura da coluna ID
+#define W_TIME LARGURA_COLUNA_TIME  // Largura da coluna Time (nomes serao truncados na tela se excederem)
+#define W_V    2   // Largura da coluna Vitorias
+#define W_E    2   // Largura da coluna Empates
+#define W_D    2   // Largura da coluna Derrotas
+#define W_GM   3   // Largura da coluna Gols Marcados
+#define W_GS   3   // Largura da coluna Gols Sofridos
+#define W_S    3   // Largura da coluna Saldo
+#define W_PG   3   // Largura da coluna Pontos Ganhos
+
+/**
+ * Par (id, indice) usado para ordenar os times por ID.
+ */
+typedef struct {
+    int id;    // ID do time
+    int idx;   // Posicao do time no array da base
+} ParIdIndice;
+
+/**
+ * Comparador para qsort: ordena por ID e, em caso de empate, pela
+ * posicao original (mantem a ordem de carga para IDs repetidos).
+ */
+static int cmp_par_id(const void *a, const void *b) {
+    const ParIdIndice *x = (const ParIdIndice*)a;
+    const ParIdIndice *y = (const ParIdIndice*)b;
+    if (x->id != y->id) return x->id < y->id ? -1 : 1;
+    return x->idx < y->idx ? -1 : (x->idx > y->idx);
+}
+
+/**
+ * Calcula a ordem de exibicao dos times (ID crescente).
+ * 
+ * Substitui a antiga varredura de IDs 0..9999, que custava
+ * O(10000 * n) e ignorava IDs fora desse intervalo.
+ * 
+ * @param bd Base de times
+ * @param ordem Array de saida com bd->n posicoes (indices dos times)
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdtimes_ordem_por_id(const BDTimes *bd, int *ordem) {
+    if (bd->n == 0) return 1;
+    ParIdIndice *pares = mem_alocar(MEM_INDICES, (size_t)bd->n * sizeof(ParIdIndice));
+    if (!pares) return 0;
+    for (int i = 0; i < bd->n; i++) {
+        pares[i].id = bdtimes_time(bd, i)->id;
+        pares[i].idx = i;
+    }
+    qsort(pares, (size_t)bd->n, sizeof(ParIdIndice), cmp_par_id);
+    for (int i = 0; i < bd->n; i++) {
+        ordem[i] = pares[i].idx;
+    }
+    mem_liberar(pares);
+    return 1;
+}
+
+/**
+ * Aloca e calcula a ordem de exibicao dos times.
+ * 
+ * Em caso de falta de memoria, marca o erro no escritor (a saida
+ * sera reportada como falha ao fechar).
+ * 
+ * @param bd Base de times
+ * @param w Escritor que recebera a saida
+ * @return Array com bd->n indices (liberar com mem_liberar), ou NULL
+ */
+static int* calcular_ordem(const BDTimes *bd, Escritor *w) {
+    int *ordem = mem_alocar(MEM_INDICES, (size_t)(bd->n > 0 ? bd->n : 1) * sizeof(int));
+    if (!ordem || !bdtimes_ordem_por_id(bd, ordem)) {
+        mem_liberar(ordem);
+        w->erro = 1;
+        return NULL;
+    }
+    return ordem;
+}
+
+/**
+ * Escreve uma celula de texto alinhada pelo numero de bytes.
+ * 
+ * Equivale a printf("%-*s"), mantendo o formato historico do arquivo
+ * exportado (que nao trunca nomes longos).
+ */
+static void escrever_celula_bytes(Escritor *w, const char *s, int largura) {
+    escritor_str(w, s);
+    escritor_repetir(w, ' ', largura - (int)strlen(s));
+}
+
+/**
+ * Escreve o nome de um time na coluna Time, pela largura visual.
+ * 
+ * Mesmo resultado de escritor_utf8_ajustado(w, t->nome, W_TIME), mas com
+ * as medidas ja guardadas no time: apenas copias e espacos.
+ * 
+ * @param w Escritor
+ * @param t Time
+ */
+static void escrever_celula_nome(Escritor *w, const Time *t) {
+    if (t->nome_largura <= W_TIME) {
+        escritor_bytes(w, t->nome, t->nome_bytes);
+        escritor_repetir(w, ' ', W_TIME - t->nome_largura);
+    } else {
+        // Trunca e acrescenta o ellipsis '…' (U+2026); um caractere largo
+        // que nao coube deixa uma coluna livre antes dele
+        escritor_bytes(w, t->nome, t->nome_corte);
+        escritor_repetir(w, ' ', W_TIME - 1 - t->nome_corte_largura);
+        escritor_bytes(w, "\xE2\x80\xA6", 3);
+    }
+}
+
+/**
+ * Escreve a tabela de classificacao com colunas separadas por '|'.
+ * 
+ * Usada tanto para a tela quanto para o formato de exportacao "tabela".
+ * A unica diferenca e o tratamento da coluna Time:
+ * - Na tela (utf8 = 1), o nome e ajustado pela largura visual UTF-8
+ *   e truncado com '…' se exceder a coluna
+ * - No arquivo (utf8 = 0), o nome e alinhado por bytes e nunca truncado
+ * 
+ * @param bd Base de times
+ * @param w Escritor de destino
+ * @param utf8 1 para alinhamento visual UTF-8, 0 para alinhamento por bytes
+ */
+static void escrever_tabela(const BDTimes *bd, Escritor *w, int utf8) {
+    static const char *cab[] = { "ID", "Time", "V", "E", "D", "GM", "GS", "S", "PG" };
+    static const int larg[] = { W_ID, W_TIME, W_V, W_E, W_D, W_GM, W_GS, W_S, W_PG };
+    const int ncol = (int)(sizeof(larg) / sizeof(larg[0]));
+
+    // Cabecalho com os nomes das colunas
+    for (int c = 0; c < ncol; c++) {
+        escritor_str(w, c == 0 ? "| " : " | ");
+        escrever_celula_bytes(w, cab[c], larg[c]);
+    }
+    escritor_str(w, " |\n");
+
+    // Linha separadora com hifens sob cada coluna
+    for (int c = 0; c < ncol; c++) {
+        escritor_str(w, c == 0 ? "|-" : "-|-");
+        escritor_repetir(w, '-', larg[c]);
+    }
+    escritor_str(w, "-|\n");
+
+    // Uma linha por time, em ordem crescente de ID
+    int *ordem = calcular_ordem(bd, w);
+    if (!ordem) return;
+    for (int k = 0; k < bd->n; k++) {
+        const Time *t = bdtimes_time(bd, ordem[k]);
+
+        escritor_str(w, "| ");
+        escritor_int_ajustado(w, t->id, W_ID);
+        escritor_str(w, " | ");
+        if (utf8) {
+            escrever_celula_nome(w, t);
+        } else {
+            escrever_celula_bytes(w, t->nome, W_TIME);
+        }
+        escritor_str(w, " | ");
+        escritor_int_ajustado(w, t->v, W_V);
+        escritor_str(w, " | ");
+        escritor_int_ajustado(w, t->e, W_E);
+        escritor_str(w, " | ");
+        escritor_int_ajustado(w, t->d, W_D);
+        escritor_str(w, " | ");
+        escritor_int_ajustado(w, t->gm, W_GM);
+        escritor_str(w, " | ");
+        escritor_int_ajustado(w, t->gs, W_GS);
+        escritor_str(w, " | ");
+        escritor_int_ajustado(w, time_saldo(t), W_S);
+        escritor_str(w, " | ");
+        escritor_int_ajustado(w, time_pontos(t), W_PG);
+        escritor_str(w, " |\n");
+    }
+    mem_liberar(ordem);
+}
+
+/**
+ * Exporta a classificacao em CSV padrao (RFC 4180).
+ * 
+ * Cabecalho: ID,Time,V,E,D,GM,GS,S,PG
+ * Nomes contendo virgula, aspas ou quebra de linha sao escritos entre
+ * aspas, com aspas internas duplicadas.
+ */
+static void escrever_csv(const BDTimes *bd, Escritor *w) {
+    escritor_str(w, "ID,Time,V,E,D,GM,GS,S,PG\n");
+
+    int *ordem = calcular_ordem(bd, w);
+    if (!ordem) return;
+    for (int k = 0; k < bd->n; k++) {
+        const Time *t = bdtimes_time(bd, ordem[k]);
+
+        escritor_int(w, t->id);
+        escritor_char(w, ',');
+        if (strpbrk(t->nome, ",\"\r\n")) {
+            // Campo precisa de aspas
+            escritor_char(w, '"');
+            for (const char *p = t->nome; *p; p++) {
+                if (*p == '"') escritor_char(w, '"');
+                escritor_char(w, *p);
+            }
+            escritor_char(w, '"');
+        } else {
+            escritor_str(w, t->nome);
+        }
+
+        const int vals[] = { t->v, t->e, t->d, t->gm, t->gs, time_saldo(t), time_pontos(t) };
+        for (size_t c = 0; c < sizeof(vals) / sizeof(vals[0]); c++) {
+            escritor_char(w, ',');
+            escritor_int(w, vals[c]);
+        }
+        escritor_char(w, '\n');
+    }
+    mem_liberar(ordem);
+}
+
+/**
+ * Escreve uma string como literal JSON (entre aspas, com escapes).
+ * 
+ * Bytes UTF-8 sao copiados como estao; apenas aspas, barra invertida
+ * e caracteres de controle sao escapados.
+ */
+static void escrever_string_json(Escritor *w, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    escritor_char(w, '"');
+    for (const unsigned char *p = (const unsigned char*)s; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            escritor_char(w, '\\');
+            escritor_char(w, (char)*p);
+        } else if (*p < 0x20) {
+            char esc[6] = { '\\', 'u', '0', '0', hex[*p >> 4], hex[*p & 0xF] };
+            escritor_bytes(w, esc, sizeof(esc));
+        } else {
+            escritor_char(w, (char)*p);
+        }
+    }
+    escritor_char(w, '"');
+}
+
+/**
+ * Exporta a classificacao em JSON Lines (um objeto JSON por linha).
+ * 
+ * Exemplo de linha:
+ * {"id":0,"time":"JAVAlis","v":13,"e":3,"d":2,"gm":58,"gs":30,"s":28,"pg":42}
+ */
+static void escrever_jsonl(const BDTimes *bd, Escritor *w) {
+    int *ordem = calcular_ordem(bd, w);
+    if (!ordem) return;
+    for (int k = 0; k < bd->n; k++) {
+        const Time *t = bdtimes_time(bd, ordem[k]);
+
+        escritor_str(w, "{\"id\":");
+        escritor_int(w, t->id);
+        escritor_str(w, ",\"time\":");
+        escrever_string_json(w, t->nome);
+        escritor_str(w, ",\"v\":");
+        escritor_int(w, t->v);
+        escritor_str(w, ",\"e\":");
+        escritor_int(w, t->e);
+        escritor_str(w, ",\"d\":");
+        escritor_int(w, t->d);
+        escritor_str(w, ",\"gm\":");
+        escritor_int(w, t->gm);
+        escritor_str(w, ",\"gs\":");
+        escritor_int(w, t->gs);
+        escritor_str(w, ",\"s\":");
+        escritor_int(w, time_saldo(t));
+        escritor_str(w, ",\"pg\":");
+        escritor_int(w, time_pontos(t));
+        escritor_str(w, "}\n");
+    }
+    mem_liberar(ordem);
+}
+
+/**
+ * Escreve um inteiro de 32 bits em little-endian.
+ * 
+ * A ordem dos bytes e fixa para que o arquivo binario seja o mesmo
+ * independente da arquitetura que o gerou.
+ */
+static void escrever_u32_le(Escritor *w, unsigned int v) {
+    unsigned char b[4] = {
+        (unsigned char)(v & 0xFF), (unsigned char)((v >> 8) & 0xFF),
+        (unsigned char)((v >> 16) & 0xFF), (unsigned char)((v >> 24) & 0xFF)
+    };
+    escritor_bytes(w, b, sizeof(b));
+}
+
+/**
+ * Exporta a classificacao no formato binario de registros fixos.
+ * 
+ * Layout descrito em bd_times.h (EXPORT_BIN_*): cabecalho de 16 bytes
+ * seguido de um registro de EXPORT_BIN_REGISTRO bytes por time.
+ */
+static void escrever_binario(const BDTimes *bd, Escritor *w) {
+    // Cabecalho: magic, versao, numero de registros, tamanho do registro
+    escritor_bytes(w, EXPORT_BIN_MAGIC, 4);
+    escrever_u32_le(w, EXPORT_BIN_VERSAO);
+    escrever_u32_le(w, (unsigned int)bd->n);
+    escrever_u32_le(w, EXPORT_BIN_REGISTRO);
+
+    int *ordem = calcular_ordem(bd, w);
+    if (!ordem) return;
+    for (int k = 0; k < bd->n; k++) {
+        const Time *t = bdtimes_time(bd, ordem[k]);
+
+        // Nome em campo fixo, completado com zeros
+        char nome[MAX_NOME_TIME];
+        size_t len = strlen(t->nome);
+        if (len > sizeof(nome) - 1) len = sizeof(nome) - 1;
+        memset(nome, 0, sizeof(nome));
+        memcpy(nome, t->nome, len);
+
+        escrever_u32_le(w, (unsigned int)t->id);
+        escritor_bytes(w, nome, sizeof(nome));
+
+        const int vals[] = { t->v, t->e, t->d, t->gm, t->gs, time_saldo(t), time_pontos(t) };
+        for (size_t c = 0; c < sizeof(vals) / sizeof(vals[0]); c++) {
+            escrever_u32_le(w, (unsigned int)vals[c]);
+        }
+    }
+    mem_liberar(ordem);
+}
+
+/**
+ * Converte o nome de um formato de exportacao para o valor do enum.
+ * 
+ * Nomes aceitos: "tabela", "csv", "jsonl" e "bin".
+ * 
+ * @param nome Nome do formato (ex: vindo da linha de comando)
+ * @param out Onde o formato sera armazenado (apenas se sucesso)
+ * @return 1 se o nome e valido, 0 caso contrario
+ */
+int bdtimes_formato_de_nome(const char *nome, FormatoExport *out) {
+    static const struct { const char *nome; FormatoExport fmt; } tabela[] = {
+        { "tabela", EXPORT_TABELA },
+        { "csv",    EXPORT_CSV },
+        { "jsonl",  EXPORT_JSONL },
+        { "bin",    EXPORT_BINARIO },
+    };
+    for (size_t i = 0; i < sizeof(tabela) / sizeof(tabela[0]); i++) {
+        if (strcmp(nome, tabela[i].nome) == 0) {
+            *out = tabela[i].fmt;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Retorna o nome padrao do arquivo de exportacao de um formato.
+ * 
+ * O formato "tabela" mantem o nome historico "bd_classificacao.csv".
+ * 
+ * @param fmt Formato de exportacao
+ * @return Nome do arquivo (string estatica)
+ */
+const char* bdtimes_arquivo_padrao(FormatoExport fmt) {
+    switch (fmt) {
+        case EXPORT_JSONL:   return "bd_classificacao.jsonl";
+        case EXPORT_BINARIO: return "bd_classificacao.bin";
+        case EXPORT_CSV:
+        case EXPORT_TABELA:
+        default:             return "bd_classificacao.csv";
+    }
+}
+
+/**
+ * Exporta a tabela de classificacao para um arquivo no formato escolhido.
+ * 
+ * Todos os formatos sao gerados em streaming pelo mesmo escritor
+ * bufferizado; os times sao exportados em ordem crescente de ID.
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes contendo os times a exportar
+ * @param fmt Formato de saida
+ * @param caminho Arquivo de destino, ou NULL para o nome padrao do formato
+ * @return 1 se a exportacao foi bem sucedida, 0 em caso de erro
+ */
+int bdtimes_exportar(const BDTimes *bd, FormatoExport fmt, const char *caminho) {
+    if (!caminho) caminho = bdtimes_arquivo_padrao(fmt);
+
+    // Abre o arquivo em modo de escrita (sobrescreve se ja existir)
+    Escritor *w = mem_alocar(MEM_ESCRITORES, sizeof(Escritor));
+    if (!w || !escritor_abrir(w, caminho)) {
+        fprintf(stderr, "Erro ao criar arquivo de exportacao: %s\n", caminho);
+        mem_liberar(w);
+        return 0;
+    }
+
+    unsigned long long inicio = metricas_agora_ns();
+    switch (fmt) {
+        case EXPORT_CSV:     escrever_csv(bd, w);        break;
+        case EXPORT_JSONL:   escrever_jsonl(bd, w);      break;
+        case EXPORT_BINARIO: escrever_binario(bd, w);    break;
+        case EXPORT_TABELA:
+        default:             escrever_tabela(bd, w, 0);  break;
+    }
+    metricas_tempo(MET_NS_SAIDA, inicio);
+
+    int ok = escritor_fechar(w);
+    mem_liberar(w);
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar arquivo de exportacao: %s\n", caminho);
+        return 0;
+    }
+
+    // Informa ao usuario que o arquivo foi criado com sucesso
+    printf("[Sistema] Arquivo '%s' criado/atualizado com sucesso.\n", caminho);
+    return 1;
+}
+
+/**
+ * Escreve a tabela de classificacao em um escritor bufferizado.
+ * 
+ * Mesma tabela exibida por bdtimes_imprimir_classificacao(), sem
+ * exportar arquivo. Usada por quem precisa direcionar a saida
+ * (modo batch, testes de desempenho).
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes contendo os dados dos times
+ * @param w Escritor de destino
+ */
+void bdtimes_escrever_classificacao(const BDTimes *bd, Escritor *w) {
+    unsigned long long inicio = metricas_agora_ns();
+    escrever_tabela(bd, w, 1);
+    metricas_latencia(LAT_CLASSIFICACAO, metricas_tempo(MET_NS_SAIDA, inicio));
+}
+
+/**
+ * Imprime a tabela de classificacao dos times na tela em formato visual.
+ * Alem de imprimir na tela, esta funcao tambem exporta os dados para um arquivo
+ * no formato escolhido.
+ * 
+ * A tabela e impressa com colunas alinhadas e separadas por pipes (|) para facilitar
+ * a leitura. Os times sao ordenados por ID de forma crescente.
+ * 
+ * Colunas exibidas:
+ * - ID: Identificador unico do time
+ * - Time: Nome do time (truncado se muito longo)
+ * - V: Numero de vitorias
+ * - E: Numero de empates
+ * - D: Numero de derrotas
+ * - GM: Gols marcados pelo time
+ * - GS: Gols sofridos pelo time
+ * - S: Saldo de gols (GM - GS)
+ * - PG: Pontos ganhos (3*V + E)
+ * 
+ * @param bd Ponteiro para a estrutura BDTimes contendo os dados dos times
+ * @param fmt Formato do arquivo exportado
+ */
+void bdtimes_imprimir_classificacao(const BDTimes *bd, FormatoExport fmt) {
+    // Escreve a tabela na tela pelo escritor bufferizado
+    Escritor *w = mem_alocar(MEM_ESCRITORES, sizeof(Escritor));
+    if (w) {
+        escritor_de_arquivo(w, stdout);
+        bdtimes_escrever_classificacao(bd, w);
+        escritor_fechar(w);
+        mem_liberar(w);
     }
     
-    // Apos imprimir a tabela na tela, exporta os dados para arquivo CSV
-    // Esta funcao cria/sobrescreve o arquivo "bd_classificacao.csv"
-    bdtimes_exportar_csv(bd);
+    // Apos imprimir a tabela na tela, exporta os dados para arquivo
+    bdtimes_exportar(bd, fmt, NULL);
 }
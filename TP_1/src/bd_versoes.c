@@ -0,0 +1,250 @@
+/**
+ * Modulo: bd_versoes.c
+ * 
+ * Implementa a base versionada (estilo RCU) descrita em bd_versoes.h.
+ * 
+ * Reclamacao por epocas:
+ * - Existe uma epoca global, que comeca em 1 e so cresce
+ * - Ao iniciar uma leitura, o leitor anuncia a epoca global atual no seu
+ *   slot e SO DEPOIS le o ponteiro da versao atual
+ * - Ao publicar, o escritor troca o ponteiro e SO DEPOIS incrementa a
+ *   epoca global; a versao substituida e aposentada com a epoca antiga E
+ * - Um leitor que anunciou epoca > E leu a epoca global depois da troca,
+ *   portanto so pode ter visto a versao nova. Logo, uma versao aposentada
+ *   na epoca E pode ser liberada quando nenhum leitor ativo anunciou
+ *   uma epoca <= E
+ * 
+ * Todas as operacoes atomicas usam ordenacao sequencialmente consistente,
+ * o que garante a ordem "anuncia, depois le" e "troca, depois incrementa".
+ * 
+ * Compartilhamento entre versoes:
+ * - A nova versao compartilha os indices e os pedacos de times da anterior
+ *   (bdtimes_compartilhar) e copia so os pedacos dos times que as partidas
+ *   novas alteram (bdtimes_alterar)
+ * - As partidas sao acrescentadas ao final dos pedacos compartilhados
+ *   (bdpartidas_compartilhar): cada versao enxerga as suas 'n' primeiras,
+ *   que nunca mudam
+ * - Os contadores de referencia dos pedacos so sao alterados pelo
+ *   escritor, com a trava de escrita (inclusive na reclamacao)
+ */
+
+#include "bd_versoes.h"
+#include "memoria.h"
+#include "metricas.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Libera uma versao e as bases que ela contem.
+ * 
+ * @param v Versao (NULL e aceito)
+ */
+static void liberar_versao(Versao *v) {
+    if (!v) return;
+    bdtimes_liberar(&v->times);
+    bdpartidas_liberar(&v->partidas);
+    mem_liberar(v);
+}
+
+/**
+ * Cria a primeira versao a partir de bases ja carregadas.
+ * 
+ * @param bv Base versionada a inicializar
+ * @param bdt Times iniciais
+ * @param bdp Partidas iniciais
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+int bdversoes_iniciar(BDVersionada *bv, const BDTimes *bdt, const BDPartidas *bdp) {
+    Versao *v = mem_alocar(MEM_VERSOES, sizeof(Versao));
+    if (!v) return 0;
+    
+    if (!bdtimes_copiar(&v->times, bdt) || !bdpartidas_copiar(&v->partidas, bdp)) {
+        bdtimes_liberar(&v->times);
+        mem_liberar(v);
+        return 0;
+    }
+    v->numero = 1;
+    v->epoca = 0;
+    v->prox = NULL;
+    
+    atomic_init(&bv->atual, v);
+    atomic_init(&bv->epoca, 1);
+    for (int i = 0; i < MAX_LEITORES; i++) {
+        atomic_init(&bv->leitores[i], 0);
+    }
+    atomic_init(&bv->n_leitores, 0);
+    pthread_mutex_init(&bv->escrita, NULL);
+    bv->aposentadas = NULL;
+    return 1;
+}
+
+/**
+ * Libera todas as versoes (atual e aposentadas).
+ * 
+ * @param bv Base versionada
+ */
+void bdversoes_liberar(BDVersionada *bv) {
+    liberar_versao(atomic_load(&bv->atual));
+    while (bv->aposentadas) {
+        Versao *v = bv->aposentadas;
+        bv->aposentadas = v->prox;
+        liberar_versao(v);
+    }
+    pthread_mutex_destroy(&bv->escrita);
+}
+
+/**
+ * Registra uma thread leitora.
+ * 
+ * @param bv Base versionada
+ * @return Identificador do leitor, ou -1 se nao ha slots livres
+ */
+int bdversoes_registrar_leitor(BDVersionada *bv) {
+    int id = atomic_fetch_add(&bv->n_leitores, 1);
+    if (id >= MAX_LEITORES) {
+        fprintf(stderr, "Limite de leitores atingido (%d)\n", MAX_LEITORES);
+        return -1;
+    }
+    return id;
+}
+
+/**
+ * Inicia uma leitura: anuncia a epoca e obtem a versao atual.
+ * 
+ * @param bv Base versionada
+ * @param leitor Identificador do leitor
+ * @return Versao atual
+ */
+const Versao* bdversoes_ler_inicio(BDVersionada *bv, int leitor) {
+    // Anuncia a epoca ANTES de ler o ponteiro (ver comentario do modulo)
+    atomic_store(&bv->leitores[leitor], atomic_load(&bv->epoca));
+    return atomic_load(&bv->atual);
+}
+
+/**
+ * Termina uma leitura.
+ * 
+ * @param bv Base versionada
+ * @param leitor Identificador do leitor
+ */
+void bdversoes_ler_fim(BDVersionada *bv, int leitor) {
+    atomic_store_explicit(&bv->leitores[leitor], 0, memory_order_release);
+}
+
+/**
+ * Libera as versoes aposentadas que nenhum leitor ativo pode estar usando.
+ * 
+ * Chamada com a trava de escrita adquirida.
+ * 
+ * @param bv Base versionada
+ */
+static void reclamar(BDVersionada *bv) {
+    // Menor epoca anunciada entre os leitores ativos
+    unsigned long long minima = (unsigned long long)-1;
+    int n = atomic_load(&bv->n_leitores);
+    if (n > MAX_LEITORES) n = MAX_LEITORES;
+    for (int i = 0; i < n; i++) {
+        unsigned long long e = atomic_load(&bv->leitores[i]);
+        if (e != 0 && e < minima) minima = e;
+    }
+
+    // Libera as versoes aposentadas antes da menor epoca ativa
+    Versao **pp = &bv->aposentadas;
+    while (*pp) {
+        Versao *v = *pp;
+        if (v->epoca < minima) {
+            *pp = v->prox;
+            liberar_versao(v);
+        } else {
+            pp = &v->prox;
+        }
+    }
+}
+
+/**
+ * Copia os pedacos dos times que as partidas novas vao alterar, para que
+ * as versoes anteriores (que os compartilham) nao mudem.
+ * 
+ * @param bdt Times da nova versao
+ * @param bdp Partidas da nova versao
+ * @param de Primeira partida nova
+ * @return 1 se sucesso, 0 se faltou memoria
+ */
+static int separar_times(BDTimes *bdt, const BDPartidas *bdp, int de) {
+    int slots[2 * 64];
+    for (int i = de; i < bdp->n; i += 64) {
+        int m = bdp->n - i < 64 ? bdp->n - i : 64;
+        for (int k = 0; k < m; k++) {
+            const Partida *p = bdpartidas_partida(bdp, i + k);
+            slots[2 * k] = p->time1;
+            slots[2 * k + 1] = p->time2;
+        }
+        bdtimes_slots_por_id(bdt, slots, 2 * m, slots);
+        for (int k = 0; k < 2 * m; k++) {
+            if (slots[k] >= 0 && !bdtimes_alterar(bdt, slots[k])) return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Aplica partidas novas e publica uma nova versao.
+ * 
+ * Custa O(partidas novas) mais O(times / TIMES_POR_PEDACO +
+ * partidas / PARTIDAS_POR_PEDACO) para compartilhar os pedacos: nada da
+ * versao anterior e copiado alem dos pedacos dos times alterados.
+ * 
+ * @param bv Base versionada
+ * @param novas Partidas a acrescentar
+ * @param n Quantidade de partidas
+ * @return Numero da nova versao, ou 0 em caso de erro
+ */
+unsigned long long bdversoes_adicionar_partidas(BDVersionada *bv, const Partida *novas, int n) {
+    pthread_mutex_lock(&bv->escrita);
+    
+    Versao *antiga = atomic_load(&bv->atual);
+    
+    // A nova versao compartilha tudo com a atual; os leitores continuam
+    // usando a antiga, que nao muda
+    Versao *nova = mem_alocar(MEM_VERSOES, sizeof(Versao));
+    if (!nova) {
+        pthread_mutex_unlock(&bv->escrita);
+        return 0;
+    }
+    bdtimes_init(&nova->times);
+    bdpartidas_init(&nova->partidas);
+    int de = antiga->partidas.n;
+    int ok = bdtimes_compartilhar(&nova->times, &antiga->times) &&
+             bdpartidas_compartilhar(&nova->partidas, &antiga->partidas);
+    for (int i = 0; ok && i < n; i++) {
+        ok = bdpartidas_adicionar(&nova->partidas, &novas[i]);
+    }
+    if (!ok || !separar_times(&nova->times, &nova->partidas, de)) {
+        // Libera com a trava: os contadores dos pedacos sao do escritor
+        liberar_versao(nova);
+        pthread_mutex_unlock(&bv->escrita);
+        fprintf(stderr, "Memoria insuficiente para uma nova versao da base\n");
+        return 0;
+    }
+    nova->numero = antiga->numero + 1;
+    nova->epoca = 0;
+    nova->prox = NULL;
+    
+    // Aplica somente as partidas novas
+    unsigned long long inicio = metricas_agora_ns();
+    bdpartidas_aplicar_intervalo(&nova->partidas, de, nova->partidas.n, &nova->times);
+    metricas_somar(MET_PARTIDAS_AGREGADAS, (unsigned long long)n);
+    metricas_tempo(MET_NS_AGREGACAO, inicio);
+    
+    // Publica: troca o ponteiro e so depois avanca a epoca
+    atomic_store(&bv->atual, nova);
+    antiga->epoca = atomic_fetch_add(&bv->epoca, 1);
+    antiga->prox = bv->aposentadas;
+    bv->aposentadas = antiga;
+    
+    reclamar(bv);
+    
+    unsigned long long numero = nova->numero;
+    pthread_mutex_unlock(&bv->escrita);
+    return numero;
+}
@@ -0,0 +1,305 @@
+/**
+ * Modulo: campeonato.c
+ * 
+ * Implementa a API publica da biblioteca (campeonato.h) sobre os modulos
+ * internos bd_times, bd_partidas e ingestao. Esta camada apenas traduz
+ * tipos: toda a logica de carga, agregacao e busca continua nos modulos
+ * internos, compartilhada com o programa interativo.
+ */
+
+#include "campeonato.h"
+#include "bd_times.h"
+#include "bd_partidas.h"
+#include "ingestao.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Estrutura interna da instancia (opaca para quem usa a API).
+ */
+struct Campeonato {
+    BDTimes times;        // Times e estatisticas agregadas
+    BDPartidas partidas;  // Partidas carregadas
+};
+
+/**
+ * Estrutura interna do cursor de busca paginada.
+ */
+struct CampeonatoCursor {
+    CursorPartidas busca;  // Marcas dos times e posicao da proxima partida
+};
+
+/**
+ * Retorna a versao da API.
+ * 
+ * @return CAMPEONATO_API_VERSAO
+ */
+int campeonato_versao_api(void) {
+    return CAMPEONATO_API_VERSAO;
+}
+
+/**
+ * Cria uma instancia vazia.
+ * 
+ * @return Nova instancia, ou NULL se faltou memoria
+ */
+Campeonato* campeonato_criar(void) {
+    Campeonato *c = mem_alocar(MEM_API, sizeof(Campeonato));
+    if (!c) return NULL;
+    bdtimes_init(&c->times);
+    bdpartidas_init(&c->partidas);
+    return c;
+}
+
+/**
+ * Libera uma instancia.
+ * 
+ * @param c Instancia (NULL e aceito)
+ */
+void campeonato_destruir(Campeonato *c) {
+    if (!c) return;
+    bdtimes_liberar(&c->times);
+    bdpartidas_liberar(&c->partidas);
+    mem_liberar(c);
+}
+
+/**
+ * Carrega os times de um CSV.
+ * 
+ * @param c Instancia
+ * @param caminho Caminho do arquivo
+ * @return Numero de times carregados, ou 0 em caso de erro
+ */
+int campeonato_carregar_times(Campeonato *c, const char *caminho) {
+    return bdtimes_carregar_csv(&c->times, caminho);
+}
+
+/**
+ * Carrega as partidas de um CSV e agrega os resultados.
+ * 
+ * @param c Instancia
+ * @param caminho Caminho do arquivo
+ * @return Numero de partidas carregadas, ou 0 em caso de erro
+ */
+int campeonato_carregar_partidas(Campeonato *c, const char *caminho) {
+    return ingestao_carregar_partidas(&c->partidas, &c->times, caminho, NULL);
+}
+
+/**
+ * Acrescenta uma partida e agrega o resultado.
+ * 
+ * @param c Instancia
+ * @param p Partida a acrescentar
+ * @return 1 se acrescentada, 0 se faltou memoria
+ */
+int campeonato_adicionar_partida(Campeonato *c, const CampeonatoPartida *p) {
+    Partida nova;
+    nova.id = p->id;
+    nova.time1 = p->mandante;
+    nova.time2 = p->visitante;
+    nova.g1 = p->gols_mandante;
+    nova.g2 = p->gols_visitante;
+
+    if (!bdpartidas_adicionar(&c->partidas, &nova)) return 0;
+    bdpartidas_aplicar_partida(&c->partidas, c->partidas.n - 1, &c->times);
+    return 1;
+}
+
+/**
+ * @param c Instancia
+ * @return Numero de times carregados
+ */
+int campeonato_num_times(const Campeonato *c) {
+    return c->times.n;
+}
+
+/**
+ * @param c Instancia
+ * @return Numero de partidas carregadas
+ */
+int campeonato_num_partidas(const Campeonato *c) {
+    return c->partidas.n;
+}
+
+/**
+ * Obtem os dados de um time.
+ * 
+ * @param c Instancia
+ * @param indice Indice do time
+ * @param out Onde os dados serao armazenados
+ * @return 1 se sucesso, 0 se o indice e invalido
+ */
+int campeonato_obter_time(const Campeonato *c, int indice, CampeonatoTime *out) {
+    if (indice < 0 || indice >= c->times.n) return 0;
+
+    const Time *t = bdtimes_time(&c->times, indice);
+    out->id = t->id;
+    out->nome = t->nome;
+    out->v = t->v;
+    out->e = t->e;
+    out->d = t->d;
+    out->gm = t->gm;
+    out->gs = t->gs;
+    out->saldo = time_saldo(t);
+    out->pontos = time_pontos(t);
+    return 1;
+}
+
+/**
+ * Obtem os dados de uma partida.
+ * 
+ * @param c Instancia
+ * @param indice Indice da partida
+ * @param out Onde os dados serao armazenados
+ * @return 1 se sucesso, 0 se o indice e invalido
+ */
+int campeonato_obter_partida(const Campeonato *c, int indice, CampeonatoPartida *out) {
+    if (indice < 0 || indice >= c->partidas.n) return 0;
+
+    const Partida *p = bdpartidas_partida(&c->partidas, indice);
+    out->id = p->id;
+    out->mandante = p->time1;
+    out->visitante = p->time2;
+    out->gols_mandante = p->g1;
+    out->gols_visitante = p->g2;
+    return 1;
+}
+
+/**
+ * Busca times por prefixo do nome.
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome
+ * @param indices Array de saida
+ * @param max_indices Tamanho do array
+ * @return Total de times encontrados
+ */
+int campeonato_buscar_times(const Campeonato *c, const char *prefixo,
+                            int *indices, int max_indices) {
+    return bdtimes_buscar_por_prefixo(&c->times, prefixo, indices, max_indices);
+}
+
+/**
+ * Busca times por nome aproximado.
+ * 
+ * @param c Instancia
+ * @param texto Texto digitado
+ * @param indices Array de saida
+ * @param max_indices Tamanho do array
+ * @return Total de times encontrados, ou -1 se faltou memoria
+ */
+int campeonato_buscar_times_aproximado(const Campeonato *c, const char *texto,
+                                       int *indices, int max_indices) {
+    return bdtimes_buscar_aproximado(&c->times, texto, indices, max_indices);
+}
+
+int campeonato_buscar_times_infixo(const Campeonato *c, const char *trecho,
+                                   int *indices, int max_indices) {
+    return bdtimes_buscar_infixo(&c->times, trecho, indices, max_indices);
+}
+
+/**
+ * Converte o filtro da API publica para o filtro interno.
+ */
+static FiltroPartida converter_filtro(CampeonatoFiltro filtro) {
+    switch (filtro) {
+        case CAMPEONATO_MANDANTE:  return FILTRO_MANDANTE;
+        case CAMPEONATO_VISITANTE: return FILTRO_VISITANTE;
+        default:                   return FILTRO_QUALQUER;
+    }
+}
+
+/**
+ * Busca partidas por prefixo do nome de um dos times.
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @param indices Array de saida
+ * @param max_indices Tamanho do array
+ * @return Total de partidas encontradas
+ */
+int campeonato_buscar_partidas(const Campeonato *c, const char *prefixo,
+                               CampeonatoFiltro filtro, int *indices, int max_indices) {
+    return bdpartidas_buscar_por_prefixo(&c->partidas, &c->times, prefixo, converter_filtro(filtro),
+                                         indices, max_indices);
+}
+
+/**
+ * Conta partidas por prefixo do nome de um dos times.
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return Numero de partidas encontradas
+ */
+int campeonato_contar_partidas(const Campeonato *c, const char *prefixo, CampeonatoFiltro filtro) {
+    return bdpartidas_contar_por_prefixo(&c->partidas, &c->times, prefixo, converter_filtro(filtro));
+}
+
+/**
+ * Abre uma busca paginada de partidas por prefixo do nome de um dos times.
+ * 
+ * @param c Instancia
+ * @param prefixo Prefixo do nome do time
+ * @param filtro Lado da partida em que o prefixo e testado
+ * @return Novo cursor, ou NULL se faltou memoria
+ */
+CampeonatoCursor* campeonato_abrir_cursor_partidas(const Campeonato *c, const char *prefixo,
+                                                   CampeonatoFiltro filtro) {
+    CampeonatoCursor *cur = mem_alocar(MEM_API, sizeof(CampeonatoCursor));
+    if (!cur) return NULL;
+    if (!bdpartidas_abrir_cursor(&cur->busca, &c->partidas, &c->times, prefixo,
+                                 converter_filtro(filtro))) {
+        campeonato_fechar_cursor_partidas(cur);
+        return NULL;
+    }
+    return cur;
+}
+
+/**
+ * Busca a proxima pagina de partidas de um cursor.
+ * 
+ * @param cur Cursor
+ * @param indices Array de saida
+ * @param max_indices Tamanho da pagina
+ * @return Numero de indices nesta pagina
+ */
+int campeonato_proxima_pagina_partidas(CampeonatoCursor *cur, int *indices, int max_indices) {
+    return bdpartidas_proxima_pagina(&cur->busca, indices, max_indices);
+}
+
+/**
+ * Libera um cursor.
+ * 
+ * @param cur Cursor (NULL e aceito)
+ */
+void campeonato_fechar_cursor_partidas(CampeonatoCursor *cur) {
+    if (!cur) return;
+    bdpartidas_fechar_cursor(&cur->busca);
+    mem_liberar(cur);
+}
+
+/**
+ * Retorna os times na ordem da classificacao.
+ * 
+ * @param c Instancia
+ * @param indices Array de saida
+ * @param max_indices Tamanho do array
+ * @return Numero total de times
+ */
+int campeonato_classificacao(const Campeonato *c, int *indices, int max_indices) {
+    // Ordem completa em um array temporario, se o do chamador for menor
+    if (max_indices >= c->times.n) {
+        return bdtimes_ordem_por_id(&c->times, indices) ? c->times.n : 0;
+    }
+    int *ordem = mem_alocar(MEM_INDICES, (size_t)c->times.n * sizeof(int));
+    if (!ordem || !bdtimes_ordem_por_id(&c->times, ordem)) {
+        mem_liberar(ordem);
+        return 0;
+    }
+    if (max_indices > 0) memcpy(indices, ordem, (size_t)max_indices * sizeof(int));
+    mem_liberar(ordem);
+    return c->times.n;
+}
@@ -0,0 +1,237 @@
+/**
+ * Modulo: completar.c
+ *
+ * Implementa a completacao interativa de nomes de times no terminal.
+ *
+ * O terminal vai para o modo nao canonico (termios): cada tecla chega
+ * assim que e digitada, sem eco. O texto digitado e as sugestoes sao
+ * redesenhados a cada tecla com sequencias ANSI (apagar ate o fim da
+ * tela, subir o cursor), suportadas pelos terminais atuais.
+ *
+ * O estado da busca e uma pilha de faixas do indice de nomes, uma por
+ * byte digitado: digitar estreita a faixa do topo (O(log n)), apagar so
+ * desempilha.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "completar.h"
+#include "utils.h"
+#include <ctype.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int completar_ler_nome(const BDTimes *bd, const char *rotulo, char *buf, int cap) {
+    (void)bd;
+    (void)rotulo;
+    (void)buf;
+    (void)cap;
+    return -1;
+}
+
+#else
+
+// Teclas tratadas (codigos recebidos no modo nao canonico)
+#define TECLA_CTRL_C    3
+#define TECLA_CTRL_D    4
+#define TECLA_CTRL_H    8
+#define TECLA_TAB       9
+#define TECLA_LF        10
+#define TECLA_CR        13
+#define TECLA_ESC       27
+#define TECLA_DEL       127
+
+/**
+ * Redesenha a linha de entrada e, abaixo dela, as sugestoes.
+ *
+ * Deixa o cursor no fim do texto digitado.
+ *
+ * @param bd Base de times
+ * @param rotulo Texto antes do que e digitado
+ * @param buf Texto digitado
+ * @param f Faixa do indice de nomes do texto digitado
+ */
+static void desenhar(const BDTimes *bd, const char *rotulo, const char *buf, FaixaNomes f) {
+    // Volta ao inicio da linha e apaga dela ate o fim da tela
+    fputs("\r\033[J", stdout);
+    fputs(rotulo, stdout);
+    fputs(buf, stdout);
+
+    int linhas = 0;
+    if (buf[0] != '\0') {
+        int total = f.fim - f.inicio;
+        for (int i = f.inicio; i < f.fim && linhas < COMPLETAR_SUGESTOES; i++, linhas++) {
+            printf("\n  %s", bdtimes_time(bd, bd->nomes.ordem[i])->nome);
+        }
+        if (total == 0) {
+            fputs("\n  (nenhum time comeca com esse texto)", stdout);
+            linhas++;
+        } else if (total > linhas) {
+            printf("\n  ... %d times", total);
+            linhas++;
+        }
+    }
+
+    // Sobe ate a linha de entrada e avanca ate o fim do texto
+    if (linhas > 0) printf("\033[%dA", linhas);
+    fputs("\r", stdout);
+    int coluna = utf8_largura(rotulo) + utf8_largura(buf);
+    if (coluna > 0) printf("\033[%dC", coluna);
+    fflush(stdout);
+}
+
+/**
+ * Consome o resto de uma sequencia de escape (setas, Home, F1...).
+ *
+ * Sequencias "ESC [ ... <final>" e "ESC O <final>", com o byte final
+ * entre 0x40 e 0x7E. Um ESC sozinho consome a tecla seguinte.
+ */
+static void ignorar_sequencia(void) {
+    int c = getchar();
+    if (c != '[' && c != 'O') return;
+    do {
+        c = getchar();
+    } while (c != EOF && !(c >= 0x40 && c <= 0x7E));
+}
+
+/**
+ * Bytes de um caractere UTF-8 pelo seu primeiro byte.
+ */
+static int bytes_caractere(unsigned char b) {
+    if (b >= 0xF0) return 4;
+    if (b >= 0xE0) return 3;
+    if (b >= 0xC0) return 2;
+    return 1;
+}
+
+/**
+ * Completa o texto com o maior prefixo comum dos nomes da faixa.
+ *
+ * Com os nomes em ordem, o prefixo comum a todos e o do primeiro e do
+ * ultimo. Os bytes acrescentados vem do primeiro nome; o corte nunca cai
+ * no meio de um caractere. A faixa nao muda: todos os nomes ja tem esses
+ * bytes.
+ *
+ * @param bd Base de times
+ * @param buf Texto digitado (atualizado)
+ * @param len Bytes do texto (atualizado)
+ * @param max Maximo de bytes do texto
+ * @param faixas Pilha de faixas (uma por byte do texto)
+ */
+static void completar_comum(const BDTimes *bd, char *buf, int *len, int max, FaixaNomes *faixas) {
+    FaixaNomes f = faixas[*len];
+    if (f.inicio >= f.fim) return;
+
+    const char *primeiro = bdtimes_time(bd, bd->nomes.ordem[f.inicio])->nome;
+    const char *ultimo = bdtimes_time(bd, bd->nomes.ordem[f.fim - 1])->nome;
+    int fim = *len;
+    while (fim < max && primeiro[fim] != '\0' &&
+           tolower((unsigned char)primeiro[fim]) == tolower((unsigned char)ultimo[fim])) {
+        fim++;
+    }
+    while (fim > *len && ((unsigned char)primeiro[fim] & 0xC0) == 0x80) fim--;
+
+    for (int k = *len; k < fim; k++) {
+        buf[k] = primeiro[k];
+        faixas[k + 1] = f;
+    }
+    buf[fim] = '\0';
+    *len = fim;
+}
+
+/**
+ * Le um nome ou prefixo de time do terminal, com completacao.
+ *
+ * @param bd Base de times
+ * @param rotulo Texto exibido antes do que e digitado
+ * @param buf Buffer de saida
+ * @param cap Tamanho do buffer (incluindo o '\0')
+ * @return 1 se confirmado, 0 se cancelado (ou EOF), -1 se indisponivel
+ */
+int completar_ler_nome(const BDTimes *bd, const char *rotulo, char *buf, int cap) {
+    if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO)) return -1;
+    if (bd->nomes.n != bd->n || cap < 1) return -1;
+
+    struct termios original;
+    if (tcgetattr(STDIN_FILENO, &original) != 0) return -1;
+    struct termios cru = original;
+    cru.c_lflag &= ~(tcflag_t)(ICANON | ECHO | ISIG);
+    cru.c_cc[VMIN] = 1;
+    cru.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &cru) != 0) return -1;
+
+    // faixas[k]: faixa dos nomes que comecam com os k primeiros bytes de
+    // buf. Nenhum nome tem MAX_NOME_TIME bytes ou mais.
+    FaixaNomes faixas[MAX_NOME_TIME];
+    int max = cap - 1 < MAX_NOME_TIME - 1 ? cap - 1 : MAX_NOME_TIME - 1;
+    int len = 0;
+    int faltam = 0;      // Bytes de continuacao esperados do caractere atual
+    faixas[0].inicio = 0;
+    faixas[0].fim = bd->nomes.n;
+    buf[0] = '\0';
+
+    int resultado = -1;
+    desenhar(bd, rotulo, buf, faixas[0]);
+    while (resultado < 0) {
+        int c = getchar();
+        if (c == EOF || c == TECLA_CTRL_C || (c == TECLA_CTRL_D && len == 0)) {
+            resultado = 0;
+            continue;
+        }
+        if (c == TECLA_LF || c == TECLA_CR) {
+            resultado = 1;
+            continue;
+        }
+
+        if (c == TECLA_DEL || c == TECLA_CTRL_H) {
+            // Apaga o ultimo caractere inteiro (todos os seus bytes)
+            while (len > 0 && ((unsigned char)buf[--len] & 0xC0) == 0x80) {}
+            buf[len] = '\0';
+            faltam = 0;
+        } else if (c == TECLA_TAB) {
+            if (faltam == 0) completar_comum(bd, buf, &len, max, faixas);
+        } else if (c == TECLA_ESC) {
+            ignorar_sequencia();
+        } else if (c >= 0x20) {
+            unsigned char b = (unsigned char)c;
+            if ((b & 0xC0) == 0x80) {
+                // Continuacao: so entra se o inicio do caractere entrou
+                // (o espaco para ela foi reservado ali). As de um caractere
+                // que nao coube chegam com faltam == 0 e sao descartadas
+                if (faltam == 0) continue;
+                faltam--;
+            } else {
+                int bytes = bytes_caractere(b);
+                if (len + bytes > max) {
+                    faltam = 0;
+                    continue;
+                }
+                faltam = bytes - 1;
+            }
+            faixas[len + 1] = faixas[len];
+            bdtimes_estreitar_faixa(bd, &faixas[len + 1], len, (char)b);
+            buf[len++] = (char)b;
+            buf[len] = '\0';
+        }
+
+        // No meio de um caractere multibyte, espera os bytes restantes
+        if (faltam == 0) desenhar(bd, rotulo, buf, faixas[len]);
+    }
+
+    // Deixa so a linha digitada na tela
+    fputs("\r\033[J", stdout);
+    fputs(rotulo, stdout);
+    if (resultado == 1) fputs(buf, stdout);
+    fputs("\n", stdout);
+    fflush(stdout);
+    tcsetattr(STDIN_FILENO, TCSANOW, &original);
+    return resultado;
+}
+
+#endif
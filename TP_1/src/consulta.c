@@ -0,0 +1,433 @@
+/**
+ * Modulo: consulta.c
+ * 
+ * Implementa o modo batch: interpretacao e execucao de comandos de
+ * consulta lidos de um arquivo ou de stdin, sem menus nem prompts.
+ * 
+ * Para maximizar a vazao, a entrada inteira e lida de uma vez, cada
+ * linha e interpretada uma unica vez para um vetor de Consulta e so
+ * entao os comandos sao executados, todos escrevendo no mesmo escritor
+ * bufferizado.
+ */
+
+#include "consulta.h"
+#include "memoria.h"
+#include "metricas.h"
+#include "rastro.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/**
+ * Tabela de nomes de comandos aceitos (ingles e portugues).
+ */
+static const struct {
+    const char *nome;
+    TipoConsulta tipo;
+} COMANDOS[] = {
+    { "team",            CONSULTA_TIME },
+    { "time",            CONSULTA_TIME },
+    { "contains",        CONSULTA_INFIXO },
+    { "contem",          CONSULTA_INFIXO },
+    { "fuzzy",           CONSULTA_APROX },
+    { "aprox",           CONSULTA_APROX },
+    { "home",            CONSULTA_MANDANTE },
+    { "mandante",        CONSULTA_MANDANTE },
+    { "away",            CONSULTA_VISITANTE },
+    { "visitante",       CONSULTA_VISITANTE },
+    { "any",             CONSULTA_QUALQUER },
+    { "qualquer",        CONSULTA_QUALQUER },
+    { "count-home",      CONSULTA_CONTA_MANDANTE },
+    { "conta-mandante",  CONSULTA_CONTA_MANDANTE },
+    { "count-away",      CONSULTA_CONTA_VISITANTE },
+    { "conta-visitante", CONSULTA_CONTA_VISITANTE },
+    { "count-any",       CONSULTA_CONTA_QUALQUER },
+    { "conta-qualquer",  CONSULTA_CONTA_QUALQUER },
+    { "table",           CONSULTA_TABELA },
+    { "tabela",          CONSULTA_TABELA },
+    { "stats",           CONSULTA_ESTATISTICAS },
+    { "estatisticas",    CONSULTA_ESTATISTICAS },
+    { "mem",             CONSULTA_MEMORIA },
+    { "memoria",         CONSULTA_MEMORIA },
+    { "add",             CONSULTA_ADICIONAR },
+    { "adicionar",       CONSULTA_ADICIONAR },
+};
+
+/**
+ * @param tipo Tipo de comando
+ * @return Nome principal (em ingles) do comando, para o rastro
+ */
+static const char* nome_comando(TipoConsulta tipo) {
+    for (size_t i = 0; i < sizeof(COMANDOS) / sizeof(COMANDOS[0]); i++) {
+        if (COMANDOS[i].tipo == tipo) return COMANDOS[i].nome;
+    }
+    return "?";
+}
+
+/**
+ * Interpreta uma linha de comando.
+ * 
+ * Formato: "<comando> [prefixo]". O comando e separado do prefixo pelo
+ * primeiro espaco; o prefixo pode conter espacos internos.
+ * 
+ * @param linha Linha a interpretar (modificada in-place)
+ * @param out Consulta resultante
+ * @return 1 se valida, 0 se invalida, -1 se vazia ou comentario
+ */
+int consulta_parse(char *linha, Consulta *out) {
+    str_trim(linha);
+    if (linha[0] == '\0' || linha[0] == '#') return -1;
+
+    // Separa o nome do comando do argumento
+    char *arg = linha;
+    while (*arg && !isspace((unsigned char)*arg)) arg++;
+    if (*arg) {
+        *arg++ = '\0';
+        str_trim(arg);
+    }
+
+    for (size_t i = 0; i < sizeof(COMANDOS) / sizeof(COMANDOS[0]); i++) {
+        if (strcmp(linha, COMANDOS[i].nome) != 0) continue;
+
+        out->tipo = COMANDOS[i].tipo;
+        out->arg = arg;
+
+        // Todos os comandos, exceto tabela, estatisticas e memoria, exigem um prefixo
+        int sem_arg = out->tipo == CONSULTA_TABELA || out->tipo == CONSULTA_ESTATISTICAS ||
+                      out->tipo == CONSULTA_MEMORIA;
+        if (!sem_arg && arg[0] == '\0') return 0;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Escreve uma linha do relatorio de memoria.
+ * 
+ * Valores negativos aparecem como "-" (nao se aplica).
+ */
+static void linha_memoria(Escritor *w, const char *nome, long long reservado, long long usado,
+                          long long pico, long long blocos) {
+    char linha[128];
+    char col[4][24];
+    const long long vals[4] = { reservado, usado, pico, blocos };
+    for (int i = 0; i < 4; i++) {
+        if (vals[i] < 0) snprintf(col[i], sizeof(col[i]), "-");
+        else snprintf(col[i], sizeof(col[i]), "%lld", vals[i]);
+    }
+    snprintf(linha, sizeof(linha), "  %-20s %14s %14s %14s %8s\n", nome, col[0], col[1], col[2], col[3]);
+    escritor_str(w, linha);
+}
+
+/**
+ * Escreve o relatorio de memoria por subsistema.
+ * 
+ * 'reservado', 'pico' e 'blocos' vem dos alocadores com etiqueta (todas
+ * as copias, inclusive versoes antigas ainda nao reclamadas no servidor).
+ * 'em uso' e calculado a partir da base consultada: registros validos
+ * dos arrays de times e partidas, e bytes de fato ocupados pelos nomes
+ * dentro dos campos de tamanho fixo.
+ * 
+ * @param bdt Base de times
+ * @param bdp Base de partidas
+ * @param w Escritor de destino
+ */
+static void escrever_memoria(const BDTimes *bdt, const BDPartidas *bdp, Escritor *w) {
+    char linha[128];
+    snprintf(linha, sizeof(linha), "Memoria (bytes):       %14s %14s %14s %8s\n",
+             "reservado", "em uso", "pico", "blocos");
+    escritor_str(w, linha);
+
+    size_t nomes = 0;
+    for (int i = 0; i < bdt->n; i++) nomes += strlen(bdtimes_time(bdt, i)->nome) + 1;
+
+    long long total = 0, total_blocos = 0;
+    for (int t = 0; t < MEM_TOTAL; t++) {
+        EstatMemoria e;
+        mem_estatisticas((TagMemoria)t, &e);
+        long long usado = -1;
+        if (t == MEM_TIMES)    usado = (long long)bdt->n * (long long)sizeof(Time);
+        if (t == MEM_PARTIDAS) usado = (long long)bdp->n * (long long)sizeof(Partida);
+        linha_memoria(w, mem_nome((TagMemoria)t), (long long)e.reservado, usado,
+                      (long long)e.pico, (long long)e.blocos);
+        if (t == MEM_TIMES) {
+            // Nomes ficam dentro de cada Time (MAX_NOME_TIME bytes por time)
+            linha_memoria(w, "  nomes (em times)", (long long)bdt->n * MAX_NOME_TIME,
+                          (long long)nomes, -1, -1);
+        }
+        total += (long long)e.reservado;
+        total_blocos += (long long)e.blocos;
+    }
+    linha_memoria(w, "total", total, -1, -1, total_blocos);
+
+    snprintf(linha, sizeof(linha), "Por registro: time %zu bytes (nome %d), partida %zu bytes\n",
+             sizeof(Time), MAX_NOME_TIME, sizeof(Partida));
+    escritor_str(w, linha);
+}
+
+/**
+ * Escreve e libera os times encontrados por bdtimes_buscar_todos().
+ * 
+ * Nao escreve nada se 'total' for 0; marca erro no escritor se a busca
+ * falhou por falta de memoria.
+ * 
+ * @param bdt Base de times
+ * @param indices Indices encontrados (liberados aqui)
+ * @param total Retorno de bdtimes_buscar_todos()
+ * @param w Escritor de destino
+ */
+static void escrever_busca(const BDTimes *bdt, int *indices, int total, Escritor *w) {
+    if (total < 0) w->erro = 1;
+    if (total > 0) bdtimes_escrever_times(bdt, indices, total, w);
+    mem_liberar(indices);
+}
+
+/**
+ * Executa uma busca de times ("team"): por prefixo e, sem nenhum nome
+ * com o prefixo, pelos modos mais tolerantes.
+ * 
+ * @param texto Prefixo buscado
+ * @param bdt Base de times
+ * @param achados Times com o prefixo ja buscados (bdtimes_buscar_prefixos),
+ *                ou NULL para buscar aqui
+ * @param num_achados Numero de times em 'achados'
+ * @param w Escritor de destino
+ */
+static void executar_time(const char *texto, const BDTimes *bdt, const int *achados, int num_achados,
+                          Escritor *w) {
+    if (achados && num_achados > 0) {
+        bdtimes_escrever_times(bdt, achados, num_achados, w);
+        return;
+    }
+
+    // Com o prefixo ja buscado (sem resultado), comeca pelo trecho
+    ModoBusca modo = achados ? BUSCA_INFIXO : BUSCA_PREFIXO;
+    int *indices;
+    int total = bdtimes_buscar_todos(bdt, modo, texto, &indices);
+    while (total == 0 && modo != BUSCA_APROXIMADA) {
+        modo = (ModoBusca)(modo + 1);
+        total = bdtimes_buscar_todos(bdt, modo, texto, &indices);
+    }
+    if (modo != BUSCA_PREFIXO) {
+        escritor_str(w, "Nenhum time encontrado para prefixo: ");
+        escritor_str(w, texto);
+        escritor_char(w, '\n');
+        if (total > 0) {
+            escritor_str(w, modo == BUSCA_INFIXO ? "Times cujo nome contem o texto:\n"
+                                                 : "Times com nome parecido:\n");
+        }
+    }
+    escrever_busca(bdt, indices, total, w);
+}
+
+/**
+ * Executa uma consulta, com os times de CONSULTA_TIME ja buscados ou nao.
+ * 
+ * @param c Consulta a executar
+ * @param bdt Base de times
+ * @param bdp Base de partidas
+ * @param achados Para CONSULTA_TIME: times com o prefixo, ou NULL
+ * @param num_achados Numero de times em 'achados'
+ * @param w Escritor de destino
+ */
+static void executar(const Consulta *c, const BDTimes *bdt, const BDPartidas *bdp,
+                     const int *achados, int num_achados, Escritor *w) {
+    unsigned long long inicio = rastro_ativo ? metricas_agora_ns() : 0;
+
+    switch (c->tipo) {
+        case CONSULTA_TIME:
+            executar_time(c->arg, bdt, achados, num_achados, w);
+            break;
+        case CONSULTA_INFIXO:
+        case CONSULTA_APROX: {
+            ModoBusca modo = c->tipo == CONSULTA_INFIXO ? BUSCA_INFIXO : BUSCA_APROXIMADA;
+            int *indices;
+            int total = bdtimes_buscar_todos(bdt, modo, c->arg, &indices);
+            if (total == 0) {
+                escritor_str(w, modo == BUSCA_INFIXO ? "Nenhum time cujo nome contem: "
+                                                     : "Nenhum time com nome parecido com: ");
+                escritor_str(w, c->arg);
+                escritor_char(w, '\n');
+            }
+            escrever_busca(bdt, indices, total, w);
+            break;
+        }
+        case CONSULTA_MANDANTE:
+            bdpartidas_escrever_listagem(bdp, bdt, c->arg, FILTRO_MANDANTE, w);
+            break;
+        case CONSULTA_VISITANTE:
+            bdpartidas_escrever_listagem(bdp, bdt, c->arg, FILTRO_VISITANTE, w);
+            break;
+        case CONSULTA_QUALQUER:
+            bdpartidas_escrever_listagem(bdp, bdt, c->arg, FILTRO_QUALQUER, w);
+            break;
+        case CONSULTA_CONTA_MANDANTE:
+            escritor_int(w, bdpartidas_contar_por_prefixo(bdp, bdt, c->arg, FILTRO_MANDANTE));
+            escritor_char(w, '\n');
+            break;
+        case CONSULTA_CONTA_VISITANTE:
+            escritor_int(w, bdpartidas_contar_por_prefixo(bdp, bdt, c->arg, FILTRO_VISITANTE));
+            escritor_char(w, '\n');
+            break;
+        case CONSULTA_CONTA_QUALQUER:
+            escritor_int(w, bdpartidas_contar_por_prefixo(bdp, bdt, c->arg, FILTRO_QUALQUER));
+            escritor_char(w, '\n');
+            break;
+        case CONSULTA_TABELA:
+            bdtimes_escrever_classificacao(bdt, w);
+            break;
+        case CONSULTA_ESTATISTICAS:
+            metricas_escrever(w);
+            break;
+        case CONSULTA_MEMORIA:
+            escrever_memoria(bdt, bdp, w);
+            break;
+        case CONSULTA_ADICIONAR:
+            escritor_str(w, "Comando nao suportado neste modo: add\n");
+            break;
+    }
+
+    // O evento da consulta engloba os de busca e saida registrados dentro dela
+    if (rastro_ativo) {
+        rastro_evento(nome_comando(c->tipo), "consulta", inicio, metricas_agora_ns() - inicio,
+                      c->arg[0] ? c->arg : NULL);
+    }
+}
+
+/**
+ * Executa uma consulta escrevendo o resultado no escritor.
+ * 
+ * @param c Consulta a executar
+ * @param bdt Base de times
+ * @param bdp Base de partidas
+ * @param w Escritor de destino
+ */
+void consulta_executar(const Consulta *c, const BDTimes *bdt, const BDPartidas *bdp, Escritor *w) {
+    executar(c, bdt, bdp, NULL, 0, w);
+}
+
+/**
+ * Le todo o conteudo de um arquivo para a memoria.
+ * 
+ * @param in Arquivo de entrada
+ * @param tam Tamanho lido (em bytes)
+ * @return Buffer terminado em '\0' (liberar com mem_liberar), ou NULL em caso de erro
+ */
+static char* ler_tudo(FILE *in, size_t *tam) {
+    size_t cap = 1 << 16;
+    size_t len = 0;
+    char *buf = mem_alocar(MEM_CONSULTAS, cap);
+    if (!buf) return NULL;
+
+    for (;;) {
+        if (cap - len < 2) {
+            char *novo = mem_realocar(MEM_CONSULTAS, buf, cap * 2);
+            if (!novo) {
+                mem_liberar(buf);
+                return NULL;
+            }
+            buf = novo;
+            cap *= 2;
+        }
+        size_t n = fread(buf + len, 1, cap - len - 1, in);
+        len += n;
+        if (n == 0) break;
+    }
+    if (ferror(in)) {
+        mem_liberar(buf);
+        return NULL;
+    }
+
+    buf[len] = '\0';
+    *tam = len;
+    return buf;
+}
+
+/**
+ * Executa em lote todos os comandos de um arquivo.
+ * 
+ * Etapas:
+ * 1. Le toda a entrada para a memoria
+ * 2. Divide em linhas e interpreta cada uma para um vetor de Consulta
+ * 3. Busca de uma vez os prefixos de todos os "team" (bdtimes_buscar_prefixos)
+ * 4. Executa os comandos em sequencia no mesmo escritor
+ * 
+ * @param in Arquivo de comandos
+ * @param bdt Base de times
+ * @param bdp Base de partidas
+ * @param w Escritor de destino
+ * @return Numero de comandos executados, ou -1 em caso de erro
+ */
+int consulta_executar_lote(FILE *in, const BDTimes *bdt, const BDPartidas *bdp, Escritor *w) {
+    size_t tam;
+    char *texto = ler_tudo(in, &tam);
+    if (!texto) {
+        fprintf(stderr, "Erro ao ler comandos do modo batch.\n");
+        return -1;
+    }
+
+    // Estimativa do numero de linhas para dimensionar o vetor de consultas
+    size_t cap = 1;
+    for (size_t i = 0; i < tam; i++) {
+        if (texto[i] == '\n') cap++;
+    }
+    Consulta *cons = mem_alocar(MEM_CONSULTAS, cap * sizeof(Consulta));
+    if (!cons) {
+        mem_liberar(texto);
+        fprintf(stderr, "Memoria insuficiente para o modo batch.\n");
+        return -1;
+    }
+
+    // Interpreta cada linha uma unica vez
+    int n = 0;
+    int num_linha = 0;
+    char *linha = texto;
+    while (linha < texto + tam) {
+        char *fim = strchr(linha, '\n');
+        if (fim) *fim = '\0';
+        num_linha++;
+
+        int r = consulta_parse(linha, &cons[n]);
+        if (r == 1) {
+            n++;
+        } else if (r == 0) {
+            fprintf(stderr, "Comando invalido na linha %d: %s\n", num_linha, linha);
+        }
+
+        if (!fim) break;
+        linha = fim + 1;
+    }
+
+    // Prefixos de todos os "team", resolvidos num unico lote. Sem memoria
+    // para o lote, cada comando busca o seu.
+    int num_times = 0;
+    for (int i = 0; i < n; i++) num_times += cons[i].tipo == CONSULTA_TIME;
+    LotePrefixos lote = { NULL, NULL };
+    const char **prefixos = num_times ? mem_alocar(MEM_CONSULTAS, (size_t)num_times * sizeof(const char*)) : NULL;
+    if (prefixos) {
+        int k = 0;
+        for (int i = 0; i < n; i++) {
+            if (cons[i].tipo == CONSULTA_TIME) prefixos[k++] = cons[i].arg;
+        }
+        bdtimes_buscar_prefixos(bdt, prefixos, num_times, &lote);
+        mem_liberar(prefixos);
+    }
+
+    // Executa todos os comandos em sequencia
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        if (cons[i].tipo == CONSULTA_TIME && lote.inicio) {
+            executar(&cons[i], bdt, bdp, lote.indices + lote.inicio[k],
+                     lote.inicio[k + 1] - lote.inicio[k], w);
+            k++;
+        } else {
+            executar(&cons[i], bdt, bdp, NULL, 0, w);
+        }
+    }
+
+    bdtimes_liberar_lote(&lote);
+    mem_liberar(cons);
+    mem_liberar(texto);
+    return n;
+}
@@ -0,0 +1,291 @@
+/**
+ * Modulo: escritor.c
+ *
+ * Implementa o escritor bufferizado usado por todas as rotinas de saida
+ * de alto volume (exportacao da classificacao, listagens, modo batch).
+ *
+ * A ideia e simples: em vez de chamar printf/fputc para cada campo,
+ * os bytes sao acumulados em um buffer de ESCRITOR_BUFFER bytes e
+ * gravados de uma so vez com fwrite quando o buffer enche.
+ */
+
+#include "escritor.h"
+#include "memoria.h"
+#include "metricas.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Inicializa os campos comuns do escritor.
+ *
+ * @param w Escritor
+ * @param f Arquivo de destino
+ * @param proprio 1 se o escritor deve fechar o arquivo ao final
+ */
+static void escritor_iniciar(Escritor *w, FILE *f, int proprio) {
+    w->f = f;
+    w->mem = NULL;
+    w->mem_len = 0;
+    w->mem_cap = 0;
+    w->proprio = proprio;
+    w->erro = 0;
+    w->len = 0;
+}
+
+/**
+ * Abre um arquivo para escrita bufferizada.
+ *
+ * @param w Escritor a ser inicializado
+ * @param caminho Caminho do arquivo a criar/sobrescrever
+ * @return 1 se o arquivo foi aberto, 0 em caso de erro
+ */
+int escritor_abrir(Escritor *w, const char *caminho) {
+    FILE *f = fopen(caminho, "wb");
+    if (!f) {
+        escritor_iniciar(w, NULL, 0);
+        w->erro = 1;
+        return 0;
+    }
+    escritor_iniciar(w, f, 1);
+    return 1;
+}
+
+/**
+ * Associa o escritor a um FILE ja aberto.
+ *
+ * @param w Escritor a ser inicializado
+ * @param f Arquivo de destino (ex: stdout)
+ */
+void escritor_de_arquivo(Escritor *w, FILE *f) {
+    escritor_iniciar(w, f, 0);
+}
+
+/**
+ * Inicializa o escritor no modo memoria.
+ *
+ * @param w Escritor a ser inicializado
+ */
+void escritor_memoria(Escritor *w) {
+    escritor_iniciar(w, NULL, 0);
+}
+
+/**
+ * Acrescenta bytes ao final da saida em memoria, aumentando-a se preciso.
+ *
+ * @param w Escritor no modo memoria
+ * @param dados Bytes a acrescentar
+ * @param n Quantidade de bytes
+ */
+static void memoria_acrescentar(Escritor *w, const void *dados, size_t n) {
+    if (w->mem_len + n > w->mem_cap) {
+        size_t cap = w->mem_cap ? w->mem_cap : ESCRITOR_BUFFER;
+        while (cap < w->mem_len + n) cap *= 2;
+        char *novo = mem_realocar(MEM_ESCRITORES, w->mem, cap);
+        if (!novo) {
+            w->erro = 1;
+            return;
+        }
+        w->mem = novo;
+        w->mem_cap = cap;
+    }
+    memcpy(w->mem + w->mem_len, dados, n);
+    w->mem_len += n;
+}
+
+/**
+ * Retorna a saida acumulada por um escritor no modo memoria.
+ *
+ * @param w Escritor no modo memoria
+ * @param len Onde o numero de bytes sera armazenado
+ * @return Ponteiro para os bytes
+ */
+const char* escritor_conteudo(Escritor *w, size_t *len) {
+    escritor_descarregar(w);
+    *len = w->mem_len;
+    return w->mem ? w->mem : "";
+}
+
+/**
+ * Descarta a saida acumulada, mantendo a memoria alocada.
+ *
+ * @param w Escritor no modo memoria
+ */
+void escritor_limpar(Escritor *w) {
+    w->len = 0;
+    w->mem_len = 0;
+    w->erro = 0;
+}
+
+/**
+ * Libera a memoria de um escritor no modo memoria.
+ *
+ * @param w Escritor no modo memoria
+ */
+void escritor_liberar(Escritor *w) {
+    mem_liberar(w->mem);
+    escritor_iniciar(w, NULL, 0);
+}
+
+/**
+ * Grava os bytes pendentes no arquivo de destino (ou na memoria).
+ *
+ * @param w Escritor
+ * @return 1 se nao houve erro ate agora, 0 caso contrario
+ */
+int escritor_descarregar(Escritor *w) {
+    if (w->len > 0 && !w->erro) {
+        metricas_somar(MET_BYTES_ESCRITOS, w->len);
+        if (!w->f) {
+            memoria_acrescentar(w, w->buf, w->len);
+        } else if (fwrite(w->buf, 1, w->len, w->f) != w->len) {
+            w->erro = 1;
+        }
+    }
+    w->len = 0;
+    return !w->erro;
+}
+
+/**
+ * Descarrega o buffer e fecha o arquivo, se for proprio.
+ *
+ * @param w Escritor
+ * @return 1 se toda a saida foi gravada com sucesso, 0 caso contrario
+ */
+int escritor_fechar(Escritor *w) {
+    if (!w->f) return 0;
+
+    escritor_descarregar(w);
+    if (w->proprio) {
+        if (fclose(w->f) != 0) w->erro = 1;
+    } else {
+        fflush(w->f);
+    }
+    w->f = NULL;
+    return !w->erro;
+}
+
+/**
+ * Escreve 'n' bytes arbitrarios.
+ *
+ * Blocos maiores que o buffer sao gravados diretamente, sem copia.
+ *
+ * @param w Escritor
+ * @param dados Bytes a escrever
+ * @param n Quantidade de bytes
+ */
+void escritor_bytes(Escritor *w, const void *dados, size_t n) {
+    if (w->erro) return;
+
+    // Se nao cabe no espaco restante, esvazia o buffer antes
+    if (w->len + n > ESCRITOR_BUFFER) {
+        escritor_descarregar(w);
+
+        // Bloco grande: grava direto no destino
+        if (n >= ESCRITOR_BUFFER) {
+            metricas_somar(MET_BYTES_ESCRITOS, n);
+            if (!w->f) {
+                memoria_acrescentar(w, dados, n);
+            } else if (fwrite(dados, 1, n, w->f) != n) {
+                w->erro = 1;
+            }
+            return;
+        }
+    }
+
+    memcpy(w->buf + w->len, dados, n);
+    w->len += n;
+}
+
+/**
+ * Escreve uma string terminada em '\0'.
+ *
+ * @param w Escritor
+ * @param s String a escrever
+ */
+void escritor_str(Escritor *w, const char *s) {
+    escritor_bytes(w, s, strlen(s));
+}
+
+/**
+ * Escreve um unico caractere.
+ *
+ * @param w Escritor
+ * @param c Caractere a escrever
+ */
+void escritor_char(Escritor *w, char c) {
+    if (w->len == ESCRITOR_BUFFER) escritor_descarregar(w);
+    if (w->erro) return;
+    w->buf[w->len++] = c;
+}
+
+/**
+ * Escreve o caractere 'c' repetido 'n' vezes.
+ *
+ * @param w Escritor
+ * @param c Caractere de preenchimento
+ * @param n Numero de repeticoes
+ */
+void escritor_repetir(Escritor *w, char c, int n) {
+    while (n > 0) {
+        if (w->len == ESCRITOR_BUFFER) escritor_descarregar(w);
+        if (w->erro) return;
+
+        // Preenche o maximo possivel de uma vez com memset
+        size_t livre = ESCRITOR_BUFFER - w->len;
+        size_t k = (size_t)n < livre ? (size_t)n : livre;
+        memset(w->buf + w->len, c, k);
+        w->len += k;
+        n -= (int)k;
+    }
+}
+
+/**
+ * Escreve um inteiro em decimal.
+ *
+ * @param w Escritor
+ * @param v Valor a escrever
+ */
+void escritor_int(Escritor *w, int v) {
+    escritor_int_ajustado(w, v, 0);
+}
+
+/**
+ * Escreve um inteiro alinhado a esquerda em uma coluna de largura fixa.
+ *
+ * Converte os digitos de tras para frente em um buffer local,
+ * evitando o custo de interpretar uma string de formato.
+ *
+ * @param w Escritor
+ * @param v Valor a escrever
+ * @param largura Largura minima da coluna
+ */
+void escritor_int_ajustado(Escritor *w, int v, int largura) {
+    char tmp[12];
+    int i = (int)sizeof(tmp);
+
+    // Usa unsigned para tratar INT_MIN sem overflow
+    unsigned int u = v < 0 ? 0u - (unsigned int)v : (unsigned int)v;
+    do {
+        tmp[--i] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (v < 0) tmp[--i] = '-';
+
+    int n = (int)sizeof(tmp) - i;
+    escritor_bytes(w, tmp + i, (size_t)n);
+    escritor_repetir(w, ' ', largura - n);
+}
+
+/**
+ * Escreve uma string UTF-8 ajustada para uma largura visual fixa.
+ *
+ * @param w Escritor
+ * @param s String UTF-8
+ * @param largura Largura visual desejada (em colunas)
+ */
+void escritor_utf8_ajustado(Escritor *w, const char *s, int largura) {
+    char tmp[512];
+    int n = utf8_ajustar(tmp, sizeof(tmp), s, largura);
+    escritor_bytes(w, tmp, (size_t)n);
+}
@@ -0,0 +1,104 @@
+/**
+ * Modulo: fila_spsc.c
+ * 
+ * Implementa a fila circular sem travas de um produtor e um consumidor.
+ * 
+ * Os indices 'cabeca' e 'cauda' crescem indefinidamente; a posicao real
+ * e o indice modulo FILA_SLOTS. A fila esta cheia quando
+ * cauda - cabeca == FILA_SLOTS e vazia quando cauda == cabeca.
+ * 
+ * Ordenacao de memoria:
+ * - O produtor preenche o lote e publica com 'release' na cauda; o
+ *   consumidor le a cauda com 'acquire', garantindo que ve o lote completo
+ * - Simetricamente, o consumidor libera com 'release' na cabeca e o
+ *   produtor a le com 'acquire' antes de reutilizar a posicao
+ */
+
+#include "fila_spsc.h"
+
+/**
+ * Inicializa a fila vazia.
+ * 
+ * @param f Fila
+ */
+void fila_iniciar(FilaSPSC *f) {
+    atomic_init(&f->cabeca, 0);
+    atomic_init(&f->cauda, 0);
+    atomic_init(&f->fechada, 0);
+    f->pico = 0;
+}
+
+/**
+ * (Produtor) Obtem a proxima posicao livre.
+ * 
+ * @param f Fila
+ * @return Lote a preencher, ou NULL se cheia
+ */
+LotePartidas* fila_reservar(FilaSPSC *f) {
+    size_t cauda = atomic_load_explicit(&f->cauda, memory_order_relaxed);
+    size_t cabeca = atomic_load_explicit(&f->cabeca, memory_order_acquire);
+    if (cauda - cabeca == FILA_SLOTS) return NULL;
+    return &f->slots[cauda & (FILA_SLOTS - 1)];
+}
+
+/**
+ * (Produtor) Publica o lote reservado.
+ * 
+ * Tambem atualiza o pico de ocupacao, usado para dimensionar a fila.
+ * 
+ * @param f Fila
+ */
+void fila_publicar(FilaSPSC *f) {
+    size_t cauda = atomic_load_explicit(&f->cauda, memory_order_relaxed) + 1;
+    atomic_store_explicit(&f->cauda, cauda, memory_order_release);
+
+    size_t ocupacao = cauda - atomic_load_explicit(&f->cabeca, memory_order_relaxed);
+    if (ocupacao > f->pico) f->pico = ocupacao;
+}
+
+/**
+ * (Produtor) Indica que nao havera mais lotes.
+ * 
+ * @param f Fila
+ */
+void fila_fechar(FilaSPSC *f) {
+    atomic_store_explicit(&f->fechada, 1, memory_order_release);
+}
+
+/**
+ * (Consumidor) Obtem o proximo lote publicado.
+ * 
+ * @param f Fila
+ * @return Lote a consumir, ou NULL se vazia
+ */
+const LotePartidas* fila_frente(FilaSPSC *f) {
+    size_t cabeca = atomic_load_explicit(&f->cabeca, memory_order_relaxed);
+    size_t cauda = atomic_load_explicit(&f->cauda, memory_order_acquire);
+    if (cabeca == cauda) return NULL;
+    return &f->slots[cabeca & (FILA_SLOTS - 1)];
+}
+
+/**
+ * (Consumidor) Libera o lote consumido.
+ * 
+ * @param f Fila
+ */
+void fila_consumir(FilaSPSC *f) {
+    size_t cabeca = atomic_load_explicit(&f->cabeca, memory_order_relaxed);
+    atomic_store_explicit(&f->cabeca, cabeca + 1, memory_order_release);
+}
+
+/**
+ * (Consumidor) Verifica se o produtor terminou e nao ha mais lotes.
+ * 
+ * 'fechada' e lida antes da cauda: se o produtor ja fechou, todos os
+ * lotes que ele publicou estao visiveis na leitura seguinte da cauda.
+ * 
+ * @param f Fila
+ * @return 1 se terminou
+ */
+int fila_terminou(FilaSPSC *f) {
+    if (!atomic_load_explicit(&f->fechada, memory_order_acquire)) return 0;
+    return atomic_load_explicit(&f->cauda, memory_order_acquire) ==
+           atomic_load_explicit(&f->cabeca, memory_order_relaxed);
+}
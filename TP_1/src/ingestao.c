@@ -0,0 +1,200 @@
+/**
+ * Modulo: ingestao.c
+ * 
+ * Implementa a carga de partidas em duas etapas concorrentes:
+ * 
+ *   [thread parser]  fgets -> bdpartidas_parse_linha -> lote
+ *        |
+ *        v  FilaSPSC (FILA_SLOTS lotes de FILA_LOTE partidas)
+ *        |
+ *   [thread agregadora]  armazena em BDPartidas -> bdpartidas_aplicar_intervalo
+ * 
+ * Quando a fila esta cheia (ou vazia), a thread correspondente cede o
+ * processador com sched_yield() em vez de girar: em maquinas com um unico
+ * nucleo, girar impediria a outra thread de avancar.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ingestao.h"
+#include "fila_spsc.h"
+#include "memoria.h"
+#include "metricas.h"
+#include "rastro.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Estado compartilhado entre a thread parser e a agregadora.
+ */
+typedef struct {
+    FilaSPSC fila;          // Fila de lotes
+    FILE *f;                // Arquivo aberto (ja sem o cabecalho)
+    int ignoradas;          // Linhas rejeitadas (escrito apenas pelo parser)
+    atomic_int cancelar;    // 1 quando a agregadora nao aceita mais partidas
+} Pipeline;
+
+/**
+ * Corpo da thread parser: le o arquivo e publica lotes na fila.
+ * 
+ * @param arg Ponteiro para o Pipeline
+ * @return Sempre NULL
+ */
+static void* thread_parser(void *arg) {
+    Pipeline *pp = arg;
+    rastro_nomear_thread("parser");
+    char buf[512];
+    LotePartidas *lote = NULL;
+    unsigned long long inicio = metricas_agora_ns();
+    unsigned long long linhas = 0, bytes = 0;
+
+    while (!atomic_load_explicit(&pp->cancelar, memory_order_relaxed) &&
+           fgets(buf, sizeof(buf), pp->f)) {
+        size_t len = strlen(buf);
+        linhas++;
+        bytes += len;
+
+        Partida p;
+        if (!bdpartidas_parse_linha(buf, len, &p)) {
+            fprintf(stderr, "Linha de partida ignorada (parse falhou): %s", buf);
+            pp->ignoradas++;
+            continue;
+        }
+
+        // Obtem uma posicao livre, esperando a agregadora se a fila encher
+        while (!lote) {
+            lote = fila_reservar(&pp->fila);
+            if (lote) lote->n = 0;
+            else sched_yield();
+        }
+        lote->itens[lote->n++] = p;
+
+        if (lote->n == FILA_LOTE) {
+            fila_publicar(&pp->fila);
+            lote = NULL;
+        }
+    }
+
+    // Publica o ultimo lote parcial
+    if (lote && lote->n > 0) fila_publicar(&pp->fila);
+    fila_fechar(&pp->fila);
+
+    // Metricas no bloco desta thread (somadas as demais na leitura)
+    metricas_somar(MET_LINHAS_LIDAS, linhas);
+    metricas_somar(MET_LINHAS_REJEITADAS, (unsigned long long)pp->ignoradas);
+    metricas_somar(MET_BYTES_LIDOS, bytes);
+    metricas_tempo(MET_NS_CARGA_PARTIDAS, inicio);
+    return NULL;
+}
+
+/**
+ * Carrega as partidas de um CSV e aplica os resultados nos times.
+ * 
+ * @param bdp Base de partidas
+ * @param bdt Base de times
+ * @param caminho Caminho do arquivo CSV de partidas
+ * @param est Estatisticas da carga (pode ser NULL)
+ * @return Numero de partidas carregadas, ou 0 se houver erro ao abrir
+ */
+int ingestao_carregar_partidas(BDPartidas *bdp, BDTimes *bdt, const char *caminho, EstatIngestao *est) {
+    if (est) memset(est, 0, sizeof(*est));
+
+    // Abre e valida o arquivo antes de criar a thread, para reportar
+    // erros de forma sincrona (mesmas mensagens de bdpartidas_carregar_csv)
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        fprintf(stderr, "Erro ao abrir arquivo de partidas: %s\n", caminho);
+        return 0;
+    }
+    char buf[512];
+    if (!fgets(buf, sizeof(buf), f)) {
+        fclose(f);
+        fprintf(stderr, "Arquivo de partidas vazio ou invalido: %s\n", caminho);
+        return 0;
+    }
+    metricas_somar(MET_BYTES_LIDOS, strlen(buf));
+
+    // A fila tem centenas de KiB: fica no heap, nao na pilha
+    Pipeline *pp = mem_alocar_alinhada(MEM_FILA, _Alignof(Pipeline), sizeof(Pipeline));
+    if (!pp) {
+        fclose(f);
+        fprintf(stderr, "Memoria insuficiente para carregar partidas.\n");
+        return 0;
+    }
+    fila_iniciar(&pp->fila);
+    pp->f = f;
+    pp->ignoradas = 0;
+    atomic_init(&pp->cancelar, 0);
+
+    pthread_t parser;
+    if (pthread_create(&parser, NULL, thread_parser, pp) != 0) {
+        // Sem thread auxiliar: carga sequencial tradicional
+        mem_liberar(pp);
+        fclose(f);
+        int n = bdpartidas_carregar_csv(bdp, caminho);
+        bdpartidas_aplicar_em_bdtimes(bdp, bdt);
+        if (est) est->carregadas = n;
+        return n;
+    }
+
+    // Agregadora: consome os lotes na ordem em que foram produzidos. Com a
+    // agregacao por blocos, junta os lotes ate um trecho inteiro da particao
+    int count = 0;
+    size_t lotes = 0;
+    int sem_memoria = 0;
+    int juntar = bdpartidas_agregando_por_blocos() ? PARTIDAS_POR_AGREGACAO : 1;
+    int pendente = bdp->n;  // Primeira partida armazenada e ainda nao aplicada
+    for (;;) {
+        const LotePartidas *lote = fila_frente(&pp->fila);
+        if (!lote) {
+            if (fila_terminou(&pp->fila)) break;
+            sched_yield();
+            continue;
+        }
+
+        // Se faltar memoria, apenas esvazia a fila ate o parser parar
+        unsigned long long inicio = metricas_agora_ns();
+        int antes = count;
+        for (int i = 0; i < lote->n && !sem_memoria; i++) {
+            if (!bdpartidas_adicionar(bdp, &lote->itens[i])) {
+                fprintf(stderr, "Memoria insuficiente ao carregar partidas (%d carregadas)\n", count);
+                atomic_store_explicit(&pp->cancelar, 1, memory_order_relaxed);
+                sem_memoria = 1;
+                break;
+            }
+            count++;
+        }
+        // Aplica os lotes armazenados de uma vez (times localizados em blocos)
+        if (bdp->n - pendente >= juntar) {
+            bdpartidas_aplicar_intervalo(bdp, pendente, bdp->n, bdt);
+            pendente = bdp->n;
+        }
+        metricas_somar(MET_PARTIDAS_AGREGADAS, (unsigned long long)(count - antes));
+        metricas_tempo(MET_NS_AGREGACAO, inicio);
+        lotes++;
+        fila_consumir(&pp->fila);
+    }
+
+    if (bdp->n > pendente) {
+        unsigned long long inicio = metricas_agora_ns();
+        bdpartidas_aplicar_intervalo(bdp, pendente, bdp->n, bdt);
+        metricas_tempo(MET_NS_AGREGACAO, inicio);
+    }
+    pthread_join(parser, NULL);
+
+    if (est) {
+        est->carregadas = count;
+        est->ignoradas = pp->ignoradas;
+        est->lotes = lotes;
+        est->pico_fila = pp->fila.pico;
+        est->capacidade_fila = FILA_SLOTS;
+    }
+
+    fclose(f);
+    mem_liberar(pp);
+    return count;
+}
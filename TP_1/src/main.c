@@ -16,12 +16,25 @@
  * 2. Carrega partidas do arquivo CSV
  * 3. Aplica resultados das partidas nas estatisticas dos times
  * 4. Exibe menu interativo ate o usuario sair
+ *    (ou, no modo --batch, executa os comandos de um arquivo e termina;
+ *    no modo --servidor, responde consultas por um socket UNIX)
+ * 
+ * As etapas 2 e 3 rodam em pipeline (ver ingestao.h): uma thread interpreta
+ * o CSV enquanto a thread principal agrega as estatisticas.
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "bd_times.h"
 #include "bd_partidas.h"
+#include "completar.h"
+#include "consulta.h"
+#include "ingestao.h"
+#include "memoria.h"
+#include "metricas.h"
+#include "rastro.h"
+#include "servidor.h"
 #include "utils.h"
 
 // Inclui windows.h apenas se estiver compilando no Windows
@@ -36,6 +49,8 @@
  * - Consultar times por nome/prefixo
  * - Consultar partidas realizadas
  * - Imprimir tabela de classificacao completa
+ * - Exibir as estatisticas internas (contadores e tempos)
+ * - Exibir o uso de memoria por subsistema
  * - Sair do sistema
  * 
  * Funcao auxiliar chamada em loop pelo main().
@@ -45,6 +60,8 @@ static void menu(void) {
     printf("1 - Consultar time\n");
     printf("2 - Consultar partidas\n");
     printf("6 - Imprimir tabela de classificacao\n");
+    printf("7 - Estatisticas\n");
+    printf("8 - Memoria\n");
     printf("Q - Sair\n");
     printf("Opcao: ");
 }
@@ -69,9 +86,16 @@ static void menu(void) {
 static void consultar_time(BDTimes *bdt) {
     char buf[128];
     
-    // Solicita o prefixo ao usuario
-    printf("Digite o nome ou prefixo do time: ");
-    if (!read_line(buf, sizeof(buf))) return;
+    // Solicita o prefixo ao usuario: num terminal, com completacao a cada
+    // tecla (completar.h); fora dele (ex: entrada redirecionada), a linha
+    // inteira
+    const char *rotulo = "Digite o nome ou prefixo do time: ";
+    int lido = completar_ler_nome(bdt, rotulo, buf, sizeof(buf));
+    if (lido == 0) return;
+    if (lido < 0) {
+        printf("%s", rotulo);
+        if (!read_line(buf, sizeof(buf))) return;
+    }
     
     // Remove espacos em branco das pontas
     str_trim(buf);
@@ -82,13 +106,27 @@ static void consultar_time(BDTimes *bdt) {
         return;
     }
     
-    // Busca times que correspondem ao prefixo
-    int indices[64];  // Array para armazenar indices dos times encontrados
-    int total = bdtimes_buscar_por_prefixo(bdt, buf, indices, 64);
-    
-    // Verifica se algum time foi encontrado
-    if (total <= 0) {
+    // Busca os times que correspondem ao prefixo. Sem nenhum, tenta os
+    // nomes que contem o texto e depois a busca aproximada (erros de
+    // digitacao, acentos)
+    ModoBusca modo = BUSCA_PREFIXO;
+    int *indices;
+    int total = bdtimes_buscar_todos(bdt, modo, buf, &indices);
+    while (total == 0 && modo != BUSCA_APROXIMADA) {
+        modo = (ModoBusca)(modo + 1);
+        total = bdtimes_buscar_todos(bdt, modo, buf, &indices);
+    }
+    if (modo != BUSCA_PREFIXO) {
         printf("Nenhum time encontrado para prefixo: %s\n", buf);
+        if (total == 0) return;
+        if (total > 0) {
+            printf(modo == BUSCA_INFIXO ? "Times cujo nome contem o texto:\n"
+                                        : "Times com nome parecido:\n");
+        }
+    }
+    
+    if (total < 0) {
+        printf("Memoria insuficiente.\n");
         return;
     }
     
@@ -97,12 +135,13 @@ static void consultar_time(BDTimes *bdt) {
     printf("|----|------|---|---|---|----|----|----|----|\n");
     
     // Imprime cada time encontrado
-    for (int i = 0; i < total && i < 64; i++) {
-        Time *t = &bdt->times[indices[i]];
+    for (int i = 0; i < total; i++) {
+        const Time *t = bdtimes_time(bdt, indices[i]);
         printf("| %d | %s | %d | %d | %d | %d | %d | %d | %d |\n",
             t->id, t->nome, t->v, t->e, t->d, t->gm, t->gs, 
             time_saldo(t), time_pontos(t));
     }
+    mem_liberar(indices);
 }
 
 /**
@@ -171,6 +210,75 @@ static void consultar_partidas(const BDPartidas *bdp, const BDTimes *bdt) {
     }
 }
 
+/**
+ * Escreve o relatorio de metricas (metricas.h) em um arquivo.
+ * 
+ * Usado pela opcao 7 do menu (stdout) e por --stats ao encerrar (stderr).
+ * 
+ * @param f Arquivo de destino
+ */
+static void mostrar_estatisticas(FILE *f) {
+    Escritor *w = mem_alocar(MEM_ESCRITORES, sizeof(Escritor));
+    if (!w) return;
+    escritor_de_arquivo(w, f);
+    metricas_escrever(w);
+    escritor_fechar(w);
+    mem_liberar(w);
+}
+
+/**
+ * Exibe a forma de uso do programa na saida de erro.
+ * 
+ * @param prog Nome do executavel (argv[0])
+ */
+static void uso(const char *prog) {
+    fprintf(stderr, "Uso: %s [opcoes] [times.csv] [partidas.csv]\n", prog);
+    fprintf(stderr, "Opcoes:\n");
+    fprintf(stderr, "  --formato <tabela|csv|jsonl|bin>  formato do arquivo de classificacao exportado\n");
+    fprintf(stderr, "  --batch <arquivo|->               executa comandos (team/contains/fuzzy/home/away/any/table/stats/mem) sem menu\n");
+    fprintf(stderr, "  --servidor <socket>               responde consultas por um socket UNIX\n");
+    fprintf(stderr, "  --workers <n>                     threads trabalhadoras do servidor (padrao %d)\n",
+            SERVIDOR_WORKERS_PADRAO);
+    fprintf(stderr, "  --estat-carga                     mostra estatisticas da carga de partidas (fila)\n");
+    fprintf(stderr, "  --stats                           mostra contadores e tempos internos ao encerrar\n");
+    fprintf(stderr, "  --trace <arquivo>                 grava o rastro das etapas (JSON do Chrome/Perfetto)\n");
+    fprintf(stderr, "  --agregar-por-blocos              agrega as partidas agrupadas por bloco de times\n");
+}
+
+/**
+ * Executa o modo batch: comandos lidos de um arquivo (ou stdin, com "-"),
+ * resultados escritos em stdout por um escritor bufferizado, sem prompts.
+ * 
+ * @param caminho Arquivo de comandos, ou "-" para stdin
+ * @param bdt Base de times
+ * @param bdp Base de partidas
+ * @return 0 se sucesso, 1 em caso de erro
+ */
+static int executar_batch(const char *caminho, const BDTimes *bdt, const BDPartidas *bdp) {
+    FILE *in = stdin;
+    if (strcmp(caminho, "-") != 0) {
+        in = fopen(caminho, "rb");
+        if (!in) {
+            fprintf(stderr, "Erro ao abrir arquivo de comandos: %s\n", caminho);
+            return 1;
+        }
+    }
+
+    Escritor *w = mem_alocar(MEM_ESCRITORES, sizeof(Escritor));
+    if (!w) {
+        if (in != stdin) fclose(in);
+        return 1;
+    }
+    escritor_de_arquivo(w, stdout);
+
+    int n = consulta_executar_lote(in, bdt, bdp, w);
+    int ok = escritor_fechar(w) && n >= 0;
+
+    mem_liberar(w);
+    if (in != stdin) fclose(in);
+    return ok ? 0 : 1;
+}
+
 /**
  * Funcao principal do programa.
  * 
@@ -185,6 +293,16 @@ static void consultar_partidas(const BDPartidas *bdp, const BDTimes *bdt) {
  * Argumentos de linha de comando (opcionais):
  * - argv[1]: Caminho do arquivo CSV de times
  * - argv[2]: Caminho do arquivo CSV de partidas
+ * - --formato <nome>: Formato do arquivo exportado junto com a classificacao
+ *   ("tabela" (padrao), "csv", "jsonl" ou "bin")
+ * - --batch <arquivo|->: Executa os comandos do arquivo (ou stdin) sem menu
+ * - --servidor <socket>: Atende consultas por um socket UNIX (ver servidor.h)
+ * - --workers <n>: Numero de threads trabalhadoras do servidor
+ * - --estat-carga: Mostra em stderr as estatisticas da carga em pipeline
+ * - --stats: Mostra em stderr, ao encerrar, as metricas internas (metricas.h)
+ * - --trace <arquivo>: Grava o rastro das etapas para um visualizador (rastro.h)
+ * - --agregar-por-blocos: Agrega as partidas por bloco de times
+ *   (bdpartidas_agregar_por_blocos)
  * 
  * Se nao fornecidos, usa "times.csv" e "partidas.csv" do diretorio atual.
  * 
@@ -202,13 +320,77 @@ int main(int argc, char *argv[]) {
     // Define os caminhos padrao dos arquivos CSV
     const char *times_path = "times.csv";
     const char *partidas_path = "partidas.csv";
+    FormatoExport formato = EXPORT_TABELA;
+    const char *batch_path = NULL;
+    const char *socket_path = NULL;
+    int workers = SERVIDOR_WORKERS_PADRAO;
+    int estat_carga = 0;
+    int stats = 0;
+    
+    // Separa as opcoes (--nome) dos argumentos posicionais
+    const char *posicionais[2];
+    int npos = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--formato") == 0) {
+            if (i + 1 >= argc || !bdtimes_formato_de_nome(argv[i + 1], &formato)) {
+                fprintf(stderr, "Formato invalido para --formato.\n");
+                uso(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Faltou o arquivo de comandos para --batch.\n");
+                uso(argv[0]);
+                return 1;
+            }
+            batch_path = argv[++i];
+        } else if (strcmp(argv[i], "--servidor") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Faltou o caminho do socket para --servidor.\n");
+                uso(argv[0]);
+                return 1;
+            }
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0) {
+            if (i + 1 >= argc || !safe_atoi(argv[i + 1], &workers) || workers < 1) {
+                fprintf(stderr, "Numero invalido para --workers.\n");
+                uso(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--estat-carga") == 0) {
+            estat_carga = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = 1;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Faltou o arquivo de rastro para --trace.\n");
+                uso(argv[0]);
+                return 1;
+            }
+            if (!rastro_abrir(argv[i + 1])) {
+                fprintf(stderr, "Erro ao criar arquivo de rastro: %s\n", argv[i + 1]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--agregar-por-blocos") == 0) {
+            bdpartidas_agregar_por_blocos(1);
+        } else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "Opcao desconhecida: %s\n", argv[i]);
+            uso(argv[0]);
+            return 1;
+        } else if (npos < 2) {
+            posicionais[npos++] = argv[i];
+        }
+    }
     
     // Verifica se o usuario passou caminhos customizados via linha de comando
-    if (argc >= 3) {
+    if (npos >= 2) {
         // Usa os caminhos fornecidos pelo usuario
-        times_path = argv[1];
-        partidas_path = argv[2];
-    } else {
+        times_path = posicionais[0];
+        partidas_path = posicionais[1];
+    } else if (!batch_path && !socket_path) {
         // Informa ao usuario como usar argumentos customizados
         printf("Dica: voce pode passar caminhos dos CSVs: %s <times.csv> <partidas.csv>\n", argv[0]);
         printf("Tentando abrir 'times.csv' e 'partidas.csv' do diretorio atual.\n");
@@ -219,6 +401,7 @@ int main(int argc, char *argv[]) {
     BDPartidas bdp;     // Base de dados de partidas
     bdtimes_init(&bdt);
     bdpartidas_init(&bdp);
+    unsigned long long inicio_carga = metricas_agora_ns();
 
     // Carrega os times do arquivo CSV
     if (!bdtimes_carregar_csv(&bdt, times_path)) {
@@ -227,18 +410,45 @@ int main(int argc, char *argv[]) {
         return 1;  // Encerra com codigo de erro
     }
     
-    // Carrega as partidas do arquivo CSV
-    // Nota: As estatisticas dos times comecam zeradas e serao
-    // calculadas na proxima etapa ao aplicar as partidas
-    if (!bdpartidas_carregar_csv(&bdp, partidas_path)) {
+    // Carrega as partidas do arquivo CSV e aplica os resultados nos times
+    // Nota: As estatisticas dos times comecam zeradas; cada partida lida
+    // atualiza vitorias, empates, derrotas e gols marcados/sofridos
+    EstatIngestao est;
+    if (!ingestao_carregar_partidas(&bdp, &bdt, partidas_path, &est)) {
         // Erro ao carregar partidas, mas o sistema pode continuar
         // funcionando com consulta de times (estatisticas zeradas)
         fprintf(stderr, "Falha ao carregar partidas.\n");
+    } else if (estat_carga) {
+        fprintf(stderr, "Carga: %d partidas, %d linhas ignoradas, %zu lotes, pico da fila %zu/%zu lotes\n",
+                est.carregadas, est.ignoradas, est.lotes, est.pico_fila, est.capacidade_fila);
+    }
+    rastro_evento("carga dos CSVs", "carga", inicio_carga, metricas_agora_ns() - inicio_carga, NULL);
+
+    // Modo batch: executa os comandos e termina, sem menu
+    if (batch_path) {
+        int ret = executar_batch(batch_path, &bdt, &bdp);
+        bdtimes_liberar(&bdt);
+        bdpartidas_liberar(&bdp);
+        if (stats) mostrar_estatisticas(stderr);
+        return ret;
+    }
+
+    // Modo servidor: dados ja carregados, atende consultas ate SIGINT/SIGTERM
+    if (socket_path) {
+        // A base versionada guarda sua propria copia dos dados
+        BDVersionada bv;
+        int ok = bdversoes_iniciar(&bv, &bdt, &bdp);
+        bdtimes_liberar(&bdt);
+        bdpartidas_liberar(&bdp);
+        if (!ok) {
+            fprintf(stderr, "Memoria insuficiente para o modo servidor.\n");
+            return 1;
+        }
+        int ret = servidor_executar(socket_path, workers, &bv);
+        bdversoes_liberar(&bv);
+        if (stats) mostrar_estatisticas(stderr);
+        return ret;
     }
-    
-    // Aplica os resultados de todas as partidas nas estatisticas dos times
-    // Esta funcao atualiza: vitorias, empates, derrotas, gols marcados/sofridos
-    bdpartidas_aplicar_em_bdtimes(&bdp, &bdt);
 
     // Loop principal do programa - executa ate o usuario escolher sair
     for (;;) {
@@ -266,8 +476,25 @@ int main(int argc, char *argv[]) {
             case '6':
                 // Opcao 6: Imprimir e exportar tabela de classificacao
                 printf("Imprimindo classificacao.\n");
-                bdtimes_imprimir_classificacao(&bdt);
+                bdtimes_imprimir_classificacao(&bdt, formato);
+                break;
+                
+            case '7':
+                // Opcao 7: Contadores e tempos internos
+                mostrar_estatisticas(stdout);
+                break;
+                
+            case '8': {
+                // Opcao 8: Memoria por subsistema (mesmo relatorio do comando "mem")
+                Escritor *w = mem_alocar(MEM_ESCRITORES, sizeof(Escritor));
+                if (!w) break;
+                Consulta c = { CONSULTA_MEMORIA, "" };
+                escritor_de_arquivo(w, stdout);
+                consulta_executar(&c, &bdt, &bdp, w);
+                escritor_fechar(w);
+                mem_liberar(w);
                 break;
+            }
                 
             default:
                 // Opcao nao reconhecida
@@ -278,5 +505,8 @@ int main(int argc, char *argv[]) {
 
     // Mensagem de encerramento
     printf("Encerrando.\n");
+    bdtimes_liberar(&bdt);
+    bdpartidas_liberar(&bdp);
+    if (stats) mostrar_estatisticas(stderr);
     return 0;  // Execucao bem sucedida
 }
@@ -0,0 +1,222 @@
+/**
+ * Modulo: memoria.c
+ *
+ * Implementa os alocadores com etiqueta sobre malloc/realloc/free.
+ *
+ * Layout de um bloco:
+ *
+ *   [ Cabecalho (tamanho, etiqueta) | dados do usuario ... ]
+ *                                     ^ ponteiro devolvido
+ *
+ * O cabecalho ocupa um max_align_t, preservando o alinhamento que malloc
+ * garante. Blocos com alinhamento maior (mem_alocar_alinhada) reservam
+ * um prefixo de 'alinhamento' bytes e guardam no cabecalho a distancia
+ * ate o inicio real do bloco, para que mem_liberar o encontre, e o
+ * alinhamento, para que mem_realocar o preserve.
+ *
+ * Os contadores sao atomicos globais: alocacao nao e caminho quente (os
+ * containers crescem dobrando), entao um fetch_add relaxado por operacao
+ * e suficiente.
+ */
+
+#include "memoria.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Cabecalho de cada bloco.
+ */
+typedef union {
+    struct {
+        size_t tam;        // Bytes pedidos pelo usuario
+        size_t desloc;     // Distancia do inicio real do bloco ate os dados
+        size_t alin;       // Alinhamento pedido (0 = o de malloc)
+        TagMemoria tag;    // Subsistema dono
+    } h;
+    max_align_t alinhamento;  // Garante o alinhamento dos dados
+} Cabecalho;
+
+/**
+ * Contadores de um subsistema.
+ */
+typedef struct {
+    atomic_size_t reservado;
+    atomic_size_t pico;
+    atomic_size_t blocos;
+    atomic_size_t alocacoes;
+} Contas;
+
+static Contas contas[MEM_TOTAL];
+
+static const char *const NOMES[MEM_TOTAL] = {
+    "times",
+    "partidas",
+    "indices",
+    "caches",
+    "versoes",
+    "fila de carga",
+    "escritores",
+    "consultas",
+    "servidor",
+    "metricas",
+    "api",
+};
+
+/**
+ * Soma 'n' bytes (e 'blocos' blocos) a um subsistema, atualizando o pico.
+ */
+static void contabilizar(TagMemoria tag, size_t n, int blocos) {
+    Contas *c = &contas[tag];
+    size_t atual = atomic_fetch_add_explicit(&c->reservado, n, memory_order_relaxed) + n;
+    if (blocos > 0) atomic_fetch_add_explicit(&c->blocos, (size_t)blocos, memory_order_relaxed);
+    atomic_fetch_add_explicit(&c->alocacoes, 1, memory_order_relaxed);
+
+    size_t pico = atomic_load_explicit(&c->pico, memory_order_relaxed);
+    while (atual > pico &&
+           !atomic_compare_exchange_weak_explicit(&c->pico, &pico, atual,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Desconta 'n' bytes (e 'blocos' blocos) de um subsistema.
+ */
+static void descontar(TagMemoria tag, size_t n, int blocos) {
+    Contas *c = &contas[tag];
+    atomic_fetch_sub_explicit(&c->reservado, n, memory_order_relaxed);
+    if (blocos > 0) atomic_fetch_sub_explicit(&c->blocos, (size_t)blocos, memory_order_relaxed);
+}
+
+/**
+ * Aloca 'n' bytes para um subsistema.
+ *
+ * @param tag Subsistema dono
+ * @param n Tamanho em bytes
+ * @return Ponteiro para a memoria, ou NULL se faltou memoria
+ */
+void* mem_alocar(TagMemoria tag, size_t n) {
+    if (n > SIZE_MAX - sizeof(Cabecalho)) return NULL;
+    Cabecalho *c = malloc(sizeof(Cabecalho) + n);
+    if (!c) return NULL;
+    c->h.tam = n;
+    c->h.desloc = sizeof(Cabecalho);
+    c->h.alin = 0;
+    c->h.tag = tag;
+    contabilizar(tag, n, 1);
+    return c + 1;
+}
+
+/**
+ * Aloca 'n' bytes alinhados a 'alinhamento' para um subsistema.
+ *
+ * @param tag Subsistema dono
+ * @param alinhamento Potencia de 2
+ * @param n Tamanho em bytes
+ * @return Ponteiro para a memoria, ou NULL se faltou memoria
+ */
+void* mem_alocar_alinhada(TagMemoria tag, size_t alinhamento, size_t n) {
+    if (alinhamento <= _Alignof(max_align_t)) return mem_alocar(tag, n);
+
+    // O prefixo e multiplo do alinhamento e cabe o cabecalho no seu final
+    size_t prefixo = (sizeof(Cabecalho) + alinhamento - 1) & ~(alinhamento - 1);
+    if (n > SIZE_MAX - prefixo - alinhamento) return NULL;
+    size_t total = (prefixo + n + alinhamento - 1) & ~(alinhamento - 1);
+
+    char *base = aligned_alloc(alinhamento, total);
+    if (!base) return NULL;
+    char *dados = base + prefixo;
+    Cabecalho *c = (Cabecalho*)dados - 1;
+    c->h.tam = n;
+    c->h.desloc = prefixo;
+    c->h.alin = alinhamento;
+    c->h.tag = tag;
+    contabilizar(tag, n, 1);
+    return dados;
+}
+
+/**
+ * Aloca 'qtd' elementos de 'tam' bytes zerados.
+ *
+ * @param tag Subsistema dono
+ * @param qtd Numero de elementos
+ * @param tam Tamanho de cada elemento
+ * @return Ponteiro para a memoria, ou NULL se faltou memoria
+ */
+void* mem_zerada(TagMemoria tag, size_t qtd, size_t tam) {
+    if (tam != 0 && qtd > SIZE_MAX / tam) return NULL;
+    void *p = mem_alocar(tag, qtd * tam);
+    if (p) memset(p, 0, qtd * tam);
+    return p;
+}
+
+/**
+ * Muda o tamanho de um bloco. Com p == NULL, aloca.
+ *
+ * Blocos alinhados nao podem ir para realloc (o novo bloco perderia o
+ * alinhamento): sao copiados para um novo bloco com o mesmo alinhamento.
+ *
+ * @param tag Subsistema dono
+ * @param p Bloco obtido deste modulo, ou NULL
+ * @param n Novo tamanho em bytes
+ * @return Ponteiro para o bloco, ou NULL se faltou memoria
+ */
+void* mem_realocar(TagMemoria tag, void *p, size_t n) {
+    if (!p) return mem_alocar(tag, n);
+    if (n > SIZE_MAX - sizeof(Cabecalho)) return NULL;
+
+    Cabecalho *antigo = (Cabecalho*)p - 1;
+    if (antigo->h.alin != 0) {
+        void *novo = mem_alocar_alinhada(tag, antigo->h.alin, n);
+        if (!novo) return NULL;
+        memcpy(novo, p, antigo->h.tam < n ? antigo->h.tam : n);
+        mem_liberar(p);
+        return novo;
+    }
+    size_t tam_antigo = antigo->h.tam;
+    TagMemoria tag_antiga = antigo->h.tag;
+
+    Cabecalho *c = realloc(antigo, sizeof(Cabecalho) + n);
+    if (!c) return NULL;
+
+    descontar(tag_antiga, tam_antigo, 1);
+    c->h.tam = n;
+    c->h.tag = tag;
+    contabilizar(tag, n, 1);
+    return c + 1;
+}
+
+/**
+ * Libera um bloco obtido deste modulo. Aceita NULL.
+ *
+ * @param p Bloco a liberar
+ */
+void mem_liberar(void *p) {
+    if (!p) return;
+    Cabecalho *c = (Cabecalho*)p - 1;
+    descontar(c->h.tag, c->h.tam, 1);
+    free((char*)p - c->h.desloc);
+}
+
+/**
+ * Le a contabilidade de um subsistema.
+ *
+ * @param tag Subsistema
+ * @param out Estatisticas
+ */
+void mem_estatisticas(TagMemoria tag, EstatMemoria *out) {
+    const Contas *c = &contas[tag];
+    out->reservado = atomic_load_explicit(&c->reservado, memory_order_relaxed);
+    out->pico = atomic_load_explicit(&c->pico, memory_order_relaxed);
+    out->blocos = atomic_load_explicit(&c->blocos, memory_order_relaxed);
+    out->alocacoes = atomic_load_explicit(&c->alocacoes, memory_order_relaxed);
+}
+
+/**
+ * @param tag Subsistema
+ * @return Nome do subsistema para relatorios
+ */
+const char* mem_nome(TagMemoria tag) {
+    return (unsigned)tag < MEM_TOTAL ? NOMES[tag] : "?";
+}
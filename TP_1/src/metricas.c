@@ -0,0 +1,261 @@
+/**
+ * Modulo: metricas.c
+ *
+ * Implementa os contadores por thread e a leitura consolidada.
+ *
+ * A lista global de blocos so cresce (cada thread insere o seu bloco uma
+ * vez, com compare-and-swap na cabeca), entao pode ser percorrida pelos
+ * leitores sem trava: um bloco, depois de publicado, nunca sai da lista.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "metricas.h"
+#include "memoria.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+_Thread_local BlocoMetricas *metricas_local = NULL;
+
+// Cabeca da lista de blocos de todas as threads que ja registraram metricas
+static _Atomic(BlocoMetricas*) lista_blocos = NULL;
+
+/**
+ * Cria e registra o bloco de contadores da thread atual.
+ *
+ * @return Bloco da thread, ou NULL se faltou memoria
+ */
+BlocoMetricas* metricas_registrar_thread(void) {
+    BlocoMetricas *b = mem_alocar(MEM_METRICAS, sizeof(BlocoMetricas));
+    if (!b) return NULL;
+    for (int i = 0; i < MET_TOTAL; i++) atomic_init(&b->v[i], 0);
+    for (int t = 0; t < LAT_TOTAL; t++) {
+        for (int i = 0; i < HIST_BALDES; i++) atomic_init(&b->lat[t].baldes[i], 0);
+        atomic_init(&b->lat[t].max, 0);
+    }
+
+    // Insere na cabeca da lista; a ordem release publica os contadores zerados
+    BlocoMetricas *cabeca = atomic_load_explicit(&lista_blocos, memory_order_relaxed);
+    do {
+        b->prox = cabeca;
+    } while (!atomic_compare_exchange_weak_explicit(&lista_blocos, &cabeca, b,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+    metricas_local = b;
+    return b;
+}
+
+/**
+ * @return Instante atual em nanossegundos (relogio monotonico)
+ */
+unsigned long long metricas_agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+}
+
+/**
+ * Calcula o balde do histograma de uma latencia.
+ *
+ * Abaixo de HIST_SUB, o balde e o proprio valor. Acima, 'mag' e quantos
+ * bits sobram alem dos 5 mais significativos: o valor deslocado de 'mag'
+ * fica em [HIST_SUB, 2*HIST_SUB) e escolhe o sub-balde da magnitude.
+ *
+ * @param ns Latencia em nanossegundos
+ * @return Indice do balde (0 a HIST_BALDES-1)
+ */
+static int balde_de(unsigned long long ns) {
+    if (ns < HIST_SUB) return (int)ns;
+
+    int mag = 0;
+    while ((ns >> mag) >= 2 * HIST_SUB) mag++;
+    int idx = HIST_SUB * (mag + 1) + (int)(ns >> mag) - HIST_SUB;
+    return idx < HIST_BALDES ? idx : HIST_BALDES - 1;
+}
+
+/**
+ * Maior valor que cai em um balde (o percentil reportado e conservador).
+ *
+ * @param idx Indice do balde
+ * @return Limite superior do balde, em ns
+ */
+static unsigned long long limite_do_balde(int idx) {
+    if (idx < HIST_SUB) return (unsigned long long)idx;
+    int mag = idx / HIST_SUB - 1;
+    unsigned long long base = (unsigned long long)(HIST_SUB + idx % HIST_SUB) << mag;
+    return base + (1ULL << mag) - 1;
+}
+
+/**
+ * Registra a latencia de uma consulta no histograma da thread atual.
+ *
+ * @param tipo Tipo da consulta
+ * @param ns Latencia em nanossegundos
+ */
+void metricas_latencia(TipoLatencia tipo, unsigned long long ns) {
+    BlocoMetricas *b = metricas_local;
+    if (!b && !(b = metricas_registrar_thread())) return;
+
+    HistLatencia *h = &b->lat[tipo];
+    atomic_ullong *balde = &h->baldes[balde_de(ns)];
+    atomic_store_explicit(balde, atomic_load_explicit(balde, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    if (ns > atomic_load_explicit(&h->max, memory_order_relaxed)) {
+        atomic_store_explicit(&h->max, ns, memory_order_relaxed);
+    }
+}
+
+/**
+ * Calcula o resumo de latencias de um tipo de consulta.
+ *
+ * Soma os histogramas de todas as threads e percorre os baldes uma vez,
+ * achando cada percentil pelo posto mais proximo (ceil(q * n)).
+ *
+ * @param tipo Tipo da consulta
+ * @param out Resumo (zerado se nao houver registros)
+ */
+void metricas_resumo_latencia(TipoLatencia tipo, ResumoLatencia *out) {
+    // Fica no heap para nao ocupar 8 KiB da pilha das trabalhadoras
+    unsigned long long *soma = mem_zerada(MEM_METRICAS, HIST_BALDES, sizeof(unsigned long long));
+    out->n = out->p50 = out->p90 = out->p99 = out->p999 = out->max = 0;
+    if (!soma) return;
+
+    const BlocoMetricas *b = atomic_load_explicit(&lista_blocos, memory_order_acquire);
+    for (; b; b = b->prox) {
+        const HistLatencia *h = &b->lat[tipo];
+        for (int i = 0; i < HIST_BALDES; i++) {
+            unsigned long long c = atomic_load_explicit(&h->baldes[i], memory_order_relaxed);
+            soma[i] += c;
+            out->n += c;
+        }
+        unsigned long long m = atomic_load_explicit(&h->max, memory_order_relaxed);
+        if (m > out->max) out->max = m;
+    }
+
+    if (out->n > 0) {
+        // Postos (1-based) de cada percentil; o p999 usa milesimos
+        const unsigned long long postos[4] = {
+            (out->n * 50 + 99) / 100,
+            (out->n * 90 + 99) / 100,
+            (out->n * 99 + 99) / 100,
+            (out->n * 999 + 999) / 1000,
+        };
+        unsigned long long *dest[4] = { &out->p50, &out->p90, &out->p99, &out->p999 };
+        unsigned long long acumulado = 0;
+        int k = 0;
+        for (int i = 0; i < HIST_BALDES && k < 4; i++) {
+            acumulado += soma[i];
+            while (k < 4 && acumulado >= postos[k]) {
+                // O limite do balde nunca passa do maximo observado
+                unsigned long long v = limite_do_balde(i);
+                *dest[k++] = v < out->max ? v : out->max;
+            }
+        }
+    }
+    mem_liberar(soma);
+}
+
+/**
+ * Le o total de cada metrica, somando os blocos de todas as threads.
+ *
+ * @param total Array de MET_TOTAL posicoes que recebe as somas
+ */
+void metricas_ler(unsigned long long total[MET_TOTAL]) {
+    for (int i = 0; i < MET_TOTAL; i++) total[i] = 0;
+
+    const BlocoMetricas *b = atomic_load_explicit(&lista_blocos, memory_order_acquire);
+    for (; b; b = b->prox) {
+        for (int i = 0; i < MET_TOTAL; i++) {
+            total[i] += atomic_load_explicit(&b->v[i], memory_order_relaxed);
+        }
+    }
+}
+
+// Rotulos das latencias, na ordem do enum TipoLatencia
+static const char *const ROTULOS_LATENCIA[LAT_TOTAL] = {
+    "busca de times",
+    "busca aproximada",
+    "busca por trecho",
+    "busca em lote",
+    "partidas (mandante)",
+    "partidas (visitante)",
+    "partidas (qualquer)",
+    "contagem de partidas",
+    "classificacao",
+};
+
+// Rotulos do relatorio, na ordem do enum Metrica
+static const char *const ROTULOS[MET_TOTAL] = {
+    "linhas lidas",
+    "linhas rejeitadas",
+    "bytes lidos",
+    "partidas agregadas",
+    "buscas de times",
+    "buscas de partidas",
+    "contagens pelos contadores",
+    "contagens pelas listas",
+    "bytes escritos",
+    "carga de times",
+    "carga de partidas",
+    "agregacao",
+    "buscas",
+    "saida",
+};
+
+// Categoria de cada metrica de tempo no rastro, a partir de MET_NS_CARGA_TIMES
+static const char *const ETAPAS[MET_TOTAL - MET_NS_CARGA_TIMES] = {
+    "carga",
+    "parse",
+    "agregacao",
+    "busca",
+    "saida",
+};
+
+/**
+ * Grava no rastro o intervalo de uma etapa.
+ *
+ * @param m Metrica MET_NS_*
+ * @param inicio Instante inicial (ns)
+ * @param dt Duracao (ns)
+ */
+void metricas_rastrear(Metrica m, unsigned long long inicio, unsigned long long dt) {
+    if (m < MET_NS_CARGA_TIMES || m >= MET_TOTAL) return;
+    rastro_evento(ROTULOS[m], ETAPAS[m - MET_NS_CARGA_TIMES], inicio, dt, NULL);
+}
+
+/**
+ * Escreve o relatorio das metricas em um escritor.
+ *
+ * Contadores aparecem como inteiros; tempos, em milissegundos.
+ *
+ * @param w Escritor de destino
+ */
+void metricas_escrever(Escritor *w) {
+    unsigned long long total[MET_TOTAL];
+    metricas_ler(total);
+
+    escritor_str(w, "Estatisticas:\n");
+    for (int i = 0; i < MET_TOTAL; i++) {
+        char linha[96];
+        if (i >= MET_NS_CARGA_TIMES) {
+            snprintf(linha, sizeof(linha), "  %-28s %12.3f ms\n", ROTULOS[i], (double)total[i] / 1e6);
+        } else {
+            snprintf(linha, sizeof(linha), "  %-28s %12llu\n", ROTULOS[i], total[i]);
+        }
+        escritor_str(w, linha);
+    }
+
+    char linha[128];
+    snprintf(linha, sizeof(linha), "Latencias (us):%17s %10s %10s %10s %10s %10s\n",
+             "n", "p50", "p90", "p99", "p999", "max");
+    escritor_str(w, linha);
+    for (int t = 0; t < LAT_TOTAL; t++) {
+        ResumoLatencia r;
+        metricas_resumo_latencia((TipoLatencia)t, &r);
+        snprintf(linha, sizeof(linha), "  %-22s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                 ROTULOS_LATENCIA[t], r.n, (double)r.p50 / 1e3, (double)r.p90 / 1e3,
+                 (double)r.p99 / 1e3, (double)r.p999 / 1e3, (double)r.max / 1e3);
+        escritor_str(w, linha);
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * Modulo: rastro.c
+ *
+ * Implementa o rastro de execucao no formato JSON do Chrome:
+ *
+ *   {"traceEvents":[
+ *   {"name":"...","cat":"...","ph":"X","ts":<us>,"dur":<us>,"pid":1,"tid":<n>},
+ *   ...
+ *   ],"displayTimeUnit":"ms"}
+ *
+ * Os eventos "X" (completos) trazem inicio e duracao em microssegundos,
+ * contados a partir de rastro_abrir(). Nomes de thread usam eventos "M".
+ */
+
+#include "rastro.h"
+#include "metricas.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int rastro_ativo = 0;
+
+static FILE *arquivo = NULL;
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long long instante_zero = 0;
+static int primeiro_evento = 1;
+
+// Identificador da thread no rastro (0 = ainda sem numero)
+static _Thread_local int tid_local = 0;
+static atomic_int proximo_tid = 1;
+
+/**
+ * @return Identificador da thread atual no rastro
+ */
+static int tid_atual(void) {
+    if (tid_local == 0) tid_local = atomic_fetch_add(&proximo_tid, 1);
+    return tid_local;
+}
+
+/**
+ * Escreve uma string JSON (com aspas), escapando aspas, barras e
+ * caracteres de controle. Bytes UTF-8 passam sem alteracao.
+ *
+ * @param s Texto a escrever
+ */
+static void escrever_string(const char *s) {
+    fputc('"', arquivo);
+    for (const unsigned char *p = (const unsigned char*)s; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', arquivo);
+            fputc(*p, arquivo);
+        } else if (*p < 0x20) {
+            fprintf(arquivo, "\\u%04x", *p);
+        } else {
+            fputc(*p, arquivo);
+        }
+    }
+    fputc('"', arquivo);
+}
+
+/**
+ * Separador entre eventos (chamada com a trava).
+ */
+static void separar(void) {
+    fputs(primeiro_evento ? "\n" : ",\n", arquivo);
+    primeiro_evento = 0;
+}
+
+/**
+ * Fecha o rastro ao encerrar o programa.
+ */
+static void fechar_ao_sair(void) {
+    rastro_fechar();
+}
+
+/**
+ * Abre o arquivo de rastro e marca o instante zero da linha do tempo.
+ *
+ * @param caminho Arquivo de destino (.json)
+ * @return 1 se sucesso, 0 se nao foi possivel criar o arquivo
+ */
+int rastro_abrir(const char *caminho) {
+    arquivo = fopen(caminho, "wb");
+    if (!arquivo) return 0;
+
+    fputs("{\"traceEvents\":[", arquivo);
+    instante_zero = metricas_agora_ns();
+    rastro_ativo = 1;
+    atexit(fechar_ao_sair);
+    rastro_nomear_thread("principal");
+    return 1;
+}
+
+/**
+ * Da nome a thread atual na linha do tempo.
+ *
+ * @param nome Nome exibido pelo visualizador
+ */
+void rastro_nomear_thread(const char *nome) {
+    if (!rastro_ativo) return;
+    int tid = tid_atual();
+
+    pthread_mutex_lock(&trava);
+    if (arquivo) {
+        separar();
+        fprintf(arquivo, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", tid);
+        escrever_string(nome);
+        fputs("}}", arquivo);
+    }
+    pthread_mutex_unlock(&trava);
+}
+
+/**
+ * Grava um evento com inicio e duracao na thread atual.
+ *
+ * @param nome Nome do evento
+ * @param categoria Categoria (etapa) do evento
+ * @param inicio_ns Inicio, obtido com metricas_agora_ns()
+ * @param dur_ns Duracao em nanossegundos
+ * @param arg Argumento exibido junto com o evento, ou NULL
+ */
+void rastro_evento(const char *nome, const char *categoria,
+                   unsigned long long inicio_ns, unsigned long long dur_ns,
+                   const char *arg) {
+    if (!rastro_ativo) return;
+    int tid = tid_atual();
+    // Eventos iniciados antes da abertura ficam no instante zero
+    unsigned long long rel = inicio_ns > instante_zero ? inicio_ns - instante_zero : 0;
+
+    pthread_mutex_lock(&trava);
+    if (arquivo) {
+        separar();
+        fputs("{\"name\":", arquivo);
+        escrever_string(nome);
+        fputs(",\"cat\":", arquivo);
+        escrever_string(categoria);
+        fprintf(arquivo, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d",
+                (double)rel / 1e3, (double)dur_ns / 1e3, tid);
+        if (arg) {
+            fputs(",\"args\":{\"arg\":", arquivo);
+            escrever_string(arg);
+            fputc('}', arquivo);
+        }
+        fputc('}', arquivo);
+    }
+    pthread_mutex_unlock(&trava);
+}
+
+/**
+ * Fecha o arquivo de rastro, completando o JSON.
+ *
+ * @return 1 se o arquivo foi gravado sem erros, 0 caso contrario
+ */
+int rastro_fechar(void) {
+    pthread_mutex_lock(&trava);
+    int ok = 1;
+    if (arquivo) {
+        fputs("\n],\"displayTimeUnit\":\"ms\"}\n", arquivo);
+        ok = !ferror(arquivo);
+        if (fclose(arquivo) != 0) ok = 0;
+        arquivo = NULL;
+    }
+    pthread_mutex_unlock(&trava);
+    return ok;
+}
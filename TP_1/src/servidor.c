@@ -0,0 +1,481 @@
+/**
+ * Modulo: servidor.c
+ *
+ * Implementa o modo servidor: consultas respondidas por um socket de
+ * dominio UNIX, com os dados carregados uma unica vez.
+ *
+ * Arquitetura:
+ * - A thread principal executa um laco epoll que aceita conexoes e
+ *   detecta quando ha dados para ler
+ * - Cada conexao e registrada com EPOLLONESHOT: ao ficar pronta, ela e
+ *   entregue a UMA thread trabalhadora e so volta ao epoll quando essa
+ *   thread termina de atende-la. Assim uma conexao nunca e processada
+ *   por duas threads ao mesmo tempo, sem precisar de travas por conexao
+ * - As trabalhadoras leem todas as requisicoes completas disponiveis,
+ *   executam cada comando (consulta_executar) em um escritor em memoria
+ *   e enviam as respostas com prefixo de tamanho
+ * - Consultas leem um instantaneo da base versionada sem travas; o
+ *   comando "add" publica uma nova versao (bd_versoes.h)
+ *
+ * O protocolo esta descrito em servidor.h.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "servidor.h"
+#include <stdio.h>
+
+#ifdef __linux__
+
+#include "consulta.h"
+#include "escritor.h"
+#include "memoria.h"
+#include "rastro.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Capacidade do buffer de entrada de cada conexao
+#define CONEXAO_BUFFER 65536
+
+// Tempo maximo (ms) esperando o cliente aceitar mais bytes de uma resposta
+#define TIMEOUT_ENVIO_MS 5000
+
+/**
+ * Estado de uma conexao de cliente.
+ */
+typedef struct Conexao {
+    int fd;                   // Socket do cliente
+    char *entrada;            // Bytes recebidos ainda nao processados
+    size_t len;               // Numero de bytes validos em 'entrada'
+    struct Conexao *prox;     // Proxima conexao na fila de trabalho
+} Conexao;
+
+/**
+ * Estado compartilhado entre o laco de eventos e as trabalhadoras.
+ */
+typedef struct {
+    int epfd;                 // Descritor do epoll
+    BDVersionada *bv;         // Base versionada (times + partidas)
+    pthread_mutex_t mtx;      // Protege a fila de trabalho e 'parar'
+    pthread_cond_t cond;      // Sinaliza trabalho novo ou encerramento
+    Conexao *ini;             // Inicio da fila de conexoes prontas
+    Conexao *fim;             // Fim da fila de conexoes prontas
+    int parar;                // 1 quando as trabalhadoras devem terminar
+} Servidor;
+
+// Ativado pelos tratadores de SIGINT/SIGTERM
+static volatile sig_atomic_t sinal_parar = 0;
+
+/**
+ * Tratador de sinal: apenas registra o pedido de encerramento.
+ */
+static void tratar_sinal(int sig) {
+    (void)sig;
+    sinal_parar = 1;
+}
+
+/**
+ * Coloca um descritor em modo nao bloqueante.
+ */
+static int nao_bloqueante(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+/**
+ * Envia todos os bytes, esperando o socket ficar gravavel se preciso.
+ *
+ * @return 1 se tudo foi enviado, 0 em caso de erro ou timeout
+ */
+static int enviar_tudo(int fd, const char *dados, size_t n) {
+    while (n > 0) {
+        ssize_t k = write(fd, dados, n);
+        if (k > 0) {
+            dados += k;
+            n -= (size_t)k;
+        } else if (k < 0 && errno == EINTR) {
+            continue;
+        } else if (k < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd p = { .fd = fd, .events = POLLOUT, .revents = 0 };
+            if (poll(&p, 1, TIMEOUT_ENVIO_MS) <= 0) return 0;
+        } else {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Executa o comando "add": acrescenta uma partida e publica nova versao.
+ */
+static void adicionar_partida(Servidor *sv, const char *linha, Escritor *w) {
+    Partida p;
+    if (!bdpartidas_parse_linha(linha, strlen(linha), &p)) {
+        escritor_str(w, "Partida invalida: ");
+        escritor_str(w, linha);
+        escritor_char(w, '\n');
+        return;
+    }
+
+    unsigned long long versao = bdversoes_adicionar_partidas(sv->bv, &p, 1);
+    if (versao == 0) {
+        escritor_str(w, "Falha ao adicionar partida.\n");
+        return;
+    }
+
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Partida adicionada (versao %llu)\n", versao);
+    escritor_str(w, msg);
+}
+
+/**
+ * Executa uma requisicao e envia a resposta com prefixo de tamanho.
+ *
+ * @param sv Estado do servidor
+ * @param leitor Identificador de leitor da trabalhadora na base versionada
+ * @param fd Socket do cliente
+ * @param cmd Comando recebido (modificado pelo parser)
+ * @param w Escritor em memoria da trabalhadora
+ * @return 1 se a resposta foi enviada, 0 em caso de erro
+ */
+static int responder(Servidor *sv, int leitor, int fd, char *cmd, Escritor *w) {
+    escritor_limpar(w);
+
+    Consulta c;
+    int r = consulta_parse(cmd, &c);
+    if (r == 1 && c.tipo == CONSULTA_ADICIONAR) {
+        adicionar_partida(sv, c.arg, w);
+    } else if (r == 1) {
+        // Consulta sobre o instantaneo atual, sem travas
+        const Versao *v = bdversoes_ler_inicio(sv->bv, leitor);
+        consulta_executar(&c, &v->times, &v->partidas, w);
+        bdversoes_ler_fim(sv->bv, leitor);
+    } else if (r == 0) {
+        escritor_str(w, "Comando invalido: ");
+        escritor_str(w, cmd);
+        escritor_char(w, '\n');
+    }
+
+    size_t len;
+    const char *corpo = escritor_conteudo(w, &len);
+    unsigned char cab[4] = {
+        (unsigned char)(len >> 24), (unsigned char)(len >> 16),
+        (unsigned char)(len >> 8), (unsigned char)len
+    };
+    return enviar_tudo(fd, (const char*)cab, sizeof(cab)) && enviar_tudo(fd, corpo, len);
+}
+
+/**
+ * Le os dados disponiveis de uma conexao e responde as requisicoes completas.
+ *
+ * @param sv Estado do servidor
+ * @param leitor Identificador de leitor da trabalhadora
+ * @param c Conexao a atender
+ * @param w Escritor em memoria da trabalhadora
+ * @return 1 se a conexao continua aberta, 0 se deve ser fechada
+ */
+static int atender(Servidor *sv, int leitor, Conexao *c, Escritor *w) {
+    char cmd[SERVIDOR_MAX_REQUISICAO + 1];
+
+    for (;;) {
+        ssize_t k = read(c->fd, c->entrada + c->len, CONEXAO_BUFFER - c->len);
+        if (k == 0) return 0;  // Cliente fechou a conexao
+        if (k < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 1;
+            return 0;
+        }
+        c->len += (size_t)k;
+
+        // Processa todas as requisicoes completas do buffer
+        size_t pos = 0;
+        while (c->len - pos >= 4) {
+            const unsigned char *p = (const unsigned char*)c->entrada + pos;
+            uint32_t tam = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+            if (tam > SERVIDOR_MAX_REQUISICAO) return 0;  // Requisicao invalida
+            if (c->len - pos - 4 < tam) break;            // Ainda incompleta
+
+            memcpy(cmd, p + 4, tam);
+            cmd[tam] = '\0';
+            if (!responder(sv, leitor, c->fd, cmd, w)) return 0;
+            pos += 4 + tam;
+        }
+
+        // Move o restante (requisicao parcial) para o inicio do buffer
+        memmove(c->entrada, c->entrada + pos, c->len - pos);
+        c->len -= pos;
+    }
+}
+
+/**
+ * Fecha uma conexao e libera seus recursos.
+ */
+static void fechar_conexao(Conexao *c) {
+    close(c->fd);
+    mem_liberar(c->entrada);
+    mem_liberar(c);
+}
+
+/**
+ * Laco de uma thread trabalhadora.
+ *
+ * Retira conexoes prontas da fila, atende-as e as devolve ao epoll
+ * (rearmando EPOLLONESHOT) ou as fecha.
+ */
+static void* trabalhadora(void *arg) {
+    Servidor *sv = (Servidor*)arg;
+    rastro_nomear_thread("trabalhadora");
+
+    int leitor = bdversoes_registrar_leitor(sv->bv);
+    Escritor *w = mem_alocar(MEM_ESCRITORES, sizeof(Escritor));
+    if (!w || leitor < 0) {
+        mem_liberar(w);
+        return NULL;
+    }
+    escritor_memoria(w);
+
+    for (;;) {
+        pthread_mutex_lock(&sv->mtx);
+        while (!sv->ini && !sv->parar) {
+            pthread_cond_wait(&sv->cond, &sv->mtx);
+        }
+        if (!sv->ini) {
+            pthread_mutex_unlock(&sv->mtx);
+            break;
+        }
+        Conexao *c = sv->ini;
+        sv->ini = c->prox;
+        if (!sv->ini) sv->fim = NULL;
+        pthread_mutex_unlock(&sv->mtx);
+
+        if (atender(sv, leitor, c, w)) {
+            struct epoll_event ev;
+            ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+            ev.data.ptr = c;
+            if (epoll_ctl(sv->epfd, EPOLL_CTL_MOD, c->fd, &ev) < 0) {
+                fechar_conexao(c);
+            }
+        } else {
+            fechar_conexao(c);
+        }
+    }
+
+    escritor_liberar(w);
+    mem_liberar(w);
+    return NULL;
+}
+
+/**
+ * Entrega uma conexao pronta para as trabalhadoras.
+ */
+static void enfileirar(Servidor *sv, Conexao *c) {
+    pthread_mutex_lock(&sv->mtx);
+    c->prox = NULL;
+    if (sv->fim) {
+        sv->fim->prox = c;
+    } else {
+        sv->ini = c;
+    }
+    sv->fim = c;
+    pthread_cond_signal(&sv->cond);
+    pthread_mutex_unlock(&sv->mtx);
+}
+
+/**
+ * Aceita todas as conexoes pendentes e as registra no epoll.
+ */
+static void aceitar_conexoes(Servidor *sv, int lfd) {
+    for (;;) {
+        int fd = accept(lfd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;  // EAGAIN: nao ha mais conexoes pendentes
+        }
+
+        Conexao *c = mem_alocar(MEM_SERVIDOR, sizeof(Conexao));
+        char *entrada = mem_alocar(MEM_SERVIDOR, CONEXAO_BUFFER);
+        if (!c || !entrada || nao_bloqueante(fd) < 0) {
+            mem_liberar(c);
+            mem_liberar(entrada);
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->entrada = entrada;
+        c->len = 0;
+        c->prox = NULL;
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        ev.data.ptr = c;
+        if (epoll_ctl(sv->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            fechar_conexao(c);
+        }
+    }
+}
+
+/**
+ * Cria o socket UNIX de escuta no caminho indicado.
+ *
+ * @return Descritor do socket, ou -1 em caso de erro
+ */
+static int criar_socket_escuta(const char *caminho) {
+    struct sockaddr_un addr;
+    if (strlen(caminho) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Caminho do socket muito longo: %s\n", caminho);
+        return -1;
+    }
+
+    int lfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, caminho);
+    unlink(caminho);  // Remove um socket antigo deixado por outra execucao
+
+    if (bind(lfd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(lfd, SOMAXCONN) < 0 || nao_bloqueante(lfd) < 0) {
+        perror("bind/listen");
+        close(lfd);
+        return -1;
+    }
+    return lfd;
+}
+
+/**
+ * Executa o servidor ate receber SIGINT ou SIGTERM.
+ *
+ * @param caminho_socket Caminho do socket UNIX
+ * @param n_workers Numero de threads trabalhadoras
+ * @param bv Base versionada
+ * @return 0 se encerrou normalmente, 1 em caso de erro
+ */
+int servidor_executar(const char *caminho_socket, int n_workers, BDVersionada *bv) {
+    if (n_workers < 1) n_workers = 1;
+    if (n_workers > MAX_LEITORES) n_workers = MAX_LEITORES;
+
+    Servidor sv;
+    memset(&sv, 0, sizeof(sv));
+    sv.bv = bv;
+    pthread_mutex_init(&sv.mtx, NULL);
+    pthread_cond_init(&sv.cond, NULL);
+
+    int lfd = criar_socket_escuta(caminho_socket);
+    if (lfd < 0) return 1;
+
+    sv.epfd = epoll_create1(0);
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;  // NULL identifica o socket de escuta
+    if (sv.epfd < 0 || epoll_ctl(sv.epfd, EPOLL_CTL_ADD, lfd, &ev) < 0) {
+        perror("epoll");
+        close(lfd);
+        return 1;
+    }
+
+    // Instala os tratadores sem SA_RESTART para interromper o epoll_wait
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = tratar_sinal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);  // Cliente que fecha cedo nao derruba o servidor
+
+    // Cria as trabalhadoras com os sinais bloqueados: apenas a thread
+    // principal (laco de eventos) deve receber SIGINT/SIGTERM
+    sigset_t bloq, antigo;
+    sigemptyset(&bloq);
+    sigaddset(&bloq, SIGINT);
+    sigaddset(&bloq, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &bloq, &antigo);
+
+    pthread_t *threads = mem_alocar(MEM_SERVIDOR, (size_t)n_workers * sizeof(pthread_t));
+    int criadas = 0;
+    while (threads && criadas < n_workers &&
+           pthread_create(&threads[criadas], NULL, trabalhadora, &sv) == 0) {
+        criadas++;
+    }
+    pthread_sigmask(SIG_SETMASK, &antigo, NULL);
+
+    if (criadas == 0) {
+        fprintf(stderr, "Falha ao criar threads trabalhadoras.\n");
+        mem_liberar(threads);
+        close(sv.epfd);
+        close(lfd);
+        unlink(caminho_socket);
+        return 1;
+    }
+
+    fprintf(stderr, "Servidor ouvindo em %s (%d trabalhadoras)\n", caminho_socket, criadas);
+
+    // Laco de eventos
+    struct epoll_event evs[64];
+    while (!sinal_parar) {
+        int n = epoll_wait(sv.epfd, evs, 64, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            if (evs[i].data.ptr == NULL) {
+                aceitar_conexoes(&sv, lfd);
+            } else {
+                enfileirar(&sv, (Conexao*)evs[i].data.ptr);
+            }
+        }
+    }
+
+    // Encerra as trabalhadoras (atendem o que ja esta na fila antes de sair)
+    pthread_mutex_lock(&sv.mtx);
+    sv.parar = 1;
+    pthread_cond_broadcast(&sv.cond);
+    pthread_mutex_unlock(&sv.mtx);
+    for (int i = 0; i < criadas; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Conexoes ociosas registradas no epoll sao fechadas pelo sistema
+    // ao termino do processo
+    mem_liberar(threads);
+    close(sv.epfd);
+    close(lfd);
+    unlink(caminho_socket);
+    pthread_mutex_destroy(&sv.mtx);
+    pthread_cond_destroy(&sv.cond);
+
+    fprintf(stderr, "Servidor encerrado.\n");
+    return 0;
+}
+
+#else
+
+/**
+ * Versao para sistemas sem epoll/sockets UNIX: o modo servidor nao
+ * esta disponivel.
+ */
+int servidor_executar(const char *caminho_socket, int n_workers, BDVersionada *bv) {
+    (void)caminho_socket;
+    (void)n_workers;
+    (void)bv;
+    fprintf(stderr, "Modo servidor disponivel apenas no Linux.\n");
+    return 1;
+}
+
+#endif
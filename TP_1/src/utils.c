@@ -16,10 +16,18 @@
  */
 
 #include "utils.h"
+#include "larguras_tabela.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
 
+// Contagem vetorizada de code points (SSE2/AVX2), escolhida em tempo de execucao
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define UTF8_X86 1
+#include <immintrin.h>
+#endif
+
 /**
  * Remove espacos em branco do inicio e fim de uma string.
  * 
@@ -219,23 +227,41 @@ void pause_prompt(void) {
  * @return 1 se a conversao foi bem sucedida, 0 se houver erro
  */
 int safe_atoi(const char *s, int *out) {
-    // Valida que a string nao e NULL nem vazia
-    if (!s || !*s) return 0;
+    // Valida que a string nao e NULL
+    if (!s) return 0;
+    return safe_atoi_n(s, strlen(s), out);
+}
+
+/**
+ * Converte um trecho de 'n' bytes para inteiro de forma segura.
+ * 
+ * Implementacao de safe_atoi() que nao depende de '\0' no final,
+ * permitindo converter campos direto da linha lida (sem copias).
+ * 
+ * @param s Inicio do trecho
+ * @param n Numero de bytes do trecho
+ * @param out Ponteiro onde o valor convertido sera armazenado (apenas se sucesso)
+ * @return 1 se a conversao foi bem sucedida, 0 se houver erro
+ */
+int safe_atoi_n(const char *s, size_t n, int *out) {
+    // Valida que o trecho nao e vazio
+    if (!s || n == 0) return 0;
     
     // Verifica se ha sinal negativo no inicio
     int sign = 1;
     const char *p = s;
+    const char *fim = s + n;
     if (*p == '-') {
         sign = -1;
         p++;  // Pula o sinal
     }
     
     // Deve haver pelo menos um digito apos o sinal (se houver)
-    if (!isdigit((unsigned char)*p)) return 0;
+    if (p == fim || !isdigit((unsigned char)*p)) return 0;
     
     // Converte digito por digito
     int val = 0;
-    while (*p) {
+    while (p < fim) {
         // Verifica se o caractere atual e um digito
         if (!isdigit((unsigned char)*p)) return 0;
         
@@ -257,42 +283,229 @@ int safe_atoi(const char *s, int *out) {
     return 1;  // Sucesso
 }
 
-// ========== Funcoes auxiliares de UTF-8 para alinhamento ==========
+// ========== Tokenizacao reentrante de CSV ==========
 
 /**
- * Retorna a quantidade de bytes de um code point UTF-8.
+ * Inicializa um cursor sobre os 'len' primeiros bytes de uma linha.
  * 
- * Determina quantos bytes compõem o proximo caractere UTF-8 baseado
- * no primeiro byte (prefixo):
- * - 0xxxxxxx: 1 byte (ASCII: 0x00-0x7F)
- * - 110xxxxx: 2 bytes (0xC0-0xDF)
- * - 1110xxxx: 3 bytes (0xE0-0xEF)
- * - 11110xxx: 4 bytes (0xF0-0xF7)
+ * Remove as quebras de linha do final ajustando apenas o ponteiro 'fim',
+ * sem modificar a linha.
  * 
- * Se o byte for invalido, trata como caractere de 1 byte.
+ * @param c Cursor a inicializar
+ * @param linha Inicio da linha
+ * @param len Numero de bytes da linha
+ */
+void cursor_iniciar(CursorCSV *c, const char *linha, size_t len) {
+    while (len > 0 && (linha[len - 1] == '\n' || linha[len - 1] == '\r')) {
+        len--;
+    }
+    c->p = linha;
+    c->fim = linha + len;
+    c->acabou = 0;
+}
+
+/**
+ * Avanca para o proximo campo separado por virgula.
  * 
- * @param p Ponteiro para o primeiro byte do code point
- * @return Numero de bytes do code point (1, 2, 3 ou 4)
+ * Algoritmo:
+ * 1. Procura a proxima virgula (ou o fim da linha) a partir de c->p
+ * 2. Recorta espacos do inicio e do fim do campo
+ * 3. Posiciona c->p logo apos a virgula
+ * 
+ * @param c Cursor
+ * @param campo Onde o inicio do campo sera armazenado
+ * @param len Onde o tamanho do campo sera armazenado
+ * @return 1 se um campo foi lido, 0 se a linha terminou
  */
-static int utf8_cp_bytes(const unsigned char *p) {
-    // Caractere ASCII de 1 byte (bit mais significativo = 0)
-    if (*p < 0x80) return 1;
+int cursor_proximo(CursorCSV *c, const char **campo, size_t *len) {
+    if (c->acabou) return 0;
     
-    // Code point de 2 bytes (comeca com 110)
-    if ((*p & 0xE0) == 0xC0) return 2;
+    const char *ini = c->p;
+    const char *sep = memchr(ini, ',', (size_t)(c->fim - ini));
+    const char *fim = sep ? sep : c->fim;
     
-    // Code point de 3 bytes (comeca com 1110)
-    if ((*p & 0xF0) == 0xE0) return 3;
+    // Proximo campo comeca apos a virgula; sem virgula, a linha terminou
+    if (sep) {
+        c->p = sep + 1;
+    } else {
+        c->acabou = 1;
+    }
     
-    // Code point de 4 bytes (comeca com 11110)
-    if ((*p & 0xF8) == 0xF0) return 4;
+    // Recorta espacos nas pontas
+    while (ini < fim && isspace((unsigned char)*ini)) ini++;
+    while (fim > ini && isspace((unsigned char)fim[-1])) fim--;
     
-    // Byte invalido: trata como caractere isolado de 1 byte
+    *campo = ini;
+    *len = (size_t)(fim - ini);
+    return 1;
+}
+
+// ========== Funcoes auxiliares de UTF-8 para alinhamento ==========
+
+/**
+ * Indica se um byte e de continuacao UTF-8 (10xxxxxx).
+ *
+ * Todo code point tem exatamente um byte que nao e de continuacao (o
+ * primeiro), entao contar code points e contar esses bytes. Em texto
+ * invalido, cada byte inicial conta como um caractere e bytes de
+ * continuacao soltos nao contam.
+ *
+ * @param b Byte a testar
+ * @return 1 se for byte de continuacao, 0 caso contrario
+ */
+static int utf8_continuacao(unsigned char b) {
+    return (b & 0xC0) == 0x80;
+}
+
+/**
+ * Conta code points byte a byte (versao portavel e referencia das
+ * versoes vetorizadas).
+ *
+ * @param s Texto UTF-8
+ * @param n Numero de bytes
+ * @return Numero de code points
+ */
+static size_t utf8_contar_escalar(const unsigned char *s, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += !utf8_continuacao(s[i]);
+    }
+    return count;
+}
+
+#ifdef UTF8_X86
+/**
+ * Conta code points 16 bytes por vez com SSE2.
+ *
+ * Como inteiro com sinal, os bytes de continuacao (0x80-0xBF) sao
+ * exatamente os valores de -128 a -65: uma comparacao "maior que -65"
+ * marca os bytes que contam, e movemask + popcount soma o bloco.
+ *
+ * @param s Texto UTF-8
+ * @param n Numero de bytes
+ * @return Numero de code points
+ */
+__attribute__((target("sse2")))
+static size_t utf8_contar_sse2(const unsigned char *s, size_t n) {
+    const __m128i limite = _mm_set1_epi8(-65);
+    size_t count = 0, i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpgt_epi8(v, limite));
+        count += (size_t)__builtin_popcount(mask);
+    }
+    return count + utf8_contar_escalar(s + i, n - i);
+}
+
+/**
+ * Conta code points 32 bytes por vez com AVX2 (mesma ideia da SSE2).
+ *
+ * @param s Texto UTF-8
+ * @param n Numero de bytes
+ * @return Numero de code points
+ */
+__attribute__((target("avx2,popcnt")))
+static size_t utf8_contar_avx2(const unsigned char *s, size_t n) {
+    const __m256i limite = _mm256_set1_epi8(-65);
+    size_t count = 0, i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, limite));
+        count += (size_t)__builtin_popcount(mask);
+    }
+    // Resto: um bloco SSE2 (se couber) e depois byte a byte
+    return count + utf8_contar_sse2(s + i, n - i);
+}
+#endif
+
+// Implementacao em uso (ImplUtf8 + 1; 0 = ainda nao escolhida)
+static _Atomic int impl_utf8 = 0;
+
+/**
+ * @param impl Implementacao
+ * @return 1 se o processador suporta a implementacao
+ */
+static int impl_suportada(ImplUtf8 impl) {
+    switch (impl) {
+        case UTF8_ESCALAR:
+            return 1;
+#ifdef UTF8_X86
+        case UTF8_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case UTF8_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#endif
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Implementacao em uso, escolhendo a mais rapida suportada na primeira
+ * chamada.
+ *
+ * @return Implementacao de utf8_contar()
+ */
+ImplUtf8 utf8_impl_atual(void) {
+    int atual = impl_utf8;
+    if (atual == 0) {
+        ImplUtf8 melhor = UTF8_ESCALAR;
+        if (impl_suportada(UTF8_SSE2)) melhor = UTF8_SSE2;
+        if (impl_suportada(UTF8_AVX2)) melhor = UTF8_AVX2;
+        atual = (int)melhor + 1;
+        impl_utf8 = atual;
+    }
+    return (ImplUtf8)(atual - 1);
+}
+
+/**
+ * Forca uma implementacao de utf8_contar() (benchmarks e testes).
+ *
+ * @param impl Implementacao desejada
+ * @return 1 se selecionada, 0 se o processador nao a suporta
+ */
+int utf8_usar_impl(ImplUtf8 impl) {
+    if (!impl_suportada(impl)) return 0;
+    impl_utf8 = (int)impl + 1;
     return 1;
 }
 
 /**
- * Calcula a largura visual de uma string UTF-8.
+ * @param impl Implementacao
+ * @return Nome da implementacao para relatorios
+ */
+const char* utf8_nome_impl(ImplUtf8 impl) {
+    switch (impl) {
+        case UTF8_ESCALAR: return "escalar";
+        case UTF8_SSE2:    return "sse2";
+        case UTF8_AVX2:    return "avx2";
+    }
+    return "?";
+}
+
+/**
+ * Conta os code points dos 'n' primeiros bytes de um texto UTF-8.
+ *
+ * @param s Texto UTF-8 (nao precisa terminar em '\0')
+ * @param n Numero de bytes
+ * @return Numero de code points
+ */
+size_t utf8_contar(const char *s, size_t n) {
+    const unsigned char *p = (const unsigned char*)s;
+    // Abaixo de 16 bytes nenhum bloco vetorial cabe
+    if (n < 16) return utf8_contar_escalar(p, n);
+
+    switch (utf8_impl_atual()) {
+#ifdef UTF8_X86
+        case UTF8_AVX2: return utf8_contar_avx2(p, n);
+        case UTF8_SSE2: return utf8_contar_sse2(p, n);
+#endif
+        default:        return utf8_contar_escalar(p, n);
+    }
+}
+
+/**
+ * Conta os code points de uma string UTF-8.
  * 
  * Conta o numero de code points (caracteres) na string, tratando
  * corretamente sequencias multi-byte UTF-8.
@@ -302,121 +515,242 @@ static int utf8_cp_bytes(const unsigned char *p) {
  * - "São Paulo" -> 9 code points (10 bytes: 'ã' usa 2 bytes)
  * - "日本" -> 2 code points (6 bytes: cada kanji usa 3 bytes)
  * 
- * IMPORTANTE: Conta code points, nao bytes. Um caractere pode
- * ocupar multiplos bytes em UTF-8.
- * 
- * Limitacao: Nao lida com caracteres combinados (combining characters)
- * ou modificadores de emoji.
+ * IMPORTANTE: Conta code points, nao bytes nem colunas. Para a largura
+ * na tela (acentos combinantes, ideogramas e emojis), use utf8_largura().
  * 
  * @param s String UTF-8 a ser medida
- * @return Numero de code points (largura visual) da string
+ * @return Numero de code points da string
  */
 int utf8_len(const char *s) {
     // Valida o ponteiro
     if (!s) return 0;
     
-    int count = 0;  // Contador de code points
+    // strlen ja e vetorizada pela libc; a contagem percorre o mesmo intervalo
+    return (int)utf8_contar(s, strlen(s));
+}
+
+/**
+ * Largura de exibicao de um code point fora do ASCII (0, 1 ou 2), pelas
+ * tabelas de dois niveis geradas no build (larguras_tabela.h).
+ * 
+ * @param cp Code point (< 0x110000)
+ * @return Colunas ocupadas no terminal
+ */
+static int largura_cp(unsigned long cp) {
+    const unsigned char *bloco = LARGURAS_NIVEL2[LARGURAS_NIVEL1[cp >> 8]];
+    return (bloco[(cp & 0xFF) >> 2] >> ((cp & 3) * 2)) & 3;
+}
+
+/**
+ * Largura de exibicao de um caractere nao ASCII: o byte inicial 'p[0]'
+ * seguido dos seus 'n - 1' bytes de continuacao.
+ * 
+ * Sequencias invalidas (tamanho errado, byte inicial impossivel, fora do
+ * Unicode) aparecem como um caractere de substituicao: largura 1. Um byte
+ * de continuacao solto nao ocupa coluna (como em utf8_len).
+ * 
+ * @param p Primeiro byte do caractere
+ * @param n Bytes do caractere (1 a n)
+ * @return Colunas ocupadas no terminal
+ */
+static int largura_caractere(const unsigned char *p, int n) {
+    if (utf8_continuacao(p[0])) return 0;
+
+    int esperado;
+    unsigned long cp;
+    if (p[0] >= 0xC2 && p[0] <= 0xDF)      { esperado = 2; cp = p[0] & 0x1F; }
+    else if ((p[0] & 0xF0) == 0xE0)        { esperado = 3; cp = p[0] & 0x0F; }
+    else if (p[0] >= 0xF0 && p[0] <= 0xF4) { esperado = 4; cp = p[0] & 0x07; }
+    else return 1;
+    if (n != esperado) return 1;
+
+    for (int i = 1; i < n; i++) cp = (cp << 6) | (p[i] & 0x3F);
+    return cp < 0x110000 ? largura_cp(cp) : 1;
+}
+
+/**
+ * Calcula a largura de exibicao dos 'n' primeiros bytes de um texto UTF-8.
+ * 
+ * Trechos ASCII sao medidos 8 bytes por vez (1 coluna por byte); so os
+ * caracteres multi-byte consultam as tabelas.
+ * 
+ * @param s Texto UTF-8 (nao precisa terminar em '\0')
+ * @param n Numero de bytes
+ * @return Colunas ocupadas no terminal
+ */
+int utf8_largura_n(const char *s, size_t n) {
+    const unsigned char *p = (const unsigned char*)s;
+    size_t i = 0;
+    int largura = 0;
+
+    while (i < n) {
+        // Bloco de 8 bytes sem nenhum bit alto: 8 colunas
+        uint64_t bloco;
+        if (i + 8 <= n) {
+            memcpy(&bloco, p + i, 8);
+            if ((bloco & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                largura += 8;
+                continue;
+            }
+        }
+        if (p[i] < 0x80) {
+            i++;
+            largura++;
+            continue;
+        }
+
+        // Caractere multi-byte: byte inicial e seus bytes de continuacao
+        size_t k = 1;
+        while (i + k < n && utf8_continuacao(p[i + k])) k++;
+        largura += largura_caractere(p + i, (int)k);
+        i += k;
+    }
+    return largura;
+}
+
+/**
+ * Calcula a largura de exibicao de uma string UTF-8 (em colunas).
+ * 
+ * Exemplos:
+ * - "São Paulo" -> 9 colunas
+ * - "日本" -> 4 colunas (ideogramas ocupam duas)
+ * - "e\u0301" (e + acento agudo combinante) -> 1 coluna
+ * 
+ * Limitacao: sequencias de emoji unidas por ZWJ contam a soma das partes.
+ * 
+ * @param s String UTF-8 a ser medida
+ * @return Colunas ocupadas no terminal
+ */
+int utf8_largura(const char *s) {
+    if (!s) return 0;
+    return utf8_largura_n(s, strlen(s));
+}
+
+/**
+ * Mede o maior prefixo de uma string que cabe em uma largura.
+ * 
+ * Cada caractere vai do seu byte inicial ate o proximo byte que nao e
+ * de continuacao e nunca e cortado ao meio. Marcas combinantes (largura
+ * 0) logo apos o corte ficam no prefixo, junto do caractere que modificam.
+ * 
+ * @param s String UTF-8
+ * @param largura Largura maxima (colunas)
+ * @param max_bytes Numero maximo de bytes
+ * @param usada Recebe a largura do prefixo (pode ser menor que 'largura'
+ *              quando um caractere largo nao coube); pode ser NULL
+ * @return Bytes do prefixo
+ */
+int utf8_prefixo_bytes(const char *s, int largura, int max_bytes, int *usada) {
     const unsigned char *p = (const unsigned char*)s;
+    int bytes = 0;      // Bytes medidos ate agora
+    int colunas = 0;    // Largura medida ate agora
     
-    // Percorre a string ate o terminador nulo
-    while (*p) {
-        // Descobre quantos bytes tem o proximo code point
-        int n = utf8_cp_bytes(p);
+    while (p[bytes]) {
+        // O caractere vai ate o proximo byte que nao e de continuacao
+        // (o '\0' tambem encerra)
+        int n = 1;
+        while (utf8_continuacao(p[bytes + n])) n++;
+        int w = p[bytes] < 0x80 ? 1 : largura_caractere(p + bytes, n);
+        if (colunas + w > largura || bytes + n > max_bytes) break;
         
-        // Pula todos os bytes deste code point
-        p += n;
-        
-        // Incrementa o contador de caracteres
-        count++;
+        bytes += n;
+        colunas += w;
     }
-    
-    return count;
+    if (usada) *usada = colunas;
+    return bytes;
 }
 
 /**
- * Copia um numero especifico de code points UTF-8.
- * 
- * Funcao auxiliar que copia ate 'width' code points da string 's'
- * para o buffer 'dst', respeitando o limite de 'cap' bytes.
+ * Formata uma string UTF-8 ajustada para uma largura fixa em um buffer.
  * 
- * Diferente de strncpy, esta funcao:
- * - Copia code points completos (nao quebra no meio de um caractere multi-byte)
- * - Para ao atingir 'width' caracteres OU 'cap' bytes
- * - Adiciona terminador nulo se houver espaco
+ * Mesmo resultado de print_utf8_padded(), mas escrevendo em 'dst' em vez
+ * de stdout. Permite que escritores bufferizados reaproveitem a logica
+ * de alinhamento sem depender de putchar/fputs.
  * 
  * @param dst Buffer de destino
  * @param cap Capacidade do buffer em bytes
- * @param s String UTF-8 de origem
- * @param width Numero maximo de code points a copiar
- * @return Numero de bytes escritos no buffer (sem contar '\0')
+ * @param s String UTF-8 a ser ajustada
+ * @param width Largura visual desejada (em colunas)
+ * @return Numero de bytes escritos em dst (sem contar '\0')
  */
-static int utf8_copy_n_cps(char *dst, int cap, const char *s, int width) {
-    int bytes = 0;  // Bytes escritos ate agora
-    int cps = 0;    // Code points copiados ate agora
-    const unsigned char *p = (const unsigned char*)s;
+int utf8_ajustar(char *dst, int cap, const char *s, int width) {
+    // Trata NULL como string vazia
+    if (!s) s = "";
+    if (cap <= 0) return 0;
     
-    // Copia ate atingir width code points ou fim da string
-    while (*p && cps < width) {
-        // Descobre quantos bytes tem o proximo code point
-        int n = utf8_cp_bytes(p);
-        
-        // Verifica se ha espaco no buffer para este code point completo
-        if (bytes + n >= cap) break;
-        
-        // Copia todos os bytes deste code point
-        for (int i = 0; i < n; i++) {
-            dst[bytes++] = (char)p[i];
+    // Calcula a largura visual atual da string
+    size_t len = strlen(s);
+    int vis = utf8_largura_n(s, len);
+    int bytes;
+    
+    // Casos 1 e 2: cabe na coluna - copia e preenche com espacos
+    if (vis <= width) {
+        bytes = len > (size_t)(cap - 1) ? cap - 1 : (int)len;
+        memcpy(dst, s, (size_t)bytes);
+        for (int i = 0; i < width - vis && bytes < cap - 1; i++) {
+            dst[bytes++] = ' ';
         }
-        
-        p += n;
-        cps++;
+        dst[bytes] = '\0';
+        return bytes;
     }
     
-    // Adiciona terminador nulo se houver espaco
-    if (bytes < cap) {
-        dst[bytes] = '\0';
+    // Caso 3: String e mais longa - trunca e adiciona ellipsis
+    int keep = width - 1;
+    if (keep < 0) keep = 0;
+    int usada;
+    bytes = utf8_prefixo_bytes(s, keep, cap - 4, &usada);
+    memcpy(dst, s, (size_t)bytes);
+    
+    // Um caractere largo que nao coube deixa uma coluna livre antes do '…'
+    for (; usada < keep && bytes < cap - 4; usada++) {
+        dst[bytes++] = ' ';
     }
     
+    // Adiciona o caractere ellipsis '…' (U+2026), 0xE2 0x80 0xA6 em UTF-8
+    if (bytes + 3 < cap) {
+        dst[bytes++] = (char)0xE2;
+        dst[bytes++] = (char)0x80;
+        dst[bytes++] = (char)0xA6;
+    }
+    dst[bytes] = '\0';
     return bytes;
 }
 
 /**
  * Imprime uma string UTF-8 ajustada para uma largura fixa.
  * 
- * Garante que a saida ocupe exatamente 'width' code points (caracteres):
+ * Garante que a saida ocupe exatamente 'width' colunas do terminal:
  * - Se a string e mais curta: preenche com espacos a direita
  * - Se a string e mais longa: trunca e adiciona '…' (ellipsis U+2026)
  * - Se a string tem exatamente width: imprime como esta
  * 
  * Esta funcao e essencial para criar tabelas alinhadas com texto UTF-8,
- * pois garante que cada coluna tenha largura visual consistente.
+ * pois garante que cada coluna tenha largura visual consistente. A
+ * largura vem de utf8_largura(): acentos combinantes nao ocupam coluna e
+ * ideogramas e emojis ocupam duas.
  * 
  * Exemplos (width=10):
  * - "Fla"           -> "Fla       " (7 espacos adicionados)
  * - "Flamengo"      -> "Flamengo  " (2 espacos adicionados)
  * - "São Paulo"     -> "São Paulo " (1 espaco adicionado)
- * - "Internacional" -> "Internacio…" (truncado com ellipsis)
+ * - "Internacional" -> "Internaci…" (truncado com ellipsis)
+ * - "北京国安足球俱乐部" -> "北京国安 …" (o 5o ideograma nao cabe nas 9 colunas)
  * 
- * Nota: O ellipsis '…' (U+2026) ocupa 1 code point mas usa 3 bytes em UTF-8.
+ * Nota: O ellipsis '…' (U+2026) ocupa 1 coluna mas usa 3 bytes em UTF-8.
  * 
  * @param s String UTF-8 a ser impressa
- * @param width Largura visual desejada (em code points)
+ * @param width Largura visual desejada (em colunas)
  */
 void print_utf8_padded(const char *s, int width) {
     // Trata NULL como string vazia
     if (!s) s = "";
     
     // Calcula a largura visual atual da string
-    int vis = utf8_len(s);
-    
-    // Caso 1: String tem exatamente a largura desejada
-    if (vis == width) {
-        fputs(s, stdout);
-        return;
-    }
+    int vis = utf8_largura(s);
     
-    // Caso 2: String e mais curta - preenche com espacos
-    if (vis < width) {
+    // Casos 1 e 2: cabe na coluna - imprime e preenche com espacos
+    if (vis <= width) {
         fputs(s, stdout);
         for (int i = 0; i < width - vis; i++) {
             putchar(' ');
@@ -425,18 +759,109 @@ void print_utf8_padded(const char *s, int width) {
     }
     
     // Caso 3: String e mais longa - trunca e adiciona ellipsis
-    // Reserva 1 caractere para o ellipsis
-    int keep = width - 1;
-    if (keep < 0) keep = 0;
-    
-    // Copia apenas os primeiros 'keep' code points
     char buf[256];
-    utf8_copy_n_cps(buf, sizeof(buf), s, keep);
+    utf8_ajustar(buf, sizeof(buf), s, width);
     fputs(buf, stdout);
-    
-    // Adiciona o caractere ellipsis '…' (U+2026)
-    // Em UTF-8: 0xE2 0x80 0xA6
-    putchar((char)0xE2);
-    putchar((char)0x80);
-    putchar((char)0xA6);
+}
+
+// Letras de U+00C0 a U+00FF sem acento e em minuscula (demais ficam iguais)
+static const unsigned short DOBRA_LATIN1[64] = {
+    'a', 'a', 'a', 'a', 'a', 'a', 0xE6, 'c', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+    0xF0, 'n', 'o', 'o', 'o', 'o', 'o', 0xD7, 0xF8, 'u', 'u', 'u', 'u', 'y', 0xFE, 0xDF,
+    'a', 'a', 'a', 'a', 'a', 'a', 0xE6, 'c', 'e', 'e', 'e', 'e', 'i', 'i', 'i', 'i',
+    0xF0, 'n', 'o', 'o', 'o', 'o', 'o', 0xF7, 0xF8, 'u', 'u', 'u', 'u', 'y', 0xFE, 'y'
+};
+
+/**
+ * Decodifica uma string UTF-8 em code points "dobrados" para comparacao
+ * aproximada: ASCII em minuscula e letras latinas acentuadas (U+00C0 a
+ * U+00FF) trocadas pela letra base. Bytes invalidos viram U+FFFD.
+ * 
+ * @param s String UTF-8
+ * @param cps Destino dos code points
+ * @param max Capacidade de 'cps'
+ * @return Numero de code points gravados (no maximo 'max')
+ */
+int utf8_dobrar(const char *s, unsigned int *cps, int max) {
+    const unsigned char *p = (const unsigned char*)s;
+    int n = 0;
+
+    while (*p && n < max) {
+        // ASCII: apenas a minuscula
+        if (p[0] < 0x80) {
+            cps[n++] = p[0] >= 'A' && p[0] <= 'Z' ? p[0] + ('a' - 'A') : p[0];
+            p++;
+            continue;
+        }
+
+        unsigned int cp;
+        int tam;
+        if (p[0] >= 0xC2 && p[0] <= 0xDF) { cp = p[0] & 0x1Fu; tam = 2; }
+        else if ((p[0] & 0xF0) == 0xE0)        { cp = p[0] & 0x0Fu; tam = 3; }
+        else if (p[0] >= 0xF0 && p[0] <= 0xF4) { cp = p[0] & 0x07u; tam = 4; }
+        else                                   { cp = 0xFFFD; tam = 0; }
+
+        // Confere os bytes de continuacao
+        for (int i = 1; i < tam; i++) {
+            if (!utf8_continuacao(p[i])) {
+                tam = 0;
+                break;
+            }
+            cp = (cp << 6) | (p[i] & 0x3Fu);
+        }
+        if (tam == 0) {
+            cp = 0xFFFD;
+            tam = 1;
+        }
+
+        if (cp >= 0xC0 && cp <= 0xFF) cp = DOBRA_LATIN1[cp - 0xC0];
+        cps[n++] = cp;
+        p += tam;
+    }
+    return n;
+}
+
+/**
+ * Versao de utf8_dobrar() que devolve o texto dobrado em UTF-8.
+ * 
+ * @param s String UTF-8
+ * @param dst Destino (terminado em '\0')
+ * @param cap Capacidade de 'dst' em bytes (pelo menos 1)
+ * @return Bytes gravados (sem o '\0')
+ */
+int utf8_dobrar_str(const char *s, char *dst, int cap) {
+    unsigned int cps[256];
+    int n = utf8_dobrar(s, cps, 256);
+    int bytes = 0;
+
+    for (int i = 0; i < n; i++) {
+        unsigned int cp = cps[i];
+        unsigned char buf[4];
+        int tam;
+        if (cp < 0x80) {
+            buf[0] = (unsigned char)cp;
+            tam = 1;
+        } else if (cp < 0x800) {
+            buf[0] = (unsigned char)(0xC0 | (cp >> 6));
+            buf[1] = (unsigned char)(0x80 | (cp & 0x3F));
+            tam = 2;
+        } else if (cp < 0x10000) {
+            buf[0] = (unsigned char)(0xE0 | (cp >> 12));
+            buf[1] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+            buf[2] = (unsigned char)(0x80 | (cp & 0x3F));
+            tam = 3;
+        } else {
+            buf[0] = (unsigned char)(0xF0 | (cp >> 18));
+            buf[1] = (unsigned char)(0x80 | ((cp >> 12) & 0x3F));
+            buf[2] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+            buf[3] = (unsigned char)(0x80 | (cp & 0x3F));
+            tam = 4;
+        }
+        // Nao corta caracteres ao meio
+        if (bytes + tam > cap - 1) break;
+        memcpy(dst + bytes, buf, (size_t)tam);
+        bytes += tam;
+    }
+    dst[bytes] = '\0';
+    return bytes;
 }
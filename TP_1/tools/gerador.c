@@ -0,0 +1,362 @@
+/**
+ * Programa: gerador.c
+ *
+ * Gerador nativo de conjuntos de dados sinteticos para testes de carga.
+ *
+ * Escreve times.csv e partidas.csv nos mesmos formatos de data/ (e do
+ * app.py), mas sem dependencias externas e em escala: ate 10^6 times e
+ * 10^8 partidas. Toda a saida passa pelo Escritor, que grava em blocos
+ * grandes, de modo que a geracao fica limitada pela velocidade do disco.
+ *
+ * Opcoes:
+ * - --times <n>      numero de times (1 a 10^6, padrao 10)
+ * - --partidas <n>   numero de linhas de partidas (0 a 10^8, padrao 90)
+ * - --semente <s>    semente do gerador pseudoaleatorio (padrao 42)
+ * - --nome-min <n>   menor nome de time, em code points (padrao 4)
+ * - --nome-max <n>   maior nome de time, em code points (padrao 12)
+ * - --utf8 <pct>     porcentagem de caracteres nao-ASCII nos nomes (padrao 10)
+ * - --invalidas <pct> porcentagem de linhas de partida malformadas (padrao 0)
+ * - --dir <dir>      diretorio de saida (padrao ".")
+ *
+ * A mesma semente e as mesmas opcoes sempre geram os mesmos arquivos.
+ * Os nomes nunca passam de MAX_NOME_TIME - 1 bytes, para caber no campo
+ * do time; as linhas malformadas sao so de partidas (o CSV de times
+ * e sempre valido, para que os IDs referenciados existam).
+ *
+ * Uso:
+ *   bin/gerador [--times <n>] [--partidas <n>] [--semente <s>]
+ *               [--nome-min <n>] [--nome-max <n>] [--utf8 <pct>]
+ *               [--invalidas <pct>] [--dir <diretorio>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bd_times.h"
+#include "escritor.h"
+#include "utils.h"
+
+#define MAX_GERADOR_TIMES 1000000
+#define MAX_GERADOR_PARTIDAS 100000000
+
+/**
+ * Configuracao do gerador (linha de comando).
+ */
+typedef struct {
+    int n_times;                  // Numero de times
+    int n_partidas;               // Numero de linhas de partidas (validas + malformadas)
+    unsigned long long semente;   // Semente do gerador pseudoaleatorio
+    int nome_min;                 // Menor nome, em code points
+    int nome_max;                 // Maior nome, em code points
+    double pct_utf8;              // Porcentagem de caracteres nao-ASCII
+    double pct_invalidas;         // Porcentagem de linhas malformadas
+    const char *dir;              // Diretorio de saida
+} Config;
+
+// ========== Aleatoriedade ==========
+
+/**
+ * Gerador pseudoaleatorio xorshift64 (deterministico entre execucoes).
+ */
+static unsigned long long proximo_aleatorio(unsigned long long *estado) {
+    unsigned long long x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *estado = x;
+    return x;
+}
+
+/**
+ * Espalha os bits da semente (splitmix64), para que sementes proximas
+ * gerem sequencias diferentes e o estado nunca seja zero.
+ */
+static unsigned long long estado_inicial(unsigned long long semente) {
+    unsigned long long z = semente + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return z ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+/**
+ * Converte uma porcentagem em limiar sobre 2^32 (comparado com 32 bits
+ * aleatorios), evitando ponto flutuante no laco de geracao.
+ */
+static unsigned long long limiar_pct(double pct) {
+    return (unsigned long long)(pct / 100.0 * 4294967296.0);
+}
+
+// ========== Times ==========
+
+// Caracteres nao-ASCII usados nos nomes: latinos acentuados (2 bytes),
+// simbolos e ideogramas CJK (3 bytes) e emojis (4 bytes), nesta proporcao
+// aproximada: 70%, 20% e 10%.
+static const char *const LATINOS[] = {
+    "á", "é", "í", "ó", "ú", "ã", "õ", "ç", "ê", "â", "ñ", "ü"
+};
+static const char *const CJK[] = {
+    "東", "京", "大", "阪", "北", "海", "€", "★"
+};
+static const char *const EMOJIS[] = {
+    "⚽", "🏆", "🦁", "🐍", "🦅", "🐺"
+};
+
+#define QTD(v) ((int)(sizeof(v) / sizeof((v)[0])))
+
+/**
+ * Monta um nome de time aleatorio.
+ *
+ * O primeiro caractere e uma letra maiuscula ASCII (para que as buscas
+ * por prefixo tenham distribuicao previsivel); os demais sao letras
+ * minusculas ou, com probabilidade pct_utf8, um caractere multibyte.
+ *
+ * @param cfg Configuracao
+ * @param estado Estado do gerador
+ * @param nome Buffer de saida (MAX_NOME_TIME bytes)
+ * @return Numero de bytes escritos (sem o terminador)
+ */
+static int gerar_nome(const Config *cfg, unsigned long long *estado, char *nome) {
+    unsigned long long r = proximo_aleatorio(estado);
+    int faixa = cfg->nome_max - cfg->nome_min + 1;
+    int alvo = cfg->nome_min + (int)(r % (unsigned long long)faixa);
+    unsigned long long limiar = limiar_pct(cfg->pct_utf8);
+
+    int len = 0;
+    nome[len++] = (char)('A' + (r >> 32) % 26);
+    for (int i = 1; i < alvo; i++) {
+        r = proximo_aleatorio(estado);
+        const char *c = NULL;
+        if ((r & 0xFFFFFFFFULL) < limiar) {
+            unsigned int tipo = (unsigned int)((r >> 32) % 10);
+            unsigned int k = (unsigned int)(r >> 40);
+            if (tipo < 7)      c = LATINOS[k % QTD(LATINOS)];
+            else if (tipo < 9) c = CJK[k % QTD(CJK)];
+            else               c = EMOJIS[k % QTD(EMOJIS)];
+        }
+
+        if (c) {
+            size_t n = strlen(c);
+            if (len + (int)n > MAX_NOME_TIME - 1) break;
+            memcpy(nome + len, c, n);
+            len += (int)n;
+        } else {
+            if (len + 1 > MAX_NOME_TIME - 1) break;
+            nome[len++] = (char)('a' + (r >> 32) % 26);
+        }
+    }
+    nome[len] = '\0';
+    return len;
+}
+
+/**
+ * Escreve o CSV de times (IDs 0..n_times-1).
+ *
+ * @param cfg Configuracao
+ * @param caminho Arquivo a criar
+ * @return 1 se sucesso
+ */
+static int gerar_times(const Config *cfg, const char *caminho) {
+    Escritor *w = malloc(sizeof(Escritor));
+    if (!w || !escritor_abrir(w, caminho)) {
+        free(w);
+        return 0;
+    }
+    unsigned long long estado = estado_inicial(cfg->semente);
+    char nome[MAX_NOME_TIME];
+
+    escritor_str(w, "ID,Time\n");
+    for (int i = 0; i < cfg->n_times; i++) {
+        int n = gerar_nome(cfg, &estado, nome);
+        escritor_int(w, i);
+        escritor_char(w, ',');
+        escritor_bytes(w, nome, (size_t)n);
+        escritor_char(w, '\n');
+    }
+    int ok = escritor_fechar(w);
+    free(w);
+    return ok;
+}
+
+// ========== Partidas ==========
+
+/**
+ * Escreve uma linha de partida malformada, escolhendo entre os defeitos
+ * que o parser precisa rejeitar: campo faltando, campo nao numerico,
+ * numero fora do intervalo de int, linha vazia e lixo sem separadores.
+ *
+ * @param w Escritor
+ * @param id ID que a partida teria
+ * @param r Bits aleatorios
+ */
+static void escrever_malformada(Escritor *w, int id, unsigned long long r) {
+    switch ((r >> 32) % 5) {
+        case 0:  // Apenas 4 campos
+            escritor_int(w, id);
+            escritor_str(w, ",0,1,2\n");
+            break;
+        case 1:  // Campo nao numerico
+            escritor_int(w, id);
+            escritor_str(w, ",abc,1,2,0\n");
+            break;
+        case 2:  // Gols fora do intervalo de int
+            escritor_int(w, id);
+            escritor_str(w, ",0,1,99999999999,0\n");
+            break;
+        case 3:  // Linha vazia
+            escritor_char(w, '\n');
+            break;
+        default: // Lixo
+            escritor_str(w, "#@!?\n");
+            break;
+    }
+}
+
+/**
+ * Escreve o CSV de partidas com confrontos e placares aleatorios.
+ *
+ * Cada linha e malformada com probabilidade pct_invalidas; as demais sao
+ * partidas validas entre dois times distintos com placares de 0 a 5.
+ *
+ * @param cfg Configuracao
+ * @param caminho Arquivo a criar
+ * @param invalidas Onde o numero de linhas malformadas sera armazenado
+ * @return 1 se sucesso
+ */
+static int gerar_partidas(const Config *cfg, const char *caminho, int *invalidas) {
+    Escritor *w = malloc(sizeof(Escritor));
+    if (!w || !escritor_abrir(w, caminho)) {
+        free(w);
+        return 0;
+    }
+    // Sequencia independente da dos nomes, para que mudar --nome-* ou --utf8
+    // nao altere as partidas
+    unsigned long long estado = estado_inicial(cfg->semente ^ 0xD1B54A32D192ED03ULL);
+    unsigned long long limiar = limiar_pct(cfg->pct_invalidas);
+    unsigned long long n_times = (unsigned long long)cfg->n_times;
+    *invalidas = 0;
+
+    escritor_str(w, "ID,Time1ID,Time2ID,GolsTime1,GolsTime2\n");
+    for (int i = 0; i < cfg->n_partidas; i++) {
+        unsigned long long r = proximo_aleatorio(&estado);
+        if ((r & 0xFFFFFFFFULL) < limiar) {
+            escrever_malformada(w, i, r);
+            (*invalidas)++;
+            continue;
+        }
+
+        int t1 = (int)(proximo_aleatorio(&estado) % n_times);
+        int t2 = (int)(proximo_aleatorio(&estado) % (n_times - 1));
+        if (t2 >= t1) t2++;  // Mandante e visitante diferentes
+
+        escritor_int(w, i);
+        escritor_char(w, ',');
+        escritor_int(w, t1);
+        escritor_char(w, ',');
+        escritor_int(w, t2);
+        escritor_char(w, ',');
+        escritor_char(w, (char)('0' + (r >> 32) % 6));
+        escritor_char(w, ',');
+        escritor_char(w, (char)('0' + (r >> 40) % 6));
+        escritor_char(w, '\n');
+    }
+    int ok = escritor_fechar(w);
+    free(w);
+    return ok;
+}
+
+// ========== Linha de comando ==========
+
+/**
+ * Le um inteiro de opcao da linha de comando, dentro de [minimo, maximo].
+ */
+static int ler_opcao_int(int argc, char *argv[], int *i, int minimo, int maximo, int *out) {
+    if (*i + 1 >= argc || !safe_atoi(argv[*i + 1], out) || *out < minimo || *out > maximo) {
+        fprintf(stderr, "Valor invalido para %s (esperado %d a %d)\n", argv[*i], minimo, maximo);
+        return 0;
+    }
+    (*i)++;
+    return 1;
+}
+
+/**
+ * Le uma porcentagem (0 a 100, aceita casas decimais) da linha de comando.
+ */
+static int ler_opcao_pct(int argc, char *argv[], int *i, double *out) {
+    char *fim;
+    if (*i + 1 >= argc) return 0;
+    double v = strtod(argv[*i + 1], &fim);
+    if (fim == argv[*i + 1] || *fim != '\0' || !(v >= 0.0 && v <= 100.0)) {
+        fprintf(stderr, "Valor invalido para %s (esperado 0 a 100)\n", argv[*i]);
+        return 0;
+    }
+    *out = v;
+    (*i)++;
+    return 1;
+}
+
+/**
+ * Le a semente (inteiro sem sinal de 64 bits) da linha de comando.
+ */
+static int ler_opcao_semente(int argc, char *argv[], int *i, unsigned long long *out) {
+    char *fim;
+    if (*i + 1 >= argc) return 0;
+    *out = strtoull(argv[*i + 1], &fim, 10);
+    if (fim == argv[*i + 1] || *fim != '\0') {
+        fprintf(stderr, "Valor invalido para %s\n", argv[*i]);
+        return 0;
+    }
+    (*i)++;
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    Config cfg = { 10, 90, 42, 4, 12, 10.0, 0.0, "." };
+
+    for (int i = 1; i < argc; i++) {
+        int ok = 1;
+        if (strcmp(argv[i], "--times") == 0)           ok = ler_opcao_int(argc, argv, &i, 1, MAX_GERADOR_TIMES, &cfg.n_times);
+        else if (strcmp(argv[i], "--partidas") == 0)   ok = ler_opcao_int(argc, argv, &i, 0, MAX_GERADOR_PARTIDAS, &cfg.n_partidas);
+        else if (strcmp(argv[i], "--semente") == 0)    ok = ler_opcao_semente(argc, argv, &i, &cfg.semente);
+        else if (strcmp(argv[i], "--nome-min") == 0)   ok = ler_opcao_int(argc, argv, &i, 1, MAX_NOME_TIME - 1, &cfg.nome_min);
+        else if (strcmp(argv[i], "--nome-max") == 0)   ok = ler_opcao_int(argc, argv, &i, 1, MAX_NOME_TIME - 1, &cfg.nome_max);
+        else if (strcmp(argv[i], "--utf8") == 0)       ok = ler_opcao_pct(argc, argv, &i, &cfg.pct_utf8);
+        else if (strcmp(argv[i], "--invalidas") == 0)  ok = ler_opcao_pct(argc, argv, &i, &cfg.pct_invalidas);
+        else if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) cfg.dir = argv[++i];
+        else ok = 0;
+
+        if (!ok) {
+            fprintf(stderr, "Uso: %s [--times <n>] [--partidas <n>] [--semente <s>] "
+                            "[--nome-min <n>] [--nome-max <n>] [--utf8 <pct>] "
+                            "[--invalidas <pct>] [--dir <diretorio>]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.nome_max < cfg.nome_min) {
+        fprintf(stderr, "--nome-max deve ser maior ou igual a --nome-min\n");
+        return 1;
+    }
+    if (cfg.n_partidas > 0 && cfg.n_times < 2) {
+        fprintf(stderr, "Sao necessarios pelo menos 2 times para gerar partidas\n");
+        return 1;
+    }
+
+    char caminho_times[512];
+    char caminho_partidas[512];
+    snprintf(caminho_times, sizeof(caminho_times), "%s/times.csv", cfg.dir);
+    snprintf(caminho_partidas, sizeof(caminho_partidas), "%s/partidas.csv", cfg.dir);
+
+    if (!gerar_times(&cfg, caminho_times)) {
+        fprintf(stderr, "Erro ao gravar %s\n", caminho_times);
+        return 1;
+    }
+    int invalidas = 0;
+    if (!gerar_partidas(&cfg, caminho_partidas, &invalidas)) {
+        fprintf(stderr, "Erro ao gravar %s\n", caminho_partidas);
+        return 1;
+    }
+
+    fprintf(stderr, "Gerados %d times em %s e %d partidas (%d malformadas) em %s\n",
+            cfg.n_times, caminho_times, cfg.n_partidas, invalidas, caminho_partidas);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * Programa: gerar_larguras.c
+ *
+ * Gera, durante o build, as tabelas de largura de exibicao usadas por
+ * utf8_largura() (utils.c) a partir de tools/larguras_unicode.txt.
+ *
+ * As tabelas tem dois niveis:
+ * - Nivel 1: para cada bloco de 256 code points (cp >> 8), o indice de um
+ *   bloco do nivel 2
+ * - Nivel 2: blocos distintos de 256 larguras de 2 bits (64 bytes cada)
+ *
+ * Como quase todos os blocos sao iguais (tudo largura 1, ou tudo largura
+ * 2 nos ideogramas), sobram pouco mais de cem blocos distintos e as
+ * tabelas ocupam cerca de 12 KiB. Uma consulta custa duas leituras de tabela,
+ * um deslocamento e uma mascara.
+ *
+ * Uso:
+ *   gerar_larguras <larguras_unicode.txt> <saida.h>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_CP 0x110000
+#define TAM_BLOCO 256
+#define NUM_BLOCOS (MAX_CP / TAM_BLOCO)
+#define BYTES_BLOCO (TAM_BLOCO / 4)
+
+/**
+ * Le o arquivo de faixas e preenche a largura de cada code point.
+ *
+ * @param caminho Arquivo de faixas
+ * @param largura Array de MAX_CP larguras (ja preenchido com 1)
+ * @return 1 se sucesso, 0 se o arquivo nao abriu ou tem linha invalida
+ */
+static int ler_faixas(const char *caminho, unsigned char *largura) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        fprintf(stderr, "Erro ao abrir %s\n", caminho);
+        return 0;
+    }
+
+    char linha[128];
+    int num = 0;
+    long anterior = -1;
+    while (fgets(linha, sizeof(linha), f)) {
+        num++;
+        if (linha[0] == '#' || linha[0] == '\n' || linha[0] == '\r') continue;
+
+        unsigned long ini, fim;
+        int w;
+        if (sscanf(linha, "%lx..%lx %d", &ini, &fim, &w) != 3 ||
+            fim < ini || fim >= MAX_CP || (long)ini <= anterior || (w != 0 && w != 2)) {
+            fprintf(stderr, "%s:%d: faixa invalida: %s", caminho, num, linha);
+            fclose(f);
+            return 0;
+        }
+        for (unsigned long cp = ini; cp <= fim; cp++) largura[cp] = (unsigned char)w;
+        anterior = (long)fim;
+    }
+    fclose(f);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Uso: %s <larguras_unicode.txt> <saida.h>\n", argv[0]);
+        return 1;
+    }
+
+    unsigned char *largura = malloc(MAX_CP);
+    static unsigned char blocos[NUM_BLOCOS][BYTES_BLOCO];   // Blocos distintos
+    static unsigned short nivel1[NUM_BLOCOS];
+    if (!largura) return 1;
+    memset(largura, 1, MAX_CP);
+    if (!ler_faixas(argv[1], largura)) return 1;
+
+    // Empacota cada bloco (2 bits por code point) e reaproveita blocos iguais
+    int distintos = 0;
+    for (int b = 0; b < NUM_BLOCOS; b++) {
+        unsigned char bloco[BYTES_BLOCO] = { 0 };
+        for (int i = 0; i < TAM_BLOCO; i++) {
+            bloco[i / 4] |= (unsigned char)(largura[b * TAM_BLOCO + i] << ((i % 4) * 2));
+        }
+        int k = 0;
+        while (k < distintos && memcmp(blocos[k], bloco, BYTES_BLOCO) != 0) k++;
+        if (k == distintos) memcpy(blocos[distintos++], bloco, BYTES_BLOCO);
+        nivel1[b] = (unsigned short)k;
+    }
+    free(largura);
+    if (distintos > 256) {
+        fprintf(stderr, "Blocos distintos demais para indices de 1 byte: %d\n", distintos);
+        return 1;
+    }
+
+    FILE *out = fopen(argv[2], "w");
+    if (!out) {
+        fprintf(stderr, "Erro ao criar %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(out, "// Gerado por tools/gerar_larguras.c a partir de %s. Nao editar.\n\n", argv[1]);
+    fprintf(out, "#define LARGURAS_BLOCOS %d\n\n", distintos);
+
+    fprintf(out, "static const unsigned char LARGURAS_NIVEL1[%d] = {", NUM_BLOCOS);
+    for (int b = 0; b < NUM_BLOCOS; b++) {
+        fprintf(out, "%s%d,", b % 32 ? "" : "\n    ", nivel1[b]);
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "static const unsigned char LARGURAS_NIVEL2[%d][%d] = {\n", distintos, BYTES_BLOCO);
+    for (int k = 0; k < distintos; k++) {
+        fprintf(out, "    {");
+        for (int i = 0; i < BYTES_BLOCO; i++) {
+            fprintf(out, "%s0x%02x,", i % 16 ? "" : "\n        ", blocos[k][i]);
+        }
+        fprintf(out, "\n    },\n");
+    }
+    fprintf(out, "};\n");
+
+    if (fclose(out) != 0) {
+        fprintf(stderr, "Erro ao gravar %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}